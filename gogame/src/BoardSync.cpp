@@ -0,0 +1,41 @@
+#include "BoardSync.h"
+
+void syncStones(const std::vector<logic::Stone>& board, int dimX, int dimY, render::StoneGrid& stones)
+{
+	for (int y = 0; y < dimY; ++y)
+	{
+		for (int x = 0; x < dimX; ++x)
+		{
+			const auto stone = board[x + y * dimX];
+			if (stone == logic::Stone::NONE)
+				stones.removeStone(x, y);
+			else
+				stones.setStone(x, y, (stone == logic::Stone::BLACK) ? render::Player::Black : render::Player::White);
+		}
+	}
+}
+
+void applyBoardDelta(const logic::BoardDelta& delta, render::StoneGrid& stones)
+{
+	if (delta.type == logic::BoardDelta::Type::RESET)
+	{
+		stones.clear();
+		return;
+	}
+
+	const auto placedColor = (delta.placedStone == logic::Stone::BLACK) ? render::Player::Black : render::Player::White;
+	const auto capturedColor = (delta.placedStone == logic::Stone::BLACK) ? render::Player::White : render::Player::Black;
+
+	if (delta.type == logic::BoardDelta::Type::UNDO)
+	{
+		stones.removeStone(delta.placed.x, delta.placed.y);
+		for (const auto& pos : delta.captured)
+			stones.setStone(pos.x, pos.y, capturedColor);
+	}
+	else if (delta.type == logic::BoardDelta::Type::MOVE)
+	{
+		for (const auto& pos : delta.captured)
+			stones.removeStone(pos.x, pos.y);
+		stones.setStone(delta.placed.x, delta.placed.y, placedColor);
+	}
+}
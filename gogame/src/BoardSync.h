@@ -0,0 +1,11 @@
+#pragma once
+#include <vector>
+
+#include "logic/BoardDelta.h"
+#include "render/StoneGrid.h"
+
+// Copies the whole board into the stones, only the cells which differ are touched
+void syncStones(const std::vector<logic::Stone>& board, int dimX, int dimY, render::StoneGrid& stones);
+
+// Applies what a move, an undo or a new game changed : only the intersections of the delta are touched
+void applyBoardDelta(const logic::BoardDelta& delta, render::StoneGrid& stones);
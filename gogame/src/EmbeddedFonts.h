@@ -0,0 +1,34 @@
+#pragma once
+
+// Fonts compiled into the executable by gogame_fontbake (see gogame/CMakeLists.txt). Each font comes with the
+// printable ASCII glyphs already rasterized as distance fields, ready to be added to the nanovg atlas.
+
+namespace fonts
+{
+	struct EmbeddedGlyph
+	{
+		unsigned int codepoint;
+		// Size and advance in tenth of pixels, as fontstash stores them
+		short size10;
+		short width;
+		short height;
+		short xadv10;
+		short xoff;
+		short yoff;
+		// First pixel of the glyph in EmbeddedFont::pixels, rows of 'width' bytes
+		unsigned int pixelOffset;
+	};
+
+	struct EmbeddedFont
+	{
+		const char* name;
+		const unsigned char* data;
+		unsigned int dataSize;
+		const EmbeddedGlyph* glyphs;
+		unsigned int nbGlyphs;
+		const unsigned char* pixels;
+	};
+
+	extern const EmbeddedFont embeddedFonts[];
+	extern const unsigned int nbEmbeddedFonts;
+}
@@ -0,0 +1,363 @@
+#include "FrameLoop.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include <nanovg.h>
+// Declarations only, the implementation is in main.cpp
+#define NANOVG_GL3
+#include <nanovg_gl.h>
+
+#include "render/DebugOverlay.h"
+#include "render/utilities.h"
+
+namespace
+{
+	// Without event, the loop still wakes up at this interval
+	constexpr double idleWakeupInterval = 1.0;
+
+	struct RedrawState
+	{
+		bool isDirty = true;
+		unsigned long long int nbFrames = 0;
+		unsigned long long int nbWakeups = 0;
+	};
+
+	// Input-to-present latency : from the first input a frame shows to the return of its present. The scene tells
+	// which input its changes show : the input of a game command is only shown once its snapshot arrives
+	struct LatencyState
+	{
+		// Earliest input shown by the next frame. In glfw time, -1 if none
+		double frameInputTime = -1.0;
+
+		double last = 0.0;
+		double max = 0.0;
+		double total = 0.0;
+		unsigned long long int nbSamples = 0;
+
+		void onShow(double inputTime)
+		{
+			if (inputTime >= 0.0 && (frameInputTime < 0.0 || inputTime < frameInputTime))
+				frameInputTime = inputTime;
+		}
+
+		void onPresent(double presentTime)
+		{
+			if (frameInputTime < 0.0)
+				return;
+			last = presentTime - frameInputTime;
+			max = std::max(max, last);
+			total += last;
+			nbSamples++;
+			frameInputTime = -1.0;
+		}
+	};
+
+	// The layout of the window is only computed by the size callbacks, and when the board size changes. The loop
+	// reads it, and hands a new one to the scene when 'hasChanged' is set
+	struct LayoutState
+	{
+		int boardWidth = 9;
+		int boardHeight = 9;
+		render::Layout layout;
+		bool hasChanged = true;
+	};
+
+	RedrawState redraw;
+	LatencyState latency;
+	LayoutState layoutState;
+	FrameInput input;
+	bool showLatency = false;
+	bool showProfiler = false;
+
+	void onInput()
+	{
+		if (input.inputTime < 0.0)
+			input.inputTime = glfwGetTime();
+	}
+
+	void updateLayout(GLFWwindow* window)
+	{
+		// Each callback only gives one of the two sizes
+		int winWidth, winHeight;
+		int fbWidth, fbHeight;
+		glfwGetWindowSize(window, &winWidth, &winHeight);
+		glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+
+		layoutState.layout = render::Layout(winWidth, winHeight, fbWidth, fbHeight, layoutState.boardWidth, layoutState.boardHeight);
+		layoutState.hasChanged = true;
+		redraw.isDirty = true;
+	}
+
+	void mouse_button_callback(GLFWwindow*, int button, int action, int /*mods*/)
+	{
+		onInput();
+		if (button != GLFW_MOUSE_BUTTON_LEFT)
+			return;
+		input.isButtonDown = (action == GLFW_PRESS);
+		if (action == GLFW_PRESS)
+			input.game.addStone = true;
+	}
+
+	void cursor_position_callback(GLFWwindow*, double x, double y)
+	{
+		onInput();
+		input.cursorX = x;
+		input.cursorY = y;
+	}
+
+	void window_size_callback(GLFWwindow* window, int /*width*/, int /*height*/)
+	{
+		updateLayout(window);
+	}
+
+	void window_refresh_callback(GLFWwindow*)
+	{
+		redraw.isDirty = true;
+	}
+
+	void key_callback(GLFWwindow*, int key, int /*scancode*/, int action, int /*mods*/)
+	{
+		onInput();
+		auto& events = input.game;
+		if (key == GLFW_KEY_SPACE && action == GLFW_PRESS)
+			events.pass = true;
+		else if (key == GLFW_KEY_N && action == GLFW_PRESS)
+			events.newGame = true;
+		else if (key == GLFW_KEY_U && action == GLFW_PRESS)
+			events.undo = true;
+		else if (key == GLFW_KEY_R && action == GLFW_PRESS)
+			events.redo = true;
+		else if (key == GLFW_KEY_I && action == GLFW_PRESS)
+			events.toggleIllegalPoints = true;
+		else if (key == GLFW_KEY_L && action == GLFW_PRESS)
+		{
+			// Debug overlay, not a scene event
+			showLatency = !showLatency;
+			redraw.isDirty = true;
+		}
+		else if (key == GLFW_KEY_P && action == GLFW_PRESS)
+		{
+			showProfiler = !showProfiler;
+			redraw.isDirty = true;
+		}
+		else if (action == GLFW_PRESS || action == GLFW_REPEAT)
+		{
+			auto& replay = input.replay;
+			if (key == GLFW_KEY_RIGHT)
+				replay.moveStep++;
+			else if (key == GLFW_KEY_LEFT)
+				replay.moveStep--;
+			else if (key == GLFW_KEY_PAGE_DOWN)
+				replay.moveStep += 10;
+			else if (key == GLFW_KEY_PAGE_UP)
+				replay.moveStep -= 10;
+			else if (key == GLFW_KEY_HOME)
+				replay.toStart = true;
+			else if (key == GLFW_KEY_END)
+				replay.toEnd = true;
+			else if (key == GLFW_KEY_DOWN)
+				replay.gameStep++;
+			else if (key == GLFW_KEY_UP)
+				replay.gameStep--;
+		}
+	}
+
+	void setCallbacks(GLFWwindow* window, bool isInstalled)
+	{
+		glfwSetMouseButtonCallback(window, isInstalled ? mouse_button_callback : nullptr);
+		glfwSetCursorPosCallback(window, isInstalled ? cursor_position_callback : nullptr);
+		glfwSetKeyCallback(window, isInstalled ? key_callback : nullptr);
+		glfwSetWindowSizeCallback(window, isInstalled ? window_size_callback : nullptr);
+		glfwSetFramebufferSizeCallback(window, isInstalled ? window_size_callback : nullptr);
+		glfwSetWindowRefreshCallback(window, isInstalled ? window_refresh_callback : nullptr);
+	}
+
+	std::vector<std::string> latencyOverlayLines(const FrameLoopOptions& options)
+	{
+		auto ms = [](double seconds) { return std::to_string(int(std::lround(seconds * 1000.0))); };
+		const auto average = latency.nbSamples > 0 ? latency.total / double(latency.nbSamples) : 0.0;
+
+		return {
+			latency.nbSamples > 0
+				? "Input to present: " + ms(latency.last) + " ms (avg " + ms(average) + ", max " + ms(latency.max) + ")"
+				: "Input to present: no input shown yet",
+			"Swap interval " + std::to_string(options.swapInterval)
+				+ (options.maxFps > 0.0 ? ", max " + std::to_string(int(options.maxFps)) + " fps" : "")
+				+ (options.finishAfterSwap ? ", finish after swap" : "")
+		};
+	}
+
+	void printStatistics(NVGcontext& vg, const render::FrameProfiler& profiler, double elapsedSeconds)
+	{
+		std::cout << redraw.nbFrames << " frames rendered and " << redraw.nbWakeups << " wakeups in " << elapsedSeconds << " s" << std::endl;
+
+		// Run again with --no-persistent-buffers to see what the persistent mapping saves
+		NVGuploadStatsGL uploadStats;
+		nvglUploadStatsGL3(&vg, &uploadStats);
+		if (redraw.nbFrames > 0 && uploadStats.nflushes > 0)
+		{
+			std::cout << "nanovg flush: " << profiler.averageCpuMs(render::FrameProfiler::Stage::Flush) * 1000.0 << " us/frame, "
+				<< (uploadStats.persistent ? "persistent mapped" : "orphaned") << " buffers, "
+				<< uploadStats.bytes / uploadStats.nflushes << " bytes/flush, "
+				<< uploadStats.nstalls << " stalls, " << uploadStats.nreallocs << " reallocations" << std::endl;
+		}
+		if (latency.nbSamples > 0)
+		{
+			std::cout << "Input to present: " << latency.total * 1000.0 / double(latency.nbSamples) << " ms on average, "
+				<< latency.max * 1000.0 << " ms max over " << latency.nbSamples << " frames" << std::endl;
+		}
+	}
+}
+
+void runFrameLoop(GLFWwindow* window, NVGcontext& vg, const FrameLoopOptions& options, render::FrameProfiler& profiler, FrameScene& scene)
+{
+	redraw = RedrawState();
+	latency = LatencyState();
+	input = FrameInput();
+	showLatency = options.showLatency;
+	showProfiler = options.showProfiler;
+
+	setCallbacks(window, true);
+	const auto boardSize = scene.getBoardSize();
+	layoutState.boardWidth = boardSize.first;
+	layoutState.boardHeight = boardSize.second;
+	updateLayout(window);
+	const auto& layout = layoutState.layout;
+
+	const auto startTime = std::chrono::steady_clock::now();
+	const auto minFrameInterval = options.maxFps > 0.0 ? 1.0 / options.maxFps : 0.0;
+	auto nextFrameTime = glfwGetTime();
+
+	while (!glfwWindowShouldClose(window))
+	{
+		// Nothing to draw : we sleep until an event, or until the end of the pacing interval if a frame is waiting
+		if (!redraw.isDirty)
+			glfwWaitEventsTimeout(idleWakeupInterval);
+		else if (glfwGetTime() < nextFrameTime)
+			glfwWaitEventsTimeout(nextFrameTime - glfwGetTime());
+		else
+			glfwPollEvents();
+		redraw.nbWakeups++;
+
+		{
+			render::ScopedCpuTimer timer(profiler, render::FrameProfiler::Stage::Events);
+
+			// The events may have resized the window, and the update may have changed the board size (another game of a
+			// replay) : the scene works with the layout of both
+			auto syncLayout = [&] {
+				const auto size = scene.getBoardSize();
+				if (size.first != layoutState.boardWidth || size.second != layoutState.boardHeight)
+				{
+					layoutState.boardWidth = size.first;
+					layoutState.boardHeight = size.second;
+					updateLayout(window);
+				}
+				if (layoutState.hasChanged)
+				{
+					scene.setLayout(layout);
+					layoutState.hasChanged = false;
+				}
+			};
+
+			syncLayout();
+			const auto update = scene.update(input, layout);
+			syncLayout();
+			if (update.hasChanged)
+			{
+				redraw.isDirty = true;
+				// Only the input which changed something is measured, the rest is dropped
+				latency.onShow(update.inputTime);
+			}
+			input.game.reset();
+			input.replay.reset();
+			input.inputTime = -1.0;
+		}
+
+		// A minimized window has no size, there's nothing to draw
+		if (!redraw.isDirty || layout.isEmpty() || glfwGetTime() < nextFrameTime)
+			continue;
+
+		redraw.isDirty = false;
+		redraw.nbFrames++;
+		nextFrameTime = glfwGetTime() + minFrameInterval;
+
+		const auto pxRatio = layout.pxRatio();
+
+		profiler.beginFrame();
+
+		// Offscreen parts first, they change the bound framebuffer and the viewport
+		{
+			render::ScopedCpuTimer timer(profiler, render::FrameProfiler::Stage::Prepare);
+			profiler.beginGpu(render::FrameProfiler::Stage::Prepare);
+			scene.prepare(pxRatio);
+			profiler.endGpu();
+		}
+
+		glViewport(0, 0, layout.fbWidth(), layout.fbHeight());
+		const auto background = render::backgroundColor();
+		glClearColor(background.r, background.g, background.b, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+
+		{
+			render::ScopedCpuTimer timer(profiler, render::FrameProfiler::Stage::Draw);
+			nvgBeginFrame(&vg, layout.winWidth(), layout.winHeight(), pxRatio);
+			scene.draw(layout);
+		}
+		{
+			render::ScopedCpuTimer timer(profiler, render::FrameProfiler::Stage::Flush);
+			profiler.beginGpu(render::FrameProfiler::Stage::Flush);
+			nvgEndFrame(&vg);
+		}
+		{
+			render::ScopedCpuTimer timer(profiler, render::FrameProfiler::Stage::Stones);
+			profiler.beginGpu(render::FrameProfiler::Stage::Stones);
+			scene.drawAfterFlush(layout);
+		}
+
+		// Over the stones of the layer. They show the measures of the previous frames, this one isn't presented yet
+		if (showLatency || showProfiler)
+		{
+			render::ScopedCpuTimer timer(profiler, render::FrameProfiler::Stage::Overlay);
+			profiler.beginGpu(render::FrameProfiler::Stage::Overlay);
+			nvgBeginFrame(&vg, layout.winWidth(), layout.winHeight(), pxRatio);
+			if (showLatency)
+				render::drawDebugOverlay(vg, latencyOverlayLines(options), float(layout.winHeight()));
+			if (showProfiler)
+			{
+				const auto origin = scene.getOverlayOrigin(layout);
+				profiler.draw(vg, origin.first, origin.second);
+			}
+			nvgEndFrame(&vg);
+		}
+		profiler.endGpu();
+
+		{
+			render::ScopedCpuTimer timer(profiler, render::FrameProfiler::Stage::Swap);
+			glfwSwapBuffers(window);
+			if (options.finishAfterSwap)
+				glFinish();
+		}
+		latency.onPresent(glfwGetTime());
+		profiler.endFrame();
+
+		// The frame counter lets us check that an idle scene doesn't draw anything
+		glfwSetWindowTitle(window, (scene.getTitle() + " - frame " + std::to_string(redraw.nbFrames)).c_str());
+
+		// From main, the time of the loader and of the static initializers before it isn't counted
+		if (redraw.nbFrames == 1 && options.mainStart != std::chrono::steady_clock::time_point())
+		{
+			auto startupTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - options.mainStart).count();
+			std::cout << "First frame presented " << startupTime << " ms after the start of main" << std::endl;
+		}
+	}
+
+	setCallbacks(window, false);
+	printStatistics(vg, profiler, std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count());
+}
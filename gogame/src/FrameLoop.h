@@ -0,0 +1,113 @@
+#pragma once
+#include <chrono>
+#include <string>
+#include <utility>
+
+#include "render/FrameProfiler.h"
+#include "render/Layout.h"
+
+struct GLFWwindow;
+struct NVGcontext;
+
+struct FrameLoopOptions
+{
+	// 1 presents at the vertical blank, 0 as soon as the frame is drawn (tearing possible)
+	int swapInterval = 1;
+	// When > 0, frames are drawn at most at this rate, the input received in between goes in the next one
+	double maxFps = 0.0;
+	// Waits for the GPU after each present, so the driver can't queue frames ahead of the display
+	bool finishAfterSwap = false;
+	// Initial state of the overlays, [L] and [P] toggle them
+	bool showLatency = false;
+	bool showProfiler = false;
+	// Taken by the first statement of main : the first presented frame is timed from it. Not printed when left empty
+	std::chrono::steady_clock::time_point mainStart;
+};
+
+// Keys of the game
+struct GameEvents
+{
+	bool addStone = false;
+	bool pass = false;
+	bool newGame = false;
+	bool undo = false;
+	bool redo = false;
+	bool toggleIllegalPoints = false;
+
+	void reset() { newGame = false; addStone = false; pass = false; undo = false; redo = false; toggleIllegalPoints = false; }
+	bool fired() const { return (newGame || addStone || pass || undo || redo || toggleIllegalPoints); }
+};
+
+// Seeking in a replay with the keyboard. Key repeat counts, holding an arrow scrubs through the game
+struct ReplayEvents
+{
+	int moveStep = 0;
+	bool toStart = false;
+	bool toEnd = false;
+	int gameStep = 0;
+
+	void reset() { moveStep = 0; toStart = false; toEnd = false; gameStep = 0; }
+	bool fired() const { return moveStep != 0 || toStart || toEnd || gameStep != 0; }
+};
+
+// What the window callbacks gathered since the previous iteration of the loop. Each scene reads the part it uses
+struct FrameInput
+{
+	// Earliest input of the iteration, in glfw time. -1 if none
+	double inputTime = -1.0;
+	// Cursor position in the window, and whether the left button is held
+	double cursorX = -1.0;
+	double cursorY = -1.0;
+	bool isButtonDown = false;
+
+	// A left click is addStone
+	GameEvents game;
+	ReplayEvents replay;
+};
+
+// What an update changed. 'inputTime' is the earliest input the change shows, for the input-to-present latency :
+// -1 when it doesn't come from the input (a position published by a logic thread on its own)
+struct SceneUpdate
+{
+	bool hasChanged = false;
+	double inputTime = -1.0;
+
+	void show(double time)
+	{
+		hasChanged = true;
+		if (time >= 0.0 && (inputTime < 0.0 || time < inputTime))
+			inputTime = time;
+	}
+};
+
+// What the loop shows : the game, the monitor or the replay. The loop does the waiting, the pacing, the profiling,
+// the overlays and the present, the scene only its own content
+class FrameScene
+{
+public:
+	virtual ~FrameScene() {}
+
+	// The layout is computed for this board size, and computed again when it changes
+	virtual std::pair<int, int> getBoardSize() const = 0;
+	// The window or the board size changed, the scene caches which depend on the size are dropped
+	virtual void setLayout(const render::Layout& layout) = 0;
+	// Applies the input and what the scene received since the previous iteration
+	virtual SceneUpdate update(const FrameInput& input, const render::Layout& layout) = 0;
+
+	// Offscreen parts, before the window framebuffer is bound
+	virtual void prepare(float pxRatio) = 0;
+	// Inside the nanovg frame
+	virtual void draw(const render::Layout& layout) = 0;
+	// After the nanovg frame is flushed : the instanced stone layer
+	virtual void drawAfterFlush(const render::Layout&) {}
+
+	// Top-left corner of the profiler overlay
+	virtual std::pair<float, float> getOverlayOrigin(const render::Layout& layout) const = 0;
+	// The loop adds the frame counter
+	virtual std::string getTitle() const = 0;
+};
+
+// Runs the scene until the window is closed. Each iteration polls the input, applies it, then draws : an input is on
+// screen in the frame that follows it. The scene is only drawn again when something visible changed, the rest of the
+// time the loop sleeps in glfwWaitEventsTimeout. The window callbacks are installed for the duration of the loop
+void runFrameLoop(GLFWwindow* window, NVGcontext& vg, const FrameLoopOptions& options, render::FrameProfiler& profiler, FrameScene& scene);
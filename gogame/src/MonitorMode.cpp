@@ -0,0 +1,105 @@
+#include "MonitorMode.h"
+
+#include <iostream>
+#include <vector>
+
+#include <GL/glew.h>
+#include <GLFW/glfw3.h>
+
+#include "BoardSync.h"
+#include "logic/SelfPlayWorker.h"
+#include "render/MonitorView.h"
+
+namespace
+{
+	class MonitorScene : public FrameScene
+	{
+	public:
+		MonitorScene(NVGcontext& vg, int nbBoards, int boardSize, double movesPerSecond, render::ShapeCache& shapeCache)
+			: _boardSize(boardSize), _view(vg, nbBoards, boardSize, boardSize),
+			// A single logic thread plays all the games, one move each per tick
+			_games{ nbBoards, boardSize, boardSize, movesPerSecond, [] { glfwPostEmptyEvent(); } },
+			_shownVersions(nbBoards, ~0ull)
+		{
+			_view.setShapeCache(&shapeCache);
+			applySummaries(_games.getSnapshot());
+		}
+
+		// The monitor places its boards itself, only the window size of the layout is used
+		std::pair<int, int> getBoardSize() const override { return std::make_pair(_boardSize, _boardSize); }
+		void setLayout(const render::Layout& layout) override { _view.setWindowSize(layout.winWidth(), layout.winHeight()); }
+
+		// Nothing to play here, only the debug keys do something
+		SceneUpdate update(const FrameInput&, const render::Layout&) override
+		{
+			SceneUpdate update;
+			if (_games.updateSnapshot() && applySummaries(_games.getSnapshot()))
+				update.show(-1.0);
+			return update;
+		}
+
+		void prepare(float pxRatio) override { _nbRenderedBoards += _view.prepare(pxRatio); }
+		void draw(const render::Layout&) override { _view.draw(); }
+
+		std::pair<float, float> getOverlayOrigin(const render::Layout&) const override { return std::make_pair(10.f, 10.f); }
+		std::string getTitle() const override { return "Nanovg - " + std::to_string(_view.nbBoards()) + " games"; }
+
+		unsigned long long int getNbRenderedBoards() const { return _nbRenderedBoards; }
+
+		// The logic thread wakes glfw up, it must be stopped before glfwTerminate
+		void release()
+		{
+			_games.stop();
+			_view.release();
+		}
+
+	private:
+		// Copies the games which changed since the previous tick into the view. Returns true if any did
+		bool applySummaries(const std::vector<logic::GameSummary>& summaries)
+		{
+			bool hasChanged = false;
+			for (size_t i = 0; i < summaries.size(); ++i)
+			{
+				const auto& summary = summaries[i];
+				if (summary.version == _shownVersions[i])
+					continue;
+
+				auto& board = _view.editBoard(int(i));
+				syncStones(summary.stones, _boardSize, _boardSize, board.stones);
+				board.lastMoveI = summary.lastMove.x;
+				board.lastMoveJ = summary.lastMove.y;
+				board.nextPlayer = (summary.currentPlayer == logic::Player::BLACK) ? render::Player::Black : render::Player::White;
+				board.nbMoves = int(summary.nbMoves);
+				board.isGameOver = summary.isGameOver;
+				board.scoreBlack = int(summary.scoreBlack);
+				board.scoreWhite = int(summary.scoreWhite);
+
+				_shownVersions[i] = summary.version;
+				hasChanged = true;
+			}
+			return hasChanged;
+		}
+
+		int _boardSize;
+		render::MonitorView _view;
+		logic::SelfPlayWorker _games;
+		std::vector<unsigned long long int> _shownVersions;
+		unsigned long long int _nbRenderedBoards = 0;
+	};
+}
+
+void runMonitor(GLFWwindow* window, NVGcontext& vg, const FrameLoopOptions& loopOptions, int nbBoards, int boardSize, double movesPerSecond,
+	render::ShapeCache& shapeCache, render::FrameProfiler& profiler)
+{
+	MonitorScene scene(vg, nbBoards, boardSize, movesPerSecond, shapeCache);
+	runFrameLoop(window, vg, loopOptions, profiler, scene);
+
+	const auto nbFrames = profiler.nbFrames();
+	if (nbFrames > 0)
+	{
+		std::cout << double(scene.getNbRenderedBoards()) / double(nbFrames) << " boards rendered per frame out of "
+			<< nbBoards << ", " << profiler.averageCpuMs(render::FrameProfiler::Stage::Prepare) << " ms to render them" << std::endl;
+	}
+
+	scene.release();
+}
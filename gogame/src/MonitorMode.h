@@ -0,0 +1,8 @@
+#pragma once
+#include "FrameLoop.h"
+#include "render/ShapeCache.h"
+
+// Watches self-play games instead of playing one, in a grid of boards. Same loop as the game : the window is only
+// drawn again when a game changed, and then only the boards of these games are rendered again
+void runMonitor(GLFWwindow* window, NVGcontext& vg, const FrameLoopOptions& loopOptions, int nbBoards, int boardSize, double movesPerSecond,
+	render::ShapeCache& shapeCache, render::FrameProfiler& profiler);
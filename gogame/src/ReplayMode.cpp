@@ -0,0 +1,253 @@
+#include "ReplayMode.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+
+#include "BoardSync.h"
+#include "logic/ReplayTimeline.h"
+#include "render/GoModel.h"
+#include "render/ReplaySlider.h"
+#include "render/StoneLayer.h"
+
+namespace
+{
+	// What the replay shows of the current game. It's built again when another game of the collection is chosen, as
+	// its board may have another size
+	struct ReplayBoard
+	{
+		ReplayBoard(NVGcontext& vg, int boardWidth, int boardHeight, render::ShapeCache& shapeCache)
+			: context(vg, boardWidth, boardHeight), model(context)
+		{
+			context.setShapeCache(&shapeCache);
+		}
+
+		render::DrawContext context;
+		render::GoModel model;
+		render::ReplaySlider slider;
+
+		// Position after 'move' moves. -1 until the first seek
+		std::vector<logic::Stone> stones;
+		int move = -1;
+	};
+
+	struct ReplayStatistics
+	{
+		unsigned long long int nbSeeks = 0;
+		unsigned long long int nbAppliedMoves = 0;
+		double seekSeconds = 0.0;
+	};
+
+	// Moves the board to the position after 'move' moves : at most a checkpoint interval of deltas, then the stones
+	// which differ are updated
+	void seekReplay(const logic::ReplayTimeline& timeline, int move, ReplayBoard& board, ReplayStatistics& stats)
+	{
+		move = std::max(0, std::min(move, timeline.getNbMoves()));
+		if (move == board.move)
+			return;
+
+		const auto start = std::chrono::steady_clock::now();
+		stats.nbAppliedMoves += timeline.seek(board.move, move, board.stones);
+		board.move = move;
+		syncStones(board.stones, timeline.getDimensionX(), timeline.getDimensionY(), board.model.stones);
+		stats.seekSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		stats.nbSeeks++;
+
+		// The last move is marked like a hovered point
+		const auto lastMove = timeline.getLastMove(move);
+		board.model.board.setPickedPosition(lastMove.x, lastMove.y);
+
+		auto& infos = board.model.infos;
+		infos.setPlayer(timeline.getNextPlayer(move) == logic::Player::BLACK ? render::Player::Black : render::Player::White);
+		// The score of a replay is the number of captured stones
+		infos.setScore(int(timeline.getCapturesBlack(move)), int(timeline.getCapturesWhite(move)));
+		board.slider.setMove(move);
+	}
+
+	std::unique_ptr<ReplayBoard> createReplayBoard(NVGcontext& vg, const logic::ReplayTimeline& timeline, int gameIndex, int nbGames,
+		render::ShapeCache& shapeCache)
+	{
+		std::unique_ptr<ReplayBoard> board(new ReplayBoard(vg, timeline.getDimensionX(), timeline.getDimensionY(), shapeCache));
+		board->model.board.setPickColor(render::PickColor::Green);
+		board->slider.setNbMoves(timeline.getNbMoves());
+		if (nbGames > 1)
+			board->slider.setCaption("game " + std::to_string(gameIndex + 1) + " / " + std::to_string(nbGames));
+
+		std::string message = "Drag the slider, or [Left]/[Right], [Page Up]/[Page Down], [Home]/[End] to move in the game";
+		if (nbGames > 1)
+			message += ", [Up]/[Down] to change game";
+		if (timeline.isTruncated())
+			message += ". The game stops at move " + std::to_string(timeline.getNbMoves() + 1) + ", which our rules refuse";
+		board->model.infos.setMessage(message);
+		return board;
+	}
+
+	class ReplayScene : public FrameScene
+	{
+	public:
+		ReplayScene(NVGcontext& vg, const std::vector<logic::GameRecord>& games, render::ShapeCache& shapeCache)
+			: _vg(vg), _games(games), _shapeCache(shapeCache), _timelines(games.size())
+		{
+			showGame(0);
+
+			if (!_stoneLayer.init())
+				std::cout << "Instanced stone layer unavailable, stones are drawn with nanovg" << std::endl;
+		}
+
+		std::pair<int, int> getBoardSize() const override
+		{
+			return std::make_pair(getTimeline().getDimensionX(), getTimeline().getDimensionY());
+		}
+
+		void setLayout(const render::Layout& layout) override
+		{
+			_layout = layout;
+			_board->context.setSquareSize(layout.squareSize());
+			render::invalidate(_board->model);
+			// Under the Informations panel
+			const auto panel = layout.sidePanelOrigin();
+			_board->slider.setOrigin(panel.first, panel.second + render::Informations::height() + 10.f);
+		}
+
+		SceneUpdate update(const FrameInput& input, const render::Layout&) override
+		{
+			SceneUpdate update;
+
+			if (input.replay.gameStep != 0)
+			{
+				const auto nbGames = int(_games.size());
+				const auto newIndex = std::max(0, std::min(_gameIndex + input.replay.gameStep, nbGames - 1));
+				if (newIndex != _gameIndex)
+				{
+					showGame(newIndex);
+					// The board size may be the same, the loop wouldn't give a new layout
+					setLayout(_layout);
+					update.show(input.inputTime);
+				}
+			}
+			const auto& timeline = getTimeline();
+
+			// A press on the track starts a drag, which follows the mouse until the button is released
+			const auto cursorX = float(input.cursorX);
+			if (input.game.addStone && _board->slider.contains(cursorX, float(input.cursorY)))
+				_isDragging = true;
+			else if (_isDragging && !input.isButtonDown)
+				_isDragging = false;
+
+			int move = _board->move;
+			if (_isDragging)
+				move = _board->slider.moveAt(cursorX);
+			if (input.replay.toStart)
+				move = 0;
+			if (input.replay.toEnd)
+				move = timeline.getNbMoves();
+			move += input.replay.moveStep;
+
+			const auto previousMove = _board->move;
+			seekReplay(timeline, move, *_board, _stats);
+			if (_board->move != previousMove)
+				update.show(input.inputTime);
+			return update;
+		}
+
+		void prepare(float pxRatio) override { render::prepare(_board->model, pxRatio); }
+
+		void draw(const render::Layout& layout) override
+		{
+			render::draw(_board->model, layout, _stoneLayer.isValid() ? &_stoneLayer : nullptr);
+
+			const auto sliderOrigin = _board->slider.origin();
+			nvgTranslate(&_vg, sliderOrigin.first, sliderOrigin.second);
+			_board->slider.draw(_board->context);
+			nvgTranslate(&_vg, -sliderOrigin.first, -sliderOrigin.second);
+		}
+
+		void drawAfterFlush(const render::Layout& layout) override { _stoneLayer.draw(layout.winWidth(), layout.winHeight()); }
+
+		// Under the slider
+		std::pair<float, float> getOverlayOrigin(const render::Layout&) const override
+		{
+			const auto sliderOrigin = _board->slider.origin();
+			return std::make_pair(sliderOrigin.first, sliderOrigin.second + render::ReplaySlider::height() + 10.f);
+		}
+		std::string getTitle() const override { return "Nanovg - replay"; }
+
+		const ReplayStatistics& getStatistics() const { return _stats; }
+
+		// Needs the GL context
+		void release()
+		{
+			render::release(_board->model);
+			_stoneLayer.release();
+		}
+
+	private:
+		const logic::ReplayTimeline& getTimeline() const { return *_timelines[_gameIndex]; }
+
+		// Built the first time a game is shown, a long collection is only replayed as far as it's browsed
+		void showGame(int index)
+		{
+			_gameIndex = index;
+			if (!_timelines[index])
+				_timelines[index].reset(new logic::ReplayTimeline(_games[index]));
+
+			if (_board)
+				render::release(_board->model);
+			_board = createReplayBoard(_vg, *_timelines[index], index, int(_games.size()), _shapeCache);
+			seekReplay(*_timelines[index], 0, *_board, _stats);
+			_isDragging = false;
+		}
+
+		NVGcontext& _vg;
+		const std::vector<logic::GameRecord>& _games;
+		render::ShapeCache& _shapeCache;
+		std::vector<std::unique_ptr<logic::ReplayTimeline>> _timelines;
+		int _gameIndex = 0;
+		std::unique_ptr<ReplayBoard> _board;
+		render::StoneLayer _stoneLayer;
+		render::Layout _layout;
+		bool _isDragging = false;
+		ReplayStatistics _stats;
+	};
+}
+
+std::vector<logic::GameRecord> loadReplayGames(const std::string& fileName)
+{
+	std::ifstream file(fileName, std::ios::binary);
+	if (!file)
+		throw std::runtime_error("Can't open " + fileName);
+
+	std::stringstream content;
+	content << file.rdbuf();
+
+	std::vector<logic::GameRecord> games;
+	for (auto& game : logic::parseSgf(content.str()))
+	{
+		if (!game.hasSetupStones && game.sizeX >= 2 && game.sizeY >= 2)
+			games.push_back(std::move(game));
+	}
+
+	if (games.empty())
+		throw std::runtime_error("No game to replay in " + fileName);
+	return games;
+}
+
+void runReplay(GLFWwindow* window, NVGcontext& vg, const FrameLoopOptions& loopOptions, const std::vector<logic::GameRecord>& games,
+	render::ShapeCache& shapeCache, render::FrameProfiler& profiler)
+{
+	ReplayScene scene(vg, games, shapeCache);
+	runFrameLoop(window, vg, loopOptions, profiler, scene);
+
+	const auto& stats = scene.getStatistics();
+	if (stats.nbSeeks > 0)
+	{
+		std::cout << stats.nbSeeks << " seeks, " << double(stats.nbAppliedMoves) / double(stats.nbSeeks) << " moves applied and "
+			<< stats.seekSeconds * 1e6 / double(stats.nbSeeks) << " us by seek" << std::endl;
+	}
+
+	scene.release();
+}
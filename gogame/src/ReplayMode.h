@@ -0,0 +1,17 @@
+#pragma once
+#include <string>
+#include <vector>
+
+#include "FrameLoop.h"
+#include "logic/GameRecord.h"
+#include "render/ShapeCache.h"
+
+// The games of the file our logic layer can replay : the ones with setup stones are left out.
+// Throws std::runtime_error if the file can't be read or holds nothing to replay
+std::vector<logic::GameRecord> loadReplayGames(const std::string& fileName);
+
+// Replays recorded games with a move slider. Same loop as the game, but the position comes from the timeline of the
+// game instead of the logic thread : a seek costs a few moves whatever the length of the game, so dragging the slider
+// redraws each frame
+void runReplay(GLFWwindow* window, NVGcontext& vg, const FrameLoopOptions& loopOptions, const std::vector<logic::GameRecord>& games,
+	render::ShapeCache& shapeCache, render::FrameProfiler& profiler);
@@ -13,12 +13,38 @@ namespace logic
 		_stoneBoard(sizeX * sizeY, Stone::NONE),
 		_chainBoard(sizeX * sizeY, 0u),
 		_nbLibertiesOfChains{},
-		_lastRemovedStones{}
+		_lastRemovedStones{},
+		_journal{ nullptr }
 	{
 		// We probably won't need to remove 81 stones at once but just to be safe...
 		_lastRemovedStones.reserve(_sizeX * _sizeY);
 	}
 
+	Board::Board(const Board& other) :
+		_chainBoard{ other._chainBoard },
+		_stoneBoard{ other._stoneBoard },
+		_nbLibertiesOfChains{ other._nbLibertiesOfChains },
+		_lastRemovedStones{ other._lastRemovedStones },
+		_nextChainID{ other._nextChainID },
+		_sizeX{ other._sizeX },
+		_sizeY{ other._sizeY },
+		_journal{ nullptr }
+	{
+	}
+
+	Board& Board::operator=(const Board& other)
+	{
+		// The journal belongs to the board being assigned, we don't take the other one
+		_chainBoard = other._chainBoard;
+		_stoneBoard = other._stoneBoard;
+		_nbLibertiesOfChains = other._nbLibertiesOfChains;
+		_lastRemovedStones = other._lastRemovedStones;
+		_nextChainID = other._nextChainID;
+		_sizeX = other._sizeX;
+		_sizeY = other._sizeY;
+		return *this;
+	}
+
 
 	void Board::reset()
 	{
@@ -35,6 +61,16 @@ namespace logic
 		_nextChainID++;
 	}
 
+	void Board::setNextChainId(ChainID chain)
+	{
+		_nextChainID = chain;
+	}
+
+	void Board::setJournal(std::vector<BoardChange>* journal)
+	{
+		_journal = journal;
+	}
+
 	const std::vector<Stone>& Board::getStoneBoard() const
 	{
 		return _stoneBoard;
@@ -89,12 +125,14 @@ namespace logic
 
 	void Board::setStoneAt(int i, Stone stone)
 	{
+		if (_journal)
+			_journal->push_back({ BoardChange::Type::STONE, true, true, static_cast<unsigned int>(i), static_cast<unsigned int>(_stoneBoard[i]), static_cast<unsigned int>(stone) });
 		_stoneBoard[i] = stone;
 	}
 
 	void Board::setStoneAt(Position pos, Stone stone)
 	{
-		_stoneBoard[pos.x + pos.y*_sizeX] = stone;
+		setStoneAt(pos.x + pos.y*_sizeX, stone);
 	}
 
 	ChainID Board::getChainAt(Position pos) const
@@ -113,11 +151,13 @@ namespace logic
 
 	void Board::setChainAt(Position pos, ChainID chain)
 	{
-		_chainBoard[pos.x + pos.y*_sizeX] = chain;
+		setChainAt(pos.x + pos.y*_sizeX, chain);
 	}
 
 	void Board::setChainAt(int i, ChainID chain)
 	{
+		if (_journal)
+			_journal->push_back({ BoardChange::Type::CHAIN, true, true, static_cast<unsigned int>(i), _chainBoard[i], chain });
 		_chainBoard[i] = chain;
 	}
 
@@ -128,12 +168,73 @@ namespace logic
 
 	void Board::decrementNbLibertiesOfChain(ChainID chain)
 	{
-		_nbLibertiesOfChains[chain]--;
+		auto search = _nbLibertiesOfChains.find(chain);
+		writeNbLibertiesOfChain(chain, (search != _nbLibertiesOfChains.end() ? search->second : 0u) - 1);
 	}
 
 	void Board::incrementNbLibertiesOfChain(ChainID chain)
 	{
-		_nbLibertiesOfChains[chain]++;
+		auto search = _nbLibertiesOfChains.find(chain);
+		writeNbLibertiesOfChain(chain, (search != _nbLibertiesOfChains.end() ? search->second : 0u) + 1);
+	}
+
+	void Board::writeNbLibertiesOfChain(ChainID chain, unsigned int newValue)
+	{
+		if (_journal)
+		{
+			auto search = _nbLibertiesOfChains.find(chain);
+			bool existed = (search != _nbLibertiesOfChains.end());
+			_journal->push_back({ BoardChange::Type::LIBERTIES, existed, true, chain, existed ? search->second : 0u, newValue });
+		}
+		_nbLibertiesOfChains[chain] = newValue;
+	}
+
+	void Board::eraseNbLibertiesOfChain(ChainID chain)
+	{
+		auto search = _nbLibertiesOfChains.find(chain);
+		if (search == _nbLibertiesOfChains.end())
+			return;
+
+		if (_journal)
+			_journal->push_back({ BoardChange::Type::LIBERTIES, true, false, chain, search->second, 0u });
+		_nbLibertiesOfChains.erase(search);
+	}
+
+	void Board::redoChanges(const BoardChange* begin, const BoardChange* end)
+	{
+		for (auto change = begin; change != end; ++change)
+		{
+			switch (change->type)
+			{
+			case BoardChange::Type::STONE: _stoneBoard[change->key] = static_cast<Stone>(change->after); break;
+			case BoardChange::Type::CHAIN: _chainBoard[change->key] = change->after; break;
+			case BoardChange::Type::LIBERTIES:
+				if (change->existsAfter)
+					_nbLibertiesOfChains[change->key] = change->after;
+				else
+					_nbLibertiesOfChains.erase(change->key);
+				break;
+			}
+		}
+	}
+
+	void Board::undoChanges(const BoardChange* begin, const BoardChange* end)
+	{
+		for (auto change = end; change != begin; )
+		{
+			--change;
+			switch (change->type)
+			{
+			case BoardChange::Type::STONE: _stoneBoard[change->key] = static_cast<Stone>(change->before); break;
+			case BoardChange::Type::CHAIN: _chainBoard[change->key] = change->before; break;
+			case BoardChange::Type::LIBERTIES:
+				if (change->existedBefore)
+					_nbLibertiesOfChains[change->key] = change->before;
+				else
+					_nbLibertiesOfChains.erase(change->key);
+				break;
+			}
+		}
 	}
 
 	unsigned int Board::getNbLibertiesOfChainAtPosition(Position position) const
@@ -141,14 +242,19 @@ namespace logic
 		return _nbLibertiesOfChains.at(getChainAt(position));
 	}
 
-	const std::vector<Position>& Board::getLastRemovedStones()
+	const std::vector<Position>& Board::getLastRemovedStones() const
 	{
 		return _lastRemovedStones;
 	}
 
+	void Board::clearLastRemovedStones()
+	{
+		_lastRemovedStones.clear();
+	}
+
 	void Board::setNbLibertiesOfChain(ChainID chain, unsigned int newValue)
 	{
-		_nbLibertiesOfChains[chain] = newValue;
+		writeNbLibertiesOfChain(chain, newValue);
 	}
 
 	int Board::computeNbLibertiesInCommonBetweenChains(ChainID chain1, ChainID chain2)
@@ -230,8 +336,8 @@ namespace logic
 					setChainAt(i, chainAtPos);
 			}
 
-			_nbLibertiesOfChains[chainAtPos] = _nbLibertiesOfChains[chainAtPos] + _nbLibertiesOfChains[chainAtOtherPos] - nbLibertyInCommon - 1;
-			_nbLibertiesOfChains.erase(chainAtOtherPos);
+			writeNbLibertiesOfChain(chainAtPos, _nbLibertiesOfChains[chainAtPos] + _nbLibertiesOfChains[chainAtOtherPos] - nbLibertyInCommon - 1);
+			eraseNbLibertiesOfChain(chainAtOtherPos);
 		}
 	}
 
@@ -262,9 +368,8 @@ namespace logic
 	void Board::removeChain(ChainID chain)
 	{
 		// This function constructs a list of stone positions belonging to the given chain we have to remove
-
-		// We start by emptying our vector
-		_lastRemovedStones.clear();
+		// The positions are appended to _lastRemovedStones : one move can capture several chains, and we want all of them.
+		// It's up to the caller to clear the list before a new move
 
 		// We iterate over the board and each time we found a stone of the wanted chain, we delete it
 		for (int i = 0; i < _stoneBoard.size(); ++i)
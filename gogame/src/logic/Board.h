@@ -5,6 +5,26 @@
 
 namespace logic
 {
+	// One modification of the board, with the value before and after. A list of them is enough to undo or redo a move
+	// without copying the whole board
+	struct BoardChange
+	{
+		enum class Type : unsigned char
+		{
+			STONE,		// key is an intersection index, values are Stone
+			CHAIN,		// key is an intersection index, values are ChainID
+			LIBERTIES	// key is a ChainID, values are numbers of liberties
+		};
+
+		Type type;
+		// For LIBERTIES, whether the chain had an entry in the map before/after the change
+		bool existedBefore;
+		bool existsAfter;
+		unsigned int key;
+		unsigned int before;
+		unsigned int after;
+	};
+
 	class Board
 	{
 		//To index the grid, I use a linear index i or a position(x, y)
@@ -26,9 +46,17 @@ namespace logic
 		// Dimensions of the board
 		int _sizeX;
 		int _sizeY;
+		// When set, every modification is recorded there (see GameState, for undo/redo). Not owned, and never copied
+		// along with the board : a copy starts without journal
+		std::vector<BoardChange>* _journal;
+
+		void writeNbLibertiesOfChain(ChainID chain, unsigned int newValue);
+		void eraseNbLibertiesOfChain(ChainID chain);
 
 	public:
 		Board(int sizeX, int sizeY);
+		Board(const Board& other);
+		Board& operator=(const Board& other);
 		
 		void reset();
 		
@@ -53,7 +81,14 @@ namespace logic
 		unsigned int getNbLibertiesOfChain(ChainID chain) const;
 		unsigned int getNbLibertiesOfChainAtPosition(Position position) const;
 		void setNbLibertiesOfChain(ChainID chain, unsigned int newValue);
-		const std::vector<Position>& getLastRemovedStones();
+		const std::vector<Position>& getLastRemovedStones() const;
+		void clearLastRemovedStones();
+
+		void setNextChainId(ChainID chain);
+		void setJournal(std::vector<BoardChange>* journal);
+		// Applies the 'after' values of the changes in order, or the 'before' values in reverse order
+		void redoChanges(const BoardChange* begin, const BoardChange* end);
+		void undoChanges(const BoardChange* begin, const BoardChange* end);
 
 		void incrementNextChainId();
 		void decrementNbLibertiesOfChain(ChainID chain);
@@ -0,0 +1,32 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include "util.h"
+
+namespace logic
+{
+	// What changed on the board after an action of GameState. Consumers (renderer, spectators...) can apply it
+	// on their own copy of the board instead of reading every intersection again
+	struct BoardDelta
+	{
+		enum class Type : unsigned char
+		{
+			MOVE,	// A stone was placed at 'placed', and the stones at 'captured' removed
+			PASS,	// Nothing changed on the board, only the player to move
+			UNDO,	// The stone at 'placed' was removed, and the stones at 'captured' put back with the color opposite to 'placedStone'
+			RESET	// New game, the board is empty
+		};
+
+		Type type = Type::RESET;
+		Position placed;
+		Stone placedStone = Stone::NONE;
+		std::vector<Position> captured;
+		// Hash of the board after the action
+		unsigned long long int hash = 0;
+		Player nextPlayer = Player::BLACK;
+	};
+
+	// The delta is only valid during the call, copy it to keep it
+	using BoardListener = std::function<void(const BoardDelta&)>;
+	using ListenerID = unsigned int;
+}
@@ -0,0 +1,171 @@
+#include "GameRecord.h"
+#include <cctype>
+#include <stdexcept>
+
+namespace logic
+{
+	namespace
+	{
+		// Minimal recursive descent parser following the SGF grammar:
+		//   Collection = GameTree+ ; GameTree = "(" Sequence GameTree* ")" ; Sequence = Node+ ; Node = ";" Property*
+		class SgfParser
+		{
+			const std::string& _content;
+			size_t _index;
+
+		public:
+			SgfParser(const std::string& content) : _content{ content }, _index{ 0 } {}
+
+			std::vector<GameRecord> parseCollection()
+			{
+				std::vector<GameRecord> games;
+
+				skipSpaces();
+				while (_index < _content.size())
+				{
+					if (_content[_index] != '(')
+						throw std::runtime_error("Invalid SGF : expected '(' at offset " + std::to_string(_index));
+
+					GameRecord game;
+					parseGameTree(game, true);
+					games.push_back(std::move(game));
+					skipSpaces();
+				}
+
+				return games;
+			}
+
+		private:
+			void skipSpaces()
+			{
+				while (_index < _content.size() && std::isspace(static_cast<unsigned char>(_content[_index])))
+					_index++;
+			}
+
+			char peek()
+			{
+				skipSpaces();
+				if (_index >= _content.size())
+					throw std::runtime_error("Invalid SGF : unexpected end of file");
+				return _content[_index];
+			}
+
+			// When isMainLine is false, the tree is a variation : we parse it to move forward but we don't record anything
+			void parseGameTree(GameRecord& game, bool isMainLine)
+			{
+				// Skip '('
+				_index++;
+
+				while (peek() == ';')
+				{
+					_index++;
+					parseNode(game, isMainLine);
+				}
+
+				// The first sub-tree continues the main line, the others are variations
+				bool isFirstChild = true;
+				while (peek() == '(')
+				{
+					parseGameTree(game, isMainLine && isFirstChild);
+					isFirstChild = false;
+				}
+
+				if (peek() != ')')
+					throw std::runtime_error("Invalid SGF : expected ')' at offset " + std::to_string(_index));
+				_index++;
+			}
+
+			void parseNode(GameRecord& game, bool isMainLine)
+			{
+				while (std::isalpha(static_cast<unsigned char>(peek())))
+				{
+					// Old SGF versions allowed lower case letters in identifiers (AddBlack -> AB), we only keep the upper case ones
+					std::string identifier;
+					while (_index < _content.size() && std::isalpha(static_cast<unsigned char>(_content[_index])))
+					{
+						if (std::isupper(static_cast<unsigned char>(_content[_index])))
+							identifier += _content[_index];
+						_index++;
+					}
+
+					if (peek() != '[')
+						throw std::runtime_error("Invalid SGF : property " + identifier + " without value");
+
+					while (peek() == '[')
+					{
+						std::string value = parseValue();
+						if (isMainLine)
+							applyProperty(game, identifier, value);
+					}
+				}
+			}
+
+			std::string parseValue()
+			{
+				// Skip '['
+				_index++;
+
+				std::string value;
+				while (_index < _content.size() && _content[_index] != ']')
+				{
+					// '\' escapes the next character, ']' included
+					if (_content[_index] == '\\')
+						_index++;
+					if (_index < _content.size())
+						value += _content[_index++];
+				}
+
+				if (_index >= _content.size())
+					throw std::runtime_error("Invalid SGF : unterminated property value");
+
+				// Skip ']'
+				_index++;
+				return value;
+			}
+
+			static void applyProperty(GameRecord& game, const std::string& identifier, const std::string& value)
+			{
+				if (identifier == "SZ")
+				{
+					// Either "19" or "19:13" for rectangular boards
+					size_t separator = value.find(':');
+					game.sizeX = std::stoi(value.substr(0, separator));
+					game.sizeY = (separator == std::string::npos) ? game.sizeX : std::stoi(value.substr(separator + 1));
+				}
+				else if (identifier == "B" || identifier == "W")
+				{
+					RecordedMove move;
+					move.player = (identifier == "B") ? Player::BLACK : Player::WHITE;
+					// An empty value is a pass, and "tt" too on boards up to 19x19 (FF[3] convention)
+					move.isPass = value.empty() || (value == "tt" && game.sizeX <= 19 && game.sizeY <= 19);
+					if (!move.isPass)
+					{
+						if (value.size() < 2 || !std::islower(static_cast<unsigned char>(value[0])) || !std::islower(static_cast<unsigned char>(value[1])))
+							throw std::runtime_error("Invalid SGF : bad move coordinates '" + value + "'");
+						move.pos = { value[0] - 'a', value[1] - 'a' };
+					}
+					game.moves.push_back(move);
+				}
+				else if (identifier == "AB" || identifier == "AW" || identifier == "AE")
+				{
+					game.hasSetupStones = true;
+				}
+				else if (identifier == "RE")
+				{
+					// "B+R", "W+3.5", "0" (draw), "?" (unknown)...
+					if (!value.empty() && (value[0] == 'B' || value[0] == 'W'))
+					{
+						game.hasWinner = true;
+						game.winner = (value[0] == 'B') ? Player::BLACK : Player::WHITE;
+					}
+				}
+			}
+		};
+	}
+
+	std::vector<GameRecord> parseSgf(const std::string& content)
+	{
+		SgfParser parser{ content };
+		return parser.parseCollection();
+	}
+}
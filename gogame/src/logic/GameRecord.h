@@ -0,0 +1,33 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "util.h"
+
+namespace logic
+{
+	// One move of a recorded game. A pass has no meaningful position
+	struct RecordedMove
+	{
+		Player player;
+		bool isPass;
+		Position pos;
+	};
+
+	// Main line of a recorded game, as much as our logic layer can replay it
+	struct GameRecord
+	{
+		int sizeX = 19;
+		int sizeY = 19;
+		std::vector<RecordedMove> moves;
+		// Games with setup stones (handicap, problems...) can't be replayed with GameState, we only flag them
+		bool hasSetupStones = false;
+		// Winner read from the RE property, if any
+		bool hasWinner = false;
+		Player winner = Player::BLACK;
+	};
+
+	// Parses a SGF file content. A file can contain several games (a collection), we return all of them.
+	// Only the main line of each game is kept, variations are ignored.
+	// Throws std::runtime_error if the content is not valid SGF
+	std::vector<GameRecord> parseSgf(const std::string& content);
+}
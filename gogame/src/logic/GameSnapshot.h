@@ -0,0 +1,42 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "BoardDelta.h"
+#include "util.h"
+
+namespace logic
+{
+	// Copy of what the UI shows of a game at one point : it doesn't change once published, so the render thread
+	// reads it while the logic thread already works on the next moves
+	struct GameSnapshot
+	{
+		int dimX = 0;
+		int dimY = 0;
+		std::vector<Stone> stones;
+
+		// Legality of every intersection for the player to move : 0 is legal, other values are indices in
+		// moveMessages, like GameState::getMoveMessage
+		std::vector<unsigned char> moveChecks;
+		std::vector<std::string> moveMessages;
+
+		Player currentPlayer = Player::BLACK;
+		unsigned int scoreBlack = 0;
+		unsigned int scoreWhite = 0;
+		std::string message;
+		bool isGameOver = false;
+		unsigned long long int hash = 0;
+		// Number of the commands applied before this snapshot
+		unsigned long long int nbCommands = 0;
+
+		// Snapshots are numbered from 1. The deltas lead from the board of the previous snapshot to this one : a reader
+		// which saw the previous snapshot applies them, one which skipped a snapshot reads the whole board instead
+		unsigned long long int sequence = 0;
+		std::vector<BoardDelta> deltas;
+
+		bool isInside(Position pos) const { return pos.x >= 0 && pos.y >= 0 && pos.x < dimX && pos.y < dimY; }
+		Stone getStoneAt(Position pos) const { return stones[pos.x + pos.y * dimX]; }
+		bool isLegalMove(Position pos) const { return isInside(pos) && moveChecks[pos.x + pos.y * dimX] == 0; }
+		// Only for positions inside the board
+		const std::string& getMoveMessage(Position pos) const { return moveMessages[moveChecks[pos.x + pos.y * dimX]]; }
+	};
+}
@@ -6,31 +6,40 @@
 
 namespace logic
 {
+	namespace
+	{
+		const char* defaultMessage = "Click on position to add a stone, [Space] to pass, [U]/[R] to undo/redo, [N] to start a new game";
+		const char* outsideBoardMessage = "Can't add the stone : Outside of board";
+	}
 
 	GameState::GameState(int xDim, int yDim) :
 		_isGameOver{ false },
 		_board{ xDim, yDim },
-		_simulatedBoard{ xDim, yDim },
 		_currentPlayer{ Player::BLACK },
 		_scoreWhite{ 0 },
 		_scoreBlack{ 0 },
 		_nbConsecutivePass{ 0 },
-		_message{ "Click on position to add a stone, [Space] to pass, [N] to start a new game" }
+		_message{ defaultMessage },
+		_zobristTable{ &ZobristTable::forBoard(xDim, yDim) },
+		_currentHash{ 0 },
+		_nextListenerID{ 1 },
+		_areMoveChecksValid{ false }
 	{
-		initTable();
 	}
 
 	void GameState::reset()
 	{
 		_isGameOver = false;
 		_board.reset();
-		_simulatedBoard.reset();
 		_currentPlayer = Player::BLACK;
 		_scoreWhite = 0;
 		_scoreBlack = 0;
 		_nbConsecutivePass = 0;
-		initTable();
 		_oldBoardsHash.clear();
+		_currentHash = 0;
+		_gameTree.clear();
+
+		notifyListeners(BoardDelta::Type::RESET, {}, Stone::NONE, nullptr, nullptr);
 	}
 
 	int GameState::getBoardDimensionX() const
@@ -53,10 +62,11 @@ namespace logic
 		_currentPlayer = (_currentPlayer == Player::WHITE) ? Player::BLACK : Player::WHITE;
 	}
 
-	void floodfill(Position pos, const std::vector<Stone>& stoneBoard, std::vector<int>& visit, bool& seenWhite, bool& seenBlack, int& nbMarked, int value)
+	void floodfill(Position pos, const Board& board, std::vector<int>& visit, bool& seenWhite, bool& seenBlack, int& nbMarked, int value)
 	{
-		auto indexPos = (pos.x + pos.y * 9);
-		bool isInBoard = pos.x >= 0 && pos.y >= 0 && pos.x < 9 && pos.y < 9;
+		const std::vector<Stone>& stoneBoard = board.getStoneBoard();
+		auto indexPos = (pos.x + pos.y * board.getDimensionX());
+		bool isInBoard = board.isPositionInsideBoard(pos);
 
 		if (isInBoard)
 		{
@@ -67,10 +77,10 @@ namespace logic
 				visit[indexPos] = value;
 				nbMarked++;
 				// Let's see if there are positions not already visited around the neighbours
-				floodfill(getNorthPosition(pos), stoneBoard, visit, seenWhite, seenBlack, nbMarked, value);
-				floodfill(getSouthPosition(pos), stoneBoard, visit, seenWhite, seenBlack, nbMarked, value);
-				floodfill(getWestPosition(pos), stoneBoard, visit, seenWhite, seenBlack, nbMarked, value);
-				floodfill(getEastPosition(pos), stoneBoard, visit, seenWhite, seenBlack, nbMarked, value);
+				floodfill(getNorthPosition(pos), board, visit, seenWhite, seenBlack, nbMarked, value);
+				floodfill(getSouthPosition(pos), board, visit, seenWhite, seenBlack, nbMarked, value);
+				floodfill(getWestPosition(pos), board, visit, seenWhite, seenBlack, nbMarked, value);
+				floodfill(getEastPosition(pos), board, visit, seenWhite, seenBlack, nbMarked, value);
 			}
 			else if (stoneBoard[indexPos] == Stone::BLACK) 
 				seenBlack = true;
@@ -112,9 +122,9 @@ namespace logic
 				bool seenWhite = false;
 				bool seenBlack = false;
 				int nbMarked = 0;
-				int x = i % 9;
-				int y = i / 9;
-				floodfill({x, y}, _board.getStoneBoard(), positionsToVisit, seenWhite, seenBlack, nbMarked, i+1);
+				int x = i % _board.getDimensionX();
+				int y = i / _board.getDimensionX();
+				floodfill({x, y}, _board, positionsToVisit, seenWhite, seenBlack, nbMarked, i+1);
 
 				// If during the floodfill we only encountered stone of one color, we had the number of the group to 
 				// their respective counter
@@ -133,23 +143,68 @@ namespace logic
 
 	void GameState::pass()
 	{
+		// Once the game is over, passing doesn't change anything and isn't recorded in the tree
+		if (_isGameOver)
+		{
+			_nbConsecutivePass++;
+			return;
+		}
+
+		// If we already passed from this position (we came back with undo), we follow the existing node
+		NodeID existingNode = _gameTree.findChild(_gameTree.getCurrent(), true, {});
+		if (existingNode != noNode)
+		{
+			redoNode(existingNode);
+			return;
+		}
+
+		GameTreeNode node;
+		node.player = _currentPlayer;
+		node.isPass = true;
+		node.nextChainIDBefore = node.nextChainIDAfter = _board.getNextChainId();
+		node.hashBefore = node.hashAfter = _currentHash;
+		node.nbConsecutivePassBefore = _nbConsecutivePass;
+
 		_nbConsecutivePass++;
 
-		if (!_isGameOver && _nbConsecutivePass == 2)
+		if (_nbConsecutivePass == 2)
 		{
 			computeFinalScore();
 			_isGameOver = true;
+			node.endsGame = true;
 		}
 
 		if (!_isGameOver)
 			changePlayer();
+
+		_pendingChanges.clear();
+		_gameTree.setCurrent(_gameTree.addChild(_gameTree.getCurrent(), node, _pendingChanges, {}));
+
+		notifyListeners(BoardDelta::Type::PASS, {}, Stone::NONE, nullptr, nullptr);
 	}
 
 	bool GameState::precomputeStonePlacement(Position pos)
 	{
-		// We work on a copy of the board, to leave the original the way it is before making sure we can add a stone at position
-		_simulatedBoard = _board;
+		// The stone is placed on the board itself, then taken back with the changes recorded meanwhile
+		const ChainID nextChainID = _board.getNextChainId();
+		unsigned long long int hash;
+		if (!tryStonePlacement(pos, hash))
+			return false;
 
+		undoStonePlacement(nextChainID);
+		return true;
+	}
+
+	void GameState::undoStonePlacement(ChainID nextChainID)
+	{
+		_board.undoChanges(_pendingChanges.data(), _pendingChanges.data() + _pendingChanges.size());
+		_board.setNextChainId(nextChainID);
+		_board.clearLastRemovedStones();
+		_pendingChanges.clear();
+	}
+
+	bool GameState::tryStonePlacement(Position pos, unsigned long long int& hash)
+	{
 		// If the game is already over, early exit
 		if (_isGameOver)
 		{
@@ -163,14 +218,14 @@ namespace logic
 		}
 
 		// If the position is outside the board, early exit
-		if (!_simulatedBoard.isPositionInsideBoard(pos))
+		if (!_board.isPositionInsideBoard(pos))
 		{
-			_message = "Can't add the stone : Outside of board";
+			_message = outsideBoardMessage;
 			return false;
 		}
 
 		// If there's already a stone at the position, early exit
-		if (!_simulatedBoard.noStoneAtPosition(pos))
+		if (!_board.noStoneAtPosition(pos))
 		{
 			_message = "Can't add the stone : Already one at position";
 			return false;
@@ -187,8 +242,8 @@ namespace logic
 		int nbTotalLiberties = nbDirectLiberties;
 
 		// If the new stone is part of a not-newly created chain, we need to decrease his number of liberties by 1
-		if (chain != _simulatedBoard.getNextChainId())
-			nbTotalLiberties += _simulatedBoard.getNbLibertiesOfChain(chain) - 1;
+		if (chain != _board.getNextChainId())
+			nbTotalLiberties += _board.getNbLibertiesOfChain(chain) - 1;
 
 		// If there's zero liberty at the position, let's check if placing a stone there could capture other stone(s)
 		// and creating at least one new liberty, or if he can grab a liberty (at least 2 actually, 1 to connect with it, 
@@ -200,8 +255,13 @@ namespace logic
 		}
 
 		// Reaching this point we know the only problem that can appear is the superko.
-		// We put the stone at the position on the fake board
-		_simulatedBoard.setStoneAt(pos, playerToStone(_currentPlayer));
+		// We put the stone at the position. Every modification of the board is recorded from now on : it's how the
+		// placement is taken back, and it becomes the undo record of the move if it's played
+		const ChainID nextChainID = _board.getNextChainId();
+		_pendingChanges.clear();
+		_board.clearLastRemovedStones();
+		_board.setJournal(&_pendingChanges);
+		_board.setStoneAt(pos, playerToStone(_currentPlayer));
 
 		// We compute the chainID of the new stone. If it's a new chain, we pick _NextChainId
 		// If the new stone is connected to other stones of the same color, we pick the one of lowest value for conveniance
@@ -211,53 +271,131 @@ namespace logic
 		nbDirectLiberties = getDirectLiberties(pos, chain);
 
 		// If we create a new chain, initialize it and increment the nextChainId to prepare the next ones
-		if (chain == _simulatedBoard.getNextChainId())
+		if (chain == _board.getNextChainId())
 		{
-			_simulatedBoard.setNbLibertiesOfChain(chain, 0);
-			_simulatedBoard.incrementNextChainId();
+			_board.setNbLibertiesOfChain(chain, 0);
+			_board.incrementNextChainId();
 		}
 
 		// We update the stone chain.
-		_simulatedBoard.setChainAt(pos, chain);
+		_board.setChainAt(pos, chain);
 
 		// We check if some stones could be connected, and we fusion them if they are
 		Position northPos = getNorthPosition(pos);
-		if (_simulatedBoard.isPositionInsideBoard(northPos))
-			_simulatedBoard.fusionChainsFromPositions(pos, northPos);
+		if (_board.isPositionInsideBoard(northPos))
+			_board.fusionChainsFromPositions(pos, northPos);
 
 		Position southPos = getSouthPosition(pos);
-		if (_simulatedBoard.isPositionInsideBoard(southPos))
-			_simulatedBoard.fusionChainsFromPositions(pos, southPos);
+		if (_board.isPositionInsideBoard(southPos))
+			_board.fusionChainsFromPositions(pos, southPos);
 
 		Position westPos = getWestPosition(pos);
-		if (_simulatedBoard.isPositionInsideBoard(westPos))
-			_simulatedBoard.fusionChainsFromPositions(pos, westPos);
+		if (_board.isPositionInsideBoard(westPos))
+			_board.fusionChainsFromPositions(pos, westPos);
 
 		Position eastPos = getEastPosition(pos);
-		if (_simulatedBoard.isPositionInsideBoard(eastPos))
-			_simulatedBoard.fusionChainsFromPositions(pos, eastPos);
+		if (_board.isPositionInsideBoard(eastPos))
+			_board.fusionChainsFromPositions(pos, eastPos);
 
 		// We update the number of liberty for the current chain
-		_simulatedBoard.setNbLibertiesOfChain(chain, _simulatedBoard.getNbLibertiesOfChain(chain) + nbDirectLiberties);
+		_board.setNbLibertiesOfChain(chain, _board.getNbLibertiesOfChain(chain) + nbDirectLiberties);
 
 		// We tell other adjacent chains to decrease their liberties
 		decreaseLibertiesOfAdjacentChains(pos);
-
-		auto hash = computeHash(_simulatedBoard.getStoneBoard());
+		_board.setJournal(nullptr);
+
+		// The hash of the new position is the current one with the keys of the placed stone and of the captured ones
+		// flipped : the cost of what the move changed, instead of hashing the whole board again
+		const int dimX = _board.getDimensionX();
+		hash = _currentHash ^ _zobristTable->getKey(pos.x + pos.y * dimX, playerToStone(_currentPlayer));
+		const Stone capturedStone = playerToStone(opposingPlayer(_currentPlayer));
+		for (const auto& captured : _board.getLastRemovedStones())
+			hash ^= _zobristTable->getKey(captured.x + captured.y * dimX, capturedStone);
 		auto search = _oldBoardsHash.find(hash);
 
 		if (search != _oldBoardsHash.end())
 		{
 			// Board found. We did all of that for nothing. There must be a simpler test
+			undoStonePlacement(nextChainID);
 			_message = "Move impossible (Positional Superko rule)";
 			return false;
 		}
 
 		// If we reach this point, it means we can add a stone at the position safely
-		_message = "Click on position to add a stone, [Space] to pass, [N] to start a new game";
+		_message = defaultMessage;
 		return true;
 	}
 
+	void GameState::computeMoveChecks()
+	{
+		if (_areMoveChecksValid)
+			return;
+
+		// precomputeStonePlacement writes the reason of its answer in the message, we don't want the UI to see them
+		std::string message = _message;
+
+		const int dimX = _board.getDimensionX();
+		const int dimY = _board.getDimensionY();
+		_moveChecks.resize(dimX * dimY);
+		_moveCheckMessages.assign(1, defaultMessage);
+
+		for (int y = 0; y < dimY; ++y)
+		{
+			for (int x = 0; x < dimX; ++x)
+			{
+				unsigned char check = 0;
+				if (!precomputeStonePlacement({ x, y }))
+				{
+					// There's only a handful of different reasons, a linear search is enough
+					auto reason = std::find(_moveCheckMessages.begin(), _moveCheckMessages.end(), _message);
+					check = static_cast<unsigned char>(reason - _moveCheckMessages.begin());
+					if (reason == _moveCheckMessages.end())
+						_moveCheckMessages.push_back(_message);
+				}
+				_moveChecks[x + y * dimX] = check;
+			}
+		}
+
+		_message = message;
+		_areMoveChecksValid = true;
+	}
+
+	bool GameState::isLegalMove(Position pos)
+	{
+		if (!_board.isPositionInsideBoard(pos))
+			return false;
+
+		computeMoveChecks();
+		return _moveChecks[pos.x + pos.y * _board.getDimensionX()] == 0;
+	}
+
+	const std::string& GameState::getMoveMessage(Position pos)
+	{
+		static const std::string outsideMessage = outsideBoardMessage;
+		if (!_board.isPositionInsideBoard(pos))
+			return outsideMessage;
+
+		computeMoveChecks();
+		return _moveCheckMessages[_moveChecks[pos.x + pos.y * _board.getDimensionX()]];
+	}
+
+	void GameState::fillSnapshot(GameSnapshot& snapshot)
+	{
+		computeMoveChecks();
+
+		snapshot.dimX = _board.getDimensionX();
+		snapshot.dimY = _board.getDimensionY();
+		snapshot.stones = _board.getStoneBoard();
+		snapshot.moveChecks = _moveChecks;
+		snapshot.moveMessages = _moveCheckMessages;
+		snapshot.currentPlayer = _currentPlayer;
+		snapshot.scoreBlack = _scoreBlack;
+		snapshot.scoreWhite = _scoreWhite;
+		snapshot.message = _message;
+		snapshot.isGameOver = _isGameOver;
+		snapshot.hash = _currentHash;
+	}
+
 	bool GameState::canBeLinkedToChainWithLiberties(Position pos)
 	{
 		// Here we check whether there's a chain with enough (>=2) liberties around a position to be able to place that stone
@@ -267,22 +405,22 @@ namespace logic
 
 		{
 			Position northPos = getNorthPosition(pos);
-			if (_simulatedBoard.isPositionInsideBoard(northPos) && _simulatedBoard.getStoneAt(northPos) == playerStone && _simulatedBoard.getNbLibertiesOfChainAtPosition(northPos) >= 2)
+			if (_board.isPositionInsideBoard(northPos) && _board.getStoneAt(northPos) == playerStone && _board.getNbLibertiesOfChainAtPosition(northPos) >= 2)
 				result = true;
 		}
 		{
 			Position southPos = getSouthPosition(pos);
-			if (_simulatedBoard.isPositionInsideBoard(southPos) && _simulatedBoard.getStoneAt(southPos) == playerStone && _simulatedBoard.getNbLibertiesOfChainAtPosition(southPos) >= 2)
+			if (_board.isPositionInsideBoard(southPos) && _board.getStoneAt(southPos) == playerStone && _board.getNbLibertiesOfChainAtPosition(southPos) >= 2)
 				result = true;
 		}
 		{
 			Position westPos = getWestPosition(pos);
-			if (_simulatedBoard.isPositionInsideBoard(westPos) && _simulatedBoard.getStoneAt(westPos) == playerStone && _simulatedBoard.getNbLibertiesOfChainAtPosition(westPos) >= 2)
+			if (_board.isPositionInsideBoard(westPos) && _board.getStoneAt(westPos) == playerStone && _board.getNbLibertiesOfChainAtPosition(westPos) >= 2)
 				result = true;
 		}
 		{
 			Position eastPos = getEastPosition(pos);
-			if (_simulatedBoard.isPositionInsideBoard(eastPos) && _simulatedBoard.getStoneAt(eastPos) == playerStone && _simulatedBoard.getNbLibertiesOfChainAtPosition(eastPos) >= 2)
+			if (_board.isPositionInsideBoard(eastPos) && _board.getStoneAt(eastPos) == playerStone && _board.getNbLibertiesOfChainAtPosition(eastPos) >= 2)
 				result = true;
 		}
 		return result;
@@ -298,22 +436,22 @@ namespace logic
 
 		{
 			Position northPos = getNorthPosition(pos);
-			if (_simulatedBoard.isPositionInsideBoard(northPos) && _simulatedBoard.getStoneAt(northPos) == opposingStone && _simulatedBoard.getNbLibertiesOfChainAtPosition(northPos) == 1)
+			if (_board.isPositionInsideBoard(northPos) && _board.getStoneAt(northPos) == opposingStone && _board.getNbLibertiesOfChainAtPosition(northPos) == 1)
 				result = true;
 		}
 		{
 			Position southPos = getSouthPosition(pos);
-			if (_simulatedBoard.isPositionInsideBoard(southPos) && _simulatedBoard.getStoneAt(southPos) == opposingStone && _simulatedBoard.getNbLibertiesOfChainAtPosition(southPos) == 1)
+			if (_board.isPositionInsideBoard(southPos) && _board.getStoneAt(southPos) == opposingStone && _board.getNbLibertiesOfChainAtPosition(southPos) == 1)
 				result = true;
 		}
 		{
 			Position westPos = getWestPosition(pos);
-			if (_simulatedBoard.isPositionInsideBoard(westPos) && _simulatedBoard.getStoneAt(westPos) == opposingStone && _simulatedBoard.getNbLibertiesOfChainAtPosition(westPos) == 1)
+			if (_board.isPositionInsideBoard(westPos) && _board.getStoneAt(westPos) == opposingStone && _board.getNbLibertiesOfChainAtPosition(westPos) == 1)
 				result = true;
 		}
 		{
 			Position eastPos = getEastPosition(pos);
-			if (_simulatedBoard.isPositionInsideBoard(eastPos) && _simulatedBoard.getStoneAt(eastPos) == opposingStone && _simulatedBoard.getNbLibertiesOfChainAtPosition(eastPos) == 1)
+			if (_board.isPositionInsideBoard(eastPos) && _board.getStoneAt(eastPos) == opposingStone && _board.getNbLibertiesOfChainAtPosition(eastPos) == 1)
 				result = true;
 		}
 		return result;
@@ -324,40 +462,40 @@ namespace logic
 		// We pick the lowest index of the chain of the cross neighbours 
 		// If there is no neighbour (so, no adjacent chain), we use the NextChainId variable
 
-		ChainID result = _simulatedBoard.getNextChainId();
+		ChainID result = _board.getNextChainId();
 
 		Position northPos = getNorthPosition(pos);
-		if (_simulatedBoard.isPositionInsideBoard(northPos))
+		if (_board.isPositionInsideBoard(northPos))
 		{
-			Stone northStone = _simulatedBoard.getStoneAt(northPos);
-			ChainID northChain = _simulatedBoard.getChainAt(northPos);
+			Stone northStone = _board.getStoneAt(northPos);
+			ChainID northChain = _board.getChainAt(northPos);
 			if (northStone == playerToStone(_currentPlayer) && northChain > 0 && northChain < result)
 				result = northChain;
 		}
 
 		Position southPos = getSouthPosition(pos);
-		if (_simulatedBoard.isPositionInsideBoard(southPos))
+		if (_board.isPositionInsideBoard(southPos))
 		{
-			Stone southStone = _simulatedBoard.getStoneAt(southPos);
-			ChainID southChain = _simulatedBoard.getChainAt(southPos);
+			Stone southStone = _board.getStoneAt(southPos);
+			ChainID southChain = _board.getChainAt(southPos);
 			if (southStone == playerToStone(_currentPlayer) && southChain > 0 && southChain < result)
 				result = southChain;
 		}
 
 		Position westPos = getWestPosition(pos);
-		if (_simulatedBoard.isPositionInsideBoard(westPos))
+		if (_board.isPositionInsideBoard(westPos))
 		{
-			Stone westStone = _simulatedBoard.getStoneAt(westPos);
-			ChainID westChain = _simulatedBoard.getChainAt(westPos);
+			Stone westStone = _board.getStoneAt(westPos);
+			ChainID westChain = _board.getChainAt(westPos);
 			if (westStone == playerToStone(_currentPlayer) && westChain > 0 && westChain < result)
 				result = westChain;
 		}
 
 		Position eastPos = getEastPosition(pos);
-		if (_simulatedBoard.isPositionInsideBoard(eastPos))
+		if (_board.isPositionInsideBoard(eastPos))
 		{
-			Stone eastStone = _simulatedBoard.getStoneAt(eastPos);
-			ChainID eastChain = _simulatedBoard.getChainAt(eastPos);
+			Stone eastStone = _board.getStoneAt(eastPos);
+			ChainID eastChain = _board.getChainAt(eastPos);
 			if (eastStone == playerToStone(_currentPlayer) && eastChain > 0 && eastChain < result)
 				result = eastChain;
 		}
@@ -367,42 +505,186 @@ namespace logic
 
 	bool GameState::putStoneAtPosition(Position pos)
 	{
-		_simulatedBoard = _board;
+		// If the move was already played from this position (we came back with undo), it's legal and we know what it does
+		NodeID existingNode = _isGameOver ? noNode : _gameTree.findChild(_gameTree.getCurrent(), false, pos);
+		if (existingNode != noNode)
+		{
+			redoNode(existingNode);
+			_message = defaultMessage;
+			return true;
+		}
 
-		// Check if we can safely add the stone at the position
-		if (precomputeStonePlacement(pos))
+		// Check if we can safely add the stone at the position. If we can, it stays there
+		const ChainID nextChainIDBefore = _board.getNextChainId();
+		unsigned long long int hash;
+		if (tryStonePlacement(pos, hash))
 		{
+			// Board not found, this one is unique. We can add this board hash to the set, and keep the stone
+			GameTreeNode node;
+			node.player = _currentPlayer;
+			node.pos = pos;
+			node.nextChainIDBefore = nextChainIDBefore;
+			node.nextChainIDAfter = _board.getNextChainId();
+			node.hashBefore = _currentHash;
+			node.hashAfter = hash;
+			node.nbConsecutivePassBefore = _nbConsecutivePass;
+			_gameTree.setCurrent(_gameTree.addChild(_gameTree.getCurrent(), node, _pendingChanges, _board.getLastRemovedStones()));
+
 			// The player didn't pass
 			_nbConsecutivePass = 0;
 
-			// Board not found, this one is unique. We can add this board hash to the set, and place this stone
-			auto hash = computeHash(_simulatedBoard.getStoneBoard());
 			_oldBoardsHash.insert(hash);
-			_board = _simulatedBoard;
+			_currentHash = hash;
 
 			// The play is done. It's the other player turn
 			changePlayer();
 
+			const auto& captured = _board.getLastRemovedStones();
+			notifyListeners(BoardDelta::Type::MOVE, pos, _board.getStoneAt(pos), captured.data(), captured.data() + captured.size());
+
 			return true;
 		}
 
 		return false;
 	}
 
+	bool GameState::undo()
+	{
+		NodeID current = _gameTree.getCurrent();
+		if (current == _gameTree.getRoot())
+			return false;
+
+		const GameTreeNode& node = _gameTree.getNode(current);
+
+		if (node.isPass)
+		{
+			if (node.endsGame)
+			{
+				_isGameOver = false;
+				_scoreBlack = 0;
+				_scoreWhite = 0;
+			}
+		}
+		else
+		{
+			_board.undoChanges(_gameTree.getChangesBegin(node), _gameTree.getChangesEnd(node));
+			_board.setNextChainId(node.nextChainIDBefore);
+			_oldBoardsHash.erase(node.hashAfter);
+		}
+
+		_currentHash = node.hashBefore;
+		_currentPlayer = node.player;
+		_message = defaultMessage;
+		_nbConsecutivePass = node.nbConsecutivePassBefore;
+		_gameTree.setCurrent(node.parent);
+
+		if (node.isPass)
+			notifyListeners(BoardDelta::Type::PASS, {}, Stone::NONE, nullptr, nullptr);
+		else
+			notifyListeners(BoardDelta::Type::UNDO, node.pos, playerToStone(node.player), _gameTree.getCapturedBegin(node), _gameTree.getCapturedEnd(node));
+
+		return true;
+	}
+
+	bool GameState::redo(unsigned int variation)
+	{
+		NodeID child = _gameTree.getChild(_gameTree.getCurrent(), variation);
+		if (child == noNode)
+			return false;
+
+		redoNode(child);
+		return true;
+	}
+
+	bool GameState::goToNode(NodeID target)
+	{
+		if (target >= _gameTree.getNbNodes())
+			return false;
+
+		// We go up to the closest common ancestor of the current node and the target, then down to the target
+		std::vector<NodeID> pathDown;
+		NodeID current = _gameTree.getCurrent();
+		while (_gameTree.getNode(target).depth > _gameTree.getNode(current).depth)
+		{
+			pathDown.push_back(target);
+			target = _gameTree.getNode(target).parent;
+		}
+		while (_gameTree.getNode(current).depth > _gameTree.getNode(target).depth)
+		{
+			undo();
+			current = _gameTree.getCurrent();
+		}
+		while (current != target)
+		{
+			undo();
+			current = _gameTree.getCurrent();
+			pathDown.push_back(target);
+			target = _gameTree.getNode(target).parent;
+		}
+
+		for (auto node = pathDown.rbegin(); node != pathDown.rend(); ++node)
+			redoNode(*node);
+
+		return true;
+	}
+
+	unsigned int GameState::getNbVariations() const
+	{
+		return _gameTree.getNbChildren(_gameTree.getCurrent());
+	}
+
+	const GameTree& GameState::getGameTree() const
+	{
+		return _gameTree;
+	}
+
+	void GameState::redoNode(NodeID id)
+	{
+		const GameTreeNode& node = _gameTree.getNode(id);
+		_gameTree.setCurrent(id);
+
+		if (node.isPass)
+		{
+			_nbConsecutivePass = node.nbConsecutivePassBefore + 1;
+			if (node.endsGame)
+			{
+				computeFinalScore();
+				_isGameOver = true;
+			}
+			else
+			{
+				changePlayer();
+			}
+			notifyListeners(BoardDelta::Type::PASS, {}, Stone::NONE, nullptr, nullptr);
+			return;
+		}
+
+		_board.redoChanges(_gameTree.getChangesBegin(node), _gameTree.getChangesEnd(node));
+		_board.setNextChainId(node.nextChainIDAfter);
+		_oldBoardsHash.insert(node.hashAfter);
+		_currentHash = node.hashAfter;
+		_nbConsecutivePass = 0;
+		changePlayer();
+
+		notifyListeners(BoardDelta::Type::MOVE, node.pos, playerToStone(node.player), _gameTree.getCapturedBegin(node), _gameTree.getCapturedEnd(node));
+	}
+
 	void GameState::decreaseLiberty(ChainID chain)
 	{
 		// Decrease the number of liberty of the chain
-		_simulatedBoard.decrementNbLibertiesOfChain(chain);
+		_board.decrementNbLibertiesOfChain(chain);
 
 		// If the number reaches zero, the chain must be deleted
-		if (_simulatedBoard.getNbLibertiesOfChain(chain) == 0)
+		if (_board.getNbLibertiesOfChain(chain) == 0)
 		{
-			// We compute the list of stones belonging the chain, and delete them
-			_simulatedBoard.removeChain(chain);
+			// We compute the list of stones belonging the chain, and delete them. Several chains can be captured by the same
+			// move, the removed stones are appended to the ones of the previous chains
+			const std::vector<Position>& removedPositions = _board.getLastRemovedStones();
+			const size_t firstRemoved = removedPositions.size();
+			_board.removeChain(chain);
 
 			// For each of this stones we deleted, we have to increase the number of liberties of the adjacent stones
-			const std::vector<Position>& removedPositions = _simulatedBoard.getLastRemovedStones();
-			std::for_each(std::begin(removedPositions), std::end(removedPositions), [&](const Position& pos) {increaseLibertiesOfAdjacentChains(pos); });
+			std::for_each(std::begin(removedPositions) + firstRemoved, std::end(removedPositions), [&](const Position& pos) {increaseLibertiesOfAdjacentChains(pos); });
 		}
 	}
 
@@ -413,31 +695,31 @@ namespace logic
 		// The tricky part is it's possible that adjacent stones and the central stone share the same chain
 
 		bool ownLibertyMustDecreased = false;
-		ChainID centralChain = _simulatedBoard.getChainAt(pos);
+		ChainID centralChain = _board.getChainAt(pos);
 
 		Position northPos = getNorthPosition(pos);
-		ChainID northChain = _simulatedBoard.getChainAt(northPos);
+		ChainID northChain = _board.getChainAt(northPos);
 		if (northChain == centralChain)
 			ownLibertyMustDecreased = true;
 		else if (northChain != 0)
 			decreaseLiberty(northChain);
 
 		Position southPos = getSouthPosition(pos);
-		ChainID southChain = _simulatedBoard.getChainAt(southPos);
+		ChainID southChain = _board.getChainAt(southPos);
 		if (southChain == centralChain)
 			ownLibertyMustDecreased = true;
 		else if (southChain != 0 && southChain != northChain)
 			decreaseLiberty(southChain);
 
 		Position westPos = getWestPosition(pos);
-		ChainID westChain = _simulatedBoard.getChainAt(westPos);
+		ChainID westChain = _board.getChainAt(westPos);
 		if (westChain == centralChain)
 			ownLibertyMustDecreased = true;
 		else if (westChain != 0 && westChain != northChain && westChain != southChain)
 			decreaseLiberty(westChain);
 
 		Position eastPos = getEastPosition(pos);
-		ChainID eastChain = _simulatedBoard.getChainAt(eastPos);
+		ChainID eastChain = _board.getChainAt(eastPos);
 		if (eastChain == centralChain)
 			ownLibertyMustDecreased = true;
 		else if (eastChain != 0 && eastChain != northChain && eastChain != southChain && eastChain != westChain)
@@ -462,6 +744,49 @@ namespace logic
 		return _scoreWhite;
 	}
 
+	bool GameState::isGameOver() const
+	{
+		return _isGameOver;
+	}
+
+	unsigned long long int GameState::getCurrentHash() const
+	{
+		return _currentHash;
+	}
+
+	const BoardDelta& GameState::getLastDelta() const
+	{
+		return _lastDelta;
+	}
+
+	ListenerID GameState::addListener(BoardListener listener)
+	{
+		ListenerID id = _nextListenerID++;
+		_listeners.emplace_back(id, std::move(listener));
+		return id;
+	}
+
+	void GameState::removeListener(ListenerID id)
+	{
+		_listeners.erase(std::remove_if(std::begin(_listeners), std::end(_listeners),
+			[id](const std::pair<ListenerID, BoardListener>& listener) { return listener.first == id; }), std::end(_listeners));
+	}
+
+	void GameState::notifyListeners(BoardDelta::Type type, Position placed, Stone placedStone, const Position* capturedBegin, const Position* capturedEnd)
+	{
+		_areMoveChecksValid = false;
+
+		_lastDelta.type = type;
+		_lastDelta.placed = placed;
+		_lastDelta.placedStone = placedStone;
+		_lastDelta.captured.assign(capturedBegin, capturedEnd);
+		_lastDelta.hash = _currentHash;
+		_lastDelta.nextPlayer = _currentPlayer;
+
+		for (const auto& listener : _listeners)
+			listener.second(_lastDelta);
+	}
+
 	int GameState::getDirectLiberties(Position pos, ChainID chain)
 	{
 		int nbDirectLiberties = 0;
@@ -470,19 +795,19 @@ namespace logic
 		// in each adjacent position and if that position is not already a liberty for our chain.
 
 		Position northPos = getNorthPosition(pos);
-		if (_simulatedBoard.isPositionInsideBoard(northPos) && _simulatedBoard.noStoneAtPosition(northPos) && !_simulatedBoard.isNextToChain(northPos, chain))
+		if (_board.isPositionInsideBoard(northPos) && _board.noStoneAtPosition(northPos) && !_board.isNextToChain(northPos, chain))
 			nbDirectLiberties++;
 
 		Position southPos = getSouthPosition(pos);
-		if (_simulatedBoard.isPositionInsideBoard(southPos) && _simulatedBoard.noStoneAtPosition(southPos) && !_simulatedBoard.isNextToChain(southPos, chain))
+		if (_board.isPositionInsideBoard(southPos) && _board.noStoneAtPosition(southPos) && !_board.isNextToChain(southPos, chain))
 			nbDirectLiberties++;
 
 		Position westPos = getWestPosition(pos);
-		if (_simulatedBoard.isPositionInsideBoard(westPos) && _simulatedBoard.noStoneAtPosition(westPos) && !_simulatedBoard.isNextToChain(westPos, chain))
+		if (_board.isPositionInsideBoard(westPos) && _board.noStoneAtPosition(westPos) && !_board.isNextToChain(westPos, chain))
 			nbDirectLiberties++;
 
 		Position eastPos = getEastPosition(pos);
-		if (_simulatedBoard.isPositionInsideBoard(eastPos) && _simulatedBoard.noStoneAtPosition(eastPos) && !_simulatedBoard.isNextToChain(eastPos, chain))
+		if (_board.isPositionInsideBoard(eastPos) && _board.noStoneAtPosition(eastPos) && !_board.isNextToChain(eastPos, chain))
 			nbDirectLiberties++;
 
 		return nbDirectLiberties;
@@ -492,57 +817,29 @@ namespace logic
 	{
 		// Dual function of decreaseLibertiesOfAdjacentChains
 		Position northPos = getNorthPosition(pos);
-		ChainID northChain = _simulatedBoard.getChainAt(northPos);
+		ChainID northChain = _board.getChainAt(northPos);
 		if (northChain != 0)
-			_simulatedBoard.incrementNbLibertiesOfChain(northChain);
+			_board.incrementNbLibertiesOfChain(northChain);
 
 		Position southPos = getSouthPosition(pos);
-		ChainID southChain = _simulatedBoard.getChainAt(southPos);
+		ChainID southChain = _board.getChainAt(southPos);
 		if (southChain != 0 && southChain != northChain)
-			_simulatedBoard.incrementNbLibertiesOfChain(southChain);
+			_board.incrementNbLibertiesOfChain(southChain);
 
 		Position westPos = getWestPosition(pos);
-		ChainID westChain = _simulatedBoard.getChainAt(westPos);
+		ChainID westChain = _board.getChainAt(westPos);
 		if (westChain != 0 && westChain != northChain && westChain != southChain)
-			_simulatedBoard.incrementNbLibertiesOfChain(westChain);
+			_board.incrementNbLibertiesOfChain(westChain);
 
 		Position eastPos = getEastPosition(pos);
-		ChainID eastChain = _simulatedBoard.getChainAt(eastPos);
+		ChainID eastChain = _board.getChainAt(eastPos);
 		if (eastChain != 0 && eastChain != northChain && eastChain != southChain && eastChain != westChain)
-			_simulatedBoard.incrementNbLibertiesOfChain(eastChain);
+			_board.incrementNbLibertiesOfChain(eastChain);
 	}
 
-	unsigned long long int GameState::randomInt()
-	{
-		std::uniform_int_distribution<unsigned long long int> dist(0, UINT64_MAX);
-		return dist(prng);
-	}
-
-	// Initializes the table
-	void GameState::initTable()
-	{
-		const int sizeBoard = _board.getDimensionX() * _board.getDimensionY();
-		for (int i = 0; i < sizeBoard; i++)
-			for (int k = 0; k < 2; k++)
-				ZobristTable[i][k] = randomInt();
-	}
-
-	// Computes the hash value of a given board
-	// Acconrding to Google, we don't actually need to recompute the hash for the whole board, but only with XOR of specific 
-	// positions that changed. Might give it a try if I have some time 
 	unsigned long long int GameState::computeHash(const std::vector<Stone>& stoneBoard)
 	{
-		const int sizeBoard = _board.getDimensionX() * _board.getDimensionY();
-		unsigned long long int h = 0;
-		for (int i = 0; i < sizeBoard; i++)
-		{
-			if (stoneBoard[i] != Stone::NONE)
-			{
-				int piece = static_cast<int>(stoneBoard[i]);
-				h ^= ZobristTable[i][piece];
-			}
-		}
-		return h;
+		return _zobristTable->computeHash(stoneBoard);
 	}
 
 }
\ No newline at end of file
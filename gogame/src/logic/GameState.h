@@ -1,15 +1,20 @@
 #pragma once
 #include "Board.h"
-#include <random>
+#include "BoardDelta.h"
+#include "GameSnapshot.h"
+#include "GameTree.h"
+#include "Zobrist.h"
 #include <set>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace logic
 {
 	class GameState
 	{
-		// We keep two boards in memory, the real one and the fake one we use to see if the superko rule is applied
+		// The board of the game. A move is checked by placing its stone on it and taking it back, see tryStonePlacement
 		Board _board;
-		Board _simulatedBoard;
 
 		// Set of the hash of all the boards configuration happening during a game. A typical Go game has a thousand of rounds
 		// So the set will grow that much. In the typical superko case  (1 for 1, see below), this is not necessary, but I have
@@ -32,10 +37,39 @@ namespace logic
 		// Whether the game is over or not
 		bool _isGameOver;
 
-		// Positional Superko necessary elements
-		unsigned long long int ZobristTable[81][2];
-		std::random_device rd;
-		std::mt19937 prng{ rd() };
+		// Positional Superko necessary elements. The table is shared by all the games played on the same board size
+		const ZobristTable* _zobristTable;
+		// Hash of the current board
+		unsigned long long int _currentHash;
+
+		// Observers notified after each move, pass or reset. The delta is kept as a member so its vector
+		// of captured stones doesn't need a new allocation at each move
+		std::vector<std::pair<ListenerID, BoardListener>> _listeners;
+		ListenerID _nextListenerID;
+		BoardDelta _lastDelta;
+
+		// Every move and pass played, with variations. _pendingChanges receives the changes of the stone being placed,
+		// they're moved into the tree if the move is played, and undone otherwise
+		GameTree _gameTree;
+		std::vector<BoardChange> _pendingChanges;
+
+		// Result of precomputeStonePlacement for every intersection, for the player to move. 0 means legal, other values
+		// are indices in _moveCheckMessages. Computed on demand, once per position : every change of the game goes
+		// through notifyListeners, which invalidates it
+		std::vector<unsigned char> _moveChecks;
+		std::vector<std::string> _moveCheckMessages;
+		bool _areMoveChecksValid;
+
+		void computeMoveChecks();
+
+		// Same checks as precomputeStonePlacement, but a legal stone is left on the board, with its changes in
+		// _pendingChanges and the hash of the new position in 'hash'. Nothing changes when the move is refused
+		bool tryStonePlacement(Position pos, unsigned long long int& hash);
+		// Takes back the stone placed by tryStonePlacement
+		void undoStonePlacement(ChainID nextChainID);
+
+		void notifyListeners(BoardDelta::Type type, Position placed, Stone placedStone, const Position* capturedBegin, const Position* capturedEnd);
+		void redoNode(NodeID id);
 
 	public:
 		GameState(int xDim, int yDim);
@@ -52,8 +86,30 @@ namespace logic
 		const std::string& getMessage() const;
 		unsigned int getScoreBlack() const;
 		unsigned int getScoreWhite() const;
+		bool isGameOver() const;
+		unsigned long long int getCurrentHash() const;
+		const BoardDelta& getLastDelta() const;
+
+		// Undo/redo cost what the move changed on the board, not the size of the board or the length of the game
+		bool undo();
+		// Plays again the move at the given variation (0 is the main line) after the current position
+		bool redo(unsigned int variation = 0);
+		// Moves to any position of the tree, through the closest common ancestor
+		bool goToNode(NodeID node);
+		unsigned int getNbVariations() const;
+		const GameTree& getGameTree() const;
+
+		ListenerID addListener(BoardListener listener);
+		void removeListener(ListenerID id);
 
 		bool precomputeStonePlacement(Position pos);
+		// Same answer as precomputeStonePlacement, but read from the cache : free after the first call of the turn.
+		// They don't change the message of the game
+		bool isLegalMove(Position pos);
+		const std::string& getMoveMessage(Position pos);
+		// Copies the board, the legality of every move, the score and the message. The vectors of the snapshot are
+		// reused, so a snapshot refilled at each move doesn't allocate
+		void fillSnapshot(GameSnapshot& snapshot);
 		bool putStoneAtPosition(Position pos);
 		bool couldCaptureStone(Position pos);
 		bool canBeLinkedToChainWithLiberties(Position pos);
@@ -64,8 +120,6 @@ namespace logic
 		void decreaseLibertiesOfAdjacentChains(Position pos);
 		void increaseLibertiesOfAdjacentChains(Position pos);
 
-		unsigned long long int randomInt();
-		void initTable();
 		unsigned long long int computeHash(const std::vector<Stone>& stoneBoard);
 	};
 }
\ No newline at end of file
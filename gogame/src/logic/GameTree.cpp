@@ -0,0 +1,102 @@
+#include "GameTree.h"
+
+namespace logic
+{
+	GameTree::GameTree()
+	{
+		clear();
+	}
+
+	void GameTree::clear()
+	{
+		_nodes.clear();
+		_changes.clear();
+		_captured.clear();
+
+		// The root is the empty board, it has no move
+		_nodes.emplace_back();
+		_current = 0;
+	}
+
+	unsigned int GameTree::getNbChildren(NodeID node) const
+	{
+		unsigned int nbChildren = 0;
+		for (NodeID child = _nodes[node].firstChild; child != noNode; child = _nodes[child].nextSibling)
+			nbChildren++;
+		return nbChildren;
+	}
+
+	NodeID GameTree::getChild(NodeID node, unsigned int variation) const
+	{
+		NodeID child = _nodes[node].firstChild;
+		while (child != noNode && variation > 0)
+		{
+			child = _nodes[child].nextSibling;
+			variation--;
+		}
+		return child;
+	}
+
+	NodeID GameTree::findChild(NodeID node, bool isPass, Position pos) const
+	{
+		for (NodeID child = _nodes[node].firstChild; child != noNode; child = _nodes[child].nextSibling)
+		{
+			const GameTreeNode& childNode = _nodes[child];
+			if (childNode.isPass == isPass && (isPass || (childNode.pos.x == pos.x && childNode.pos.y == pos.y)))
+				return child;
+		}
+		return noNode;
+	}
+
+	NodeID GameTree::addChild(NodeID parent, const GameTreeNode& node, const std::vector<BoardChange>& changes, const std::vector<Position>& captured)
+	{
+		NodeID id = static_cast<NodeID>(_nodes.size());
+		_nodes.push_back(node);
+
+		GameTreeNode& newNode = _nodes.back();
+		newNode.parent = parent;
+		newNode.firstChild = noNode;
+		newNode.nextSibling = noNode;
+		newNode.depth = _nodes[parent].depth + 1;
+
+		// A move modifies the same liberty counters several times (and the chain of a merged stone can be written twice),
+		// we only keep one entry by value. A move changes a few dozens of values at most, the quadratic search is fine
+		newNode.firstChange = static_cast<unsigned int>(_changes.size());
+		for (const auto& change : changes)
+		{
+			auto existing = _changes.begin() + newNode.firstChange;
+			while (existing != _changes.end() && (existing->type != change.type || existing->key != change.key))
+				++existing;
+
+			if (existing == _changes.end())
+			{
+				_changes.push_back(change);
+			}
+			else
+			{
+				existing->after = change.after;
+				existing->existsAfter = change.existsAfter;
+			}
+		}
+		newNode.nbChanges = static_cast<unsigned int>(_changes.size()) - newNode.firstChange;
+
+		newNode.firstCaptured = static_cast<unsigned int>(_captured.size());
+		newNode.nbCaptured = static_cast<unsigned int>(captured.size());
+		_captured.insert(_captured.end(), captured.begin(), captured.end());
+
+		// New variations go after the existing ones, the first child stays the main line
+		if (_nodes[parent].firstChild == noNode)
+		{
+			_nodes[parent].firstChild = id;
+		}
+		else
+		{
+			NodeID sibling = _nodes[parent].firstChild;
+			while (_nodes[sibling].nextSibling != noNode)
+				sibling = _nodes[sibling].nextSibling;
+			_nodes[sibling].nextSibling = id;
+		}
+
+		return id;
+	}
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <vector>
+#include "Board.h"
+#include "util.h"
+
+namespace logic
+{
+	using NodeID = unsigned int;
+	constexpr NodeID noNode = ~0u;
+
+	// One move of the tree, with everything GameState needs to undo or redo it
+	struct GameTreeNode
+	{
+		NodeID parent = noNode;
+		NodeID firstChild = noNode;
+		NodeID nextSibling = noNode;
+		unsigned int depth = 0;
+
+		// The move itself
+		Player player = Player::BLACK;
+		bool isPass = false;
+		Position pos;
+
+		// Undo record. The board changes and the captured stones are stored in the arrays of the tree, the node only
+		// keeps where its own ones start
+		unsigned int firstChange = 0;
+		unsigned int nbChanges = 0;
+		unsigned int firstCaptured = 0;
+		unsigned int nbCaptured = 0;
+		ChainID nextChainIDBefore = 1;
+		ChainID nextChainIDAfter = 1;
+		unsigned long long int hashBefore = 0;
+		unsigned long long int hashAfter = 0;
+		unsigned int nbConsecutivePassBefore = 0;
+		// Second consecutive pass : redoing it computes the score, undoing it resumes the game
+		bool endsGame = false;
+	};
+
+	// Tree of the moves played during a game, variations included. Playing a move that already exists in the tree
+	// reuses its node, so identical prefixes are only stored once.
+	// Nodes, board changes and captured stones live in three flat arrays : no allocation per node
+	class GameTree
+	{
+		std::vector<GameTreeNode> _nodes;
+		std::vector<BoardChange> _changes;
+		std::vector<Position> _captured;
+		NodeID _current;
+
+	public:
+		GameTree();
+
+		// Keeps only the root (empty board)
+		void clear();
+
+		NodeID getRoot() const { return 0; }
+		NodeID getCurrent() const { return _current; }
+		void setCurrent(NodeID node) { _current = node; }
+		const GameTreeNode& getNode(NodeID node) const { return _nodes[node]; }
+		unsigned int getNbNodes() const { return static_cast<unsigned int>(_nodes.size()); }
+
+		unsigned int getNbChildren(NodeID node) const;
+		// The first child is the main line, the next ones are the variations in the order they were played
+		NodeID getChild(NodeID node, unsigned int variation) const;
+		NodeID findChild(NodeID node, bool isPass, Position pos) const;
+
+		// Adds a move after 'parent'. The changes are compacted : one entry by modified value, with its first 'before'
+		// and its last 'after'
+		NodeID addChild(NodeID parent, const GameTreeNode& node, const std::vector<BoardChange>& changes, const std::vector<Position>& captured);
+
+		const BoardChange* getChangesBegin(const GameTreeNode& node) const { return _changes.data() + node.firstChange; }
+		const BoardChange* getChangesEnd(const GameTreeNode& node) const { return _changes.data() + node.firstChange + node.nbChanges; }
+		const Position* getCapturedBegin(const GameTreeNode& node) const { return _captured.data() + node.firstCaptured; }
+		const Position* getCapturedEnd(const GameTreeNode& node) const { return _captured.data() + node.firstCaptured + node.nbCaptured; }
+	};
+}
@@ -0,0 +1,121 @@
+#include "GameWorker.h"
+
+namespace logic
+{
+	GameWorker::GameWorker(int xDim, int yDim, std::function<void()> onPublish) :
+		_gameState{ xDim, yDim },
+		_onPublish{ std::move(onPublish) },
+		_nbCommands{ 0 },
+		_nbPublished{ 0 },
+		_isStopping{ false }
+	{
+		// The reader gets the initial position before the thread even starts
+		auto& snapshot = _snapshots.getBack();
+		_gameState.fillSnapshot(snapshot);
+		snapshot.sequence = ++_nbPublished;
+		snapshot.deltas.clear();
+		_snapshots.publish();
+		_snapshots.update();
+
+		// A new game empties the board, the deltas before it don't matter anymore
+		_gameState.addListener([this](const BoardDelta& delta) {
+			if (delta.type == BoardDelta::Type::RESET)
+				_pendingDeltas.clear();
+			_pendingDeltas.push_back(delta);
+		});
+
+		_thread = std::thread([this] { run(); });
+	}
+
+	GameWorker::~GameWorker()
+	{
+		stop();
+	}
+
+	void GameWorker::stop()
+	{
+		if (!_thread.joinable())
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_isStopping = true;
+		}
+		_hasCommands.notify_one();
+		_thread.join();
+	}
+
+	void GameWorker::post(Command command, Position pos)
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_commands.push_back({ command, pos });
+		}
+		_hasCommands.notify_one();
+	}
+
+	void GameWorker::run()
+	{
+		PostedCommand command;
+		for (;;)
+		{
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_hasCommands.wait(lock, [this] { return _isStopping || !_commands.empty(); });
+				if (_isStopping)
+					return;
+				command = _commands.front();
+				_commands.pop_front();
+			}
+
+			apply(command);
+
+			// Commands posted while this one was applied are played before publishing : the UI only needs the last state
+			bool hasMoreCommands;
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				hasMoreCommands = !_commands.empty();
+			}
+			if (!hasMoreCommands)
+				publish();
+		}
+	}
+
+	void GameWorker::apply(const PostedCommand& command)
+	{
+		switch (command.command)
+		{
+		case Command::PLACE_STONE:
+			_gameState.putStoneAtPosition(command.pos);
+			break;
+		case Command::PASS:
+			_gameState.pass();
+			break;
+		case Command::NEW_GAME:
+			_gameState.reset();
+			break;
+		case Command::UNDO:
+			_gameState.undo();
+			break;
+		case Command::REDO:
+			_gameState.redo();
+			break;
+		}
+		_nbCommands++;
+	}
+
+	void GameWorker::publish()
+	{
+		auto& snapshot = _snapshots.getBack();
+		_gameState.fillSnapshot(snapshot);
+		snapshot.nbCommands = _nbCommands;
+		snapshot.sequence = ++_nbPublished;
+		// The slot comes back with the deltas of an old snapshot, their vector is reused for the next ones
+		snapshot.deltas.swap(_pendingDeltas);
+		_pendingDeltas.clear();
+		_snapshots.publish();
+
+		if (_onPublish)
+			_onPublish();
+	}
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "GameSnapshot.h"
+#include "GameState.h"
+#include "TripleBuffer.h"
+
+namespace logic
+{
+	// Runs a GameState on its own thread. The UI posts commands, and reads the snapshot published after them : it
+	// never waits for the game, however long a move, the legality checks or the scoring take.
+	// Commands go through a small locked queue (a few per second at most), snapshots through a triple buffer
+	class GameWorker
+	{
+	public:
+		enum class Command : unsigned char
+		{
+			PLACE_STONE,
+			PASS,
+			NEW_GAME,
+			UNDO,
+			REDO
+		};
+
+		// 'onPublish' is called by the logic thread after each new snapshot, to wake the UI up
+		GameWorker(int xDim, int yDim, std::function<void()> onPublish);
+		~GameWorker();
+		GameWorker(const GameWorker&) = delete;
+		GameWorker& operator=(const GameWorker&) = delete;
+
+		void post(Command command, Position pos = {});
+		// Joins the logic thread, the commands not applied yet are dropped. Called by the destructor
+		void stop();
+
+		// Reader side, a single thread. Returns true if a new snapshot was published since the last call
+		bool updateSnapshot() { return _snapshots.update(); }
+		const GameSnapshot& getSnapshot() const { return _snapshots.getFront(); }
+
+	private:
+		struct PostedCommand
+		{
+			Command command;
+			Position pos;
+		};
+
+		void run();
+		void apply(const PostedCommand& command);
+		void publish();
+
+		GameState _gameState;
+		TripleBuffer<GameSnapshot> _snapshots;
+		std::function<void()> _onPublish;
+		unsigned long long int _nbCommands;
+		unsigned long long int _nbPublished;
+		// Deltas of the game since the last published snapshot, only touched by the logic thread
+		std::vector<BoardDelta> _pendingDeltas;
+
+		std::deque<PostedCommand> _commands;
+		bool _isStopping;
+		std::mutex _mutex;
+		std::condition_variable _hasCommands;
+
+		// Last member : the thread starts once everything else is constructed
+		std::thread _thread;
+	};
+}
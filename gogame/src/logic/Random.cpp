@@ -0,0 +1,20 @@
+#include "Random.h"
+#include <atomic>
+
+namespace logic
+{
+	namespace
+	{
+		std::atomic<unsigned long long int> randomSeed{ 0 };
+	}
+
+	void setRandomSeed(unsigned long long int seed)
+	{
+		randomSeed = seed;
+	}
+
+	unsigned long long int getRandomSeed()
+	{
+		return randomSeed;
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+namespace logic
+{
+	// Seed of every random stream of the logic layer : the Zobrist keys, the moves of the self-play games, and the
+	// random games of the tools. 0 unless the program sets it, which it should do at its start : a table already built
+	// keeps the seed it was built with. Two runs with the same seed hash and play the same way
+	void setRandomSeed(unsigned long long int seed);
+	unsigned long long int getRandomSeed();
+
+	// Finalizer of SplitMix64 : a bijection of the 64 bits values, whose outputs look independent even for consecutive
+	// inputs
+	inline unsigned long long int mix64(unsigned long long int x)
+	{
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+		return x ^ (x >> 31);
+	}
+
+	// SplitMix64 used as a counter-based generator : the value n of a stream is mix64(key + (n + 1) * gamma), so any
+	// value can be computed without the ones before it. A table gets the same content whatever the order it's filled
+	// in. Two words of state, a multiplication and a few shifts by value : much cheaper than std::mt19937 to create
+	// and to run. It meets the requirements of the standard distributions, but nextBelow gives the same numbers on
+	// every standard library
+	class CounterRandom
+	{
+		unsigned long long int _key;
+		unsigned long long int _counter;
+
+	public:
+		using result_type = unsigned long long int;
+
+		explicit CounterRandom(unsigned long long int key, unsigned long long int counter = 0) : _key{ key }, _counter{ counter } {}
+
+		// Key of the stream of one use of a seed ('salt' tells the uses apart), two of them don't overlap in practice
+		static unsigned long long int streamKey(unsigned long long int seed, unsigned long long int salt)
+		{
+			return mix64(seed ^ mix64(salt + gamma));
+		}
+
+		static constexpr result_type min() { return 0; }
+		static constexpr result_type max() { return ~0ull; }
+
+		result_type operator()() { return at(_counter++); }
+		result_type at(unsigned long long int index) const { return mix64(_key + (index + 1) * gamma); }
+
+		// Uniform in [0, bound), bound > 0. The values of the first, shorter, range of the modulo are rejected
+		unsigned long long int nextBelow(unsigned long long int bound)
+		{
+			const auto threshold = (0 - bound) % bound;
+			for (;;)
+			{
+				const auto value = (*this)();
+				if (value >= threshold)
+					return value % bound;
+			}
+		}
+
+	private:
+		static constexpr unsigned long long int gamma = 0x9E3779B97F4A7C15ull;
+	};
+}
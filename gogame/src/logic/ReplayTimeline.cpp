@@ -0,0 +1,161 @@
+#include "ReplayTimeline.h"
+#include <algorithm>
+#include <cstdlib>
+#include "GameState.h"
+
+namespace logic
+{
+	ReplayTimeline::ReplayTimeline(const GameRecord& game, int checkpointInterval) :
+		_sizeX{ game.sizeX },
+		_sizeY{ game.sizeY },
+		_checkpointInterval{ std::max(1, checkpointInterval) },
+		_checkpointSize{ (static_cast<size_t>(game.sizeX * game.sizeY) + 3) / 4 }
+	{
+		_moves.reserve(game.moves.size());
+
+		GameState gameState{ _sizeX, _sizeY };
+		// Our own copy of the stones, updated with the deltas like a seek would : the checkpoints are taken from it
+		std::vector<Stone> stones(_sizeX * _sizeY, Stone::NONE);
+		saveCheckpoint(stones);
+
+		unsigned int capturesBlack = 0;
+		unsigned int capturesWhite = 0;
+		for (const auto& move : game.moves)
+		{
+			// Like the diagram tool, a move out of turn is played anyway : we show the stones, whoever played them
+			if (move.player != gameState.getCurrentPlayer())
+				gameState.changePlayer();
+
+			MoveDelta delta;
+			delta.player = move.player;
+			delta.placed = -1;
+			delta.capturedBegin = static_cast<unsigned int>(_captured.size());
+
+			if (move.isPass)
+				gameState.pass();
+			else if (gameState.putStoneAtPosition(move.pos))
+			{
+				const auto& lastDelta = gameState.getLastDelta();
+				delta.placed = lastDelta.placed.x + lastDelta.placed.y * _sizeX;
+				for (const auto& pos : lastDelta.captured)
+					_captured.push_back(static_cast<unsigned short>(pos.x + pos.y * _sizeX));
+
+				const auto nbCaptured = static_cast<unsigned int>(lastDelta.captured.size());
+				if (move.player == Player::BLACK)
+					capturesBlack += nbCaptured;
+				else
+					capturesWhite += nbCaptured;
+			}
+			else
+			{
+				_isTruncated = true;
+				break;
+			}
+
+			delta.capturedEnd = static_cast<unsigned int>(_captured.size());
+			delta.capturesBlack = capturesBlack;
+			delta.capturesWhite = capturesWhite;
+			_moves.push_back(delta);
+
+			redoMove(getNbMoves() - 1, stones);
+			if (getNbMoves() % _checkpointInterval == 0)
+				saveCheckpoint(stones);
+		}
+	}
+
+	Position ReplayTimeline::getLastMove(int moveNumber) const
+	{
+		if (moveNumber <= 0 || moveNumber > getNbMoves() || _moves[moveNumber - 1].placed < 0)
+			return { -1, -1 };
+
+		const auto placed = _moves[moveNumber - 1].placed;
+		return { placed % _sizeX, placed / _sizeX };
+	}
+
+	Player ReplayTimeline::getNextPlayer(int moveNumber) const
+	{
+		if (moveNumber <= 0 || moveNumber > getNbMoves())
+			return Player::BLACK;
+		return opposingPlayer(_moves[moveNumber - 1].player);
+	}
+
+	unsigned int ReplayTimeline::getCapturesBlack(int moveNumber) const
+	{
+		return (moveNumber <= 0 || moveNumber > getNbMoves()) ? 0 : _moves[moveNumber - 1].capturesBlack;
+	}
+
+	unsigned int ReplayTimeline::getCapturesWhite(int moveNumber) const
+	{
+		return (moveNumber <= 0 || moveNumber > getNbMoves()) ? 0 : _moves[moveNumber - 1].capturesWhite;
+	}
+
+	int ReplayTimeline::seek(int fromMove, int toMove, std::vector<Stone>& stones) const
+	{
+		toMove = std::max(0, std::min(toMove, getNbMoves()));
+
+		// Three starting points : the checkpoints before and after the move, and the position we already have
+		const auto checkpointBefore = toMove / _checkpointInterval;
+		int start = checkpointBefore * _checkpointInterval;
+		int checkpoint = checkpointBefore;
+
+		const auto after = start + _checkpointInterval;
+		if (after <= getNbMoves() && after - toMove < toMove - start)
+		{
+			start = after;
+			checkpoint = checkpointBefore + 1;
+		}
+
+		const bool isFromValid = fromMove >= 0 && fromMove <= getNbMoves() && stones.size() == static_cast<size_t>(_sizeX * _sizeY);
+		if (isFromValid && std::abs(toMove - fromMove) <= std::abs(toMove - start))
+			start = fromMove;
+		else
+			restoreCheckpoint(checkpoint, stones);
+
+		for (int move = start; move < toMove; ++move)
+			redoMove(move, stones);
+		for (int move = start - 1; move >= toMove; --move)
+			undoMove(move, stones);
+
+		return std::abs(toMove - start);
+	}
+
+	void ReplayTimeline::saveCheckpoint(const std::vector<Stone>& stones)
+	{
+		const auto offset = _checkpoints.size();
+		_checkpoints.resize(offset + _checkpointSize, 0);
+		for (size_t i = 0; i < stones.size(); ++i)
+			_checkpoints[offset + i / 4] |= static_cast<unsigned char>(static_cast<unsigned int>(stones[i]) << (2 * (i % 4)));
+	}
+
+	void ReplayTimeline::restoreCheckpoint(int index, std::vector<Stone>& stones) const
+	{
+		stones.resize(_sizeX * _sizeY);
+		const auto* packed = _checkpoints.data() + static_cast<size_t>(index) * _checkpointSize;
+		for (size_t i = 0; i < stones.size(); ++i)
+			stones[i] = static_cast<Stone>((packed[i / 4] >> (2 * (i % 4))) & 3);
+	}
+
+	void ReplayTimeline::redoMove(int move, std::vector<Stone>& stones) const
+	{
+		const auto& delta = _moves[move];
+		if (delta.placed < 0)
+			return;
+
+		stones[delta.placed] = playerToStone(delta.player);
+		for (auto i = delta.capturedBegin; i < delta.capturedEnd; ++i)
+			stones[_captured[i]] = Stone::NONE;
+	}
+
+	void ReplayTimeline::undoMove(int move, std::vector<Stone>& stones) const
+	{
+		const auto& delta = _moves[move];
+		if (delta.placed < 0)
+			return;
+
+		// The captured stones were the opponent's
+		const auto capturedStone = playerToStone(opposingPlayer(delta.player));
+		for (auto i = delta.capturedBegin; i < delta.capturedEnd; ++i)
+			stones[_captured[i]] = capturedStone;
+		stones[delta.placed] = Stone::NONE;
+	}
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <vector>
+#include "GameRecord.h"
+
+namespace logic
+{
+	// A recorded game prepared for seeking. The game is replayed once with GameState, and we keep what each move changed
+	// (the stone placed, the stones captured) plus a copy of the board every 'checkpointInterval' moves, packed 4
+	// intersections by byte. Going to any move then starts from the closest of the current position and the two
+	// checkpoints around the move, and plays or undoes the moves in between : fewer than checkpointInterval of them
+	// (half of it before the last checkpoint), whatever the length of the game. Nothing checks the rules again, the
+	// deltas are already legal.
+	// The timeline is immutable, the position shown belongs to the caller
+	class ReplayTimeline
+	{
+	public:
+		static constexpr int defaultCheckpointInterval = 16;
+
+		explicit ReplayTimeline(const GameRecord& game, int checkpointInterval = defaultCheckpointInterval);
+
+		int getDimensionX() const { return _sizeX; }
+		int getDimensionY() const { return _sizeY; }
+		int getCheckpointInterval() const { return _checkpointInterval; }
+		// Moves our rules accepted. The replay stops at the first one they refuse
+		int getNbMoves() const { return static_cast<int>(_moves.size()); }
+		bool isTruncated() const { return _isTruncated; }
+
+		// Last move played in the position after 'moveNumber' moves, (-1, -1) at the start and after a pass
+		Position getLastMove(int moveNumber) const;
+		Player getNextPlayer(int moveNumber) const;
+		// Stones captured by each player, up to that position
+		unsigned int getCapturesBlack(int moveNumber) const;
+		unsigned int getCapturesWhite(int moveNumber) const;
+
+		// Brings 'stones', the position after 'fromMove' moves, to the position after 'toMove' moves. With a 'fromMove'
+		// out of the game or 'stones' of the wrong size, it starts from a checkpoint. Returns the number of moves
+		// played or undone, less than getCheckpointInterval()
+		int seek(int fromMove, int toMove, std::vector<Stone>& stones) const;
+
+	private:
+		struct MoveDelta
+		{
+			Player player;
+			// Intersection index of the stone, -1 for a pass
+			int placed;
+			// Range in _captured
+			unsigned int capturedBegin;
+			unsigned int capturedEnd;
+			// Totals after the move
+			unsigned int capturesBlack;
+			unsigned int capturesWhite;
+		};
+
+		void saveCheckpoint(const std::vector<Stone>& stones);
+		void restoreCheckpoint(int index, std::vector<Stone>& stones) const;
+		void redoMove(int move, std::vector<Stone>& stones) const;
+		void undoMove(int move, std::vector<Stone>& stones) const;
+
+		int _sizeX;
+		int _sizeY;
+		int _checkpointInterval;
+		bool _isTruncated = false;
+
+		std::vector<MoveDelta> _moves;
+		std::vector<unsigned short> _captured;
+		// Checkpoint k is the board after k * _checkpointInterval moves, 2 bits by intersection
+		std::vector<unsigned char> _checkpoints;
+		size_t _checkpointSize;
+	};
+}
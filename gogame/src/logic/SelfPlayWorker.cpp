@@ -0,0 +1,170 @@
+#include "SelfPlayWorker.h"
+#include <algorithm>
+
+namespace logic
+{
+	namespace
+	{
+		// Random players never pass on their own, they would fill their eyes and let the other side capture everything.
+		// A point is an eye here when all its neighbours are stones of the player : crude, but it ends the games
+		bool isEyeOf(const Board& board, Position pos, Stone stone)
+		{
+			const Position neighbours[] = { getNorthPosition(pos), getSouthPosition(pos), getWestPosition(pos), getEastPosition(pos) };
+			for (const auto& neighbour : neighbours)
+			{
+				if (board.isPositionInsideBoard(neighbour) && board.getStoneAt(neighbour) != stone)
+					return false;
+			}
+			return true;
+		}
+
+		// Time a finished game stays on screen with its score
+		constexpr double resultDisplaySeconds = 3.0;
+
+		// Tells the stream of the self-play moves apart from the other uses of the seed
+		constexpr unsigned long long int selfPlaySalt = 1;
+	}
+
+	SelfPlayWorker::SelfPlayWorker(int nbGames, int xDim, int yDim, double movesPerSecond, std::function<void()> onPublish) :
+		_random{ CounterRandom::streamKey(getRandomSeed(), selfPlaySalt) },
+		_onPublish{ std::move(onPublish) },
+		_tickInterval{ 1.0 / std::max(movesPerSecond, 0.1) },
+		_nbTicksShowingResult{ static_cast<unsigned int>(std::max(1.0, resultDisplaySeconds * movesPerSecond)) },
+		_isStopping{ false }
+	{
+		_games.reserve(nbGames);
+		for (int i = 0; i < nbGames; ++i)
+			_games.emplace_back(xDim, yDim);
+		_candidates.reserve(xDim * yDim);
+
+		// The reader gets the empty boards before the thread even starts
+		publish();
+		_summaries.update();
+
+		_thread = std::thread([this] { run(); });
+	}
+
+	SelfPlayWorker::~SelfPlayWorker()
+	{
+		stop();
+	}
+
+	void SelfPlayWorker::stop()
+	{
+		if (!_thread.joinable())
+			return;
+
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_isStopping = true;
+		}
+		_stopRequested.notify_one();
+		_thread.join();
+	}
+
+	void SelfPlayWorker::run()
+	{
+		auto nextTick = std::chrono::steady_clock::now();
+		for (;;)
+		{
+			nextTick += std::chrono::duration_cast<std::chrono::steady_clock::duration>(_tickInterval);
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				if (_stopRequested.wait_until(lock, nextTick, [this] { return _isStopping; }))
+					return;
+			}
+
+			for (auto& game : _games)
+				playMove(game);
+			publish();
+
+			// A slow tick doesn't make the next ones catch up
+			nextTick = std::max(nextTick, std::chrono::steady_clock::now() - std::chrono::duration_cast<std::chrono::steady_clock::duration>(_tickInterval));
+		}
+	}
+
+	void SelfPlayWorker::playMove(Game& game)
+	{
+		auto& state = game.state;
+		if (state.isGameOver())
+		{
+			if (game.nbTicksBeforeReset > 0)
+			{
+				game.nbTicksBeforeReset--;
+				return;
+			}
+
+			state.reset();
+			game.lastMove = { -1, -1 };
+			game.nbMoves = 0;
+			game.version++;
+			return;
+		}
+
+		const auto& board = state.getBoard();
+		const auto stone = playerToStone(state.getCurrentPlayer());
+
+		// Random games can last a long time when captures keep emptying the board, they're cut at some point
+		const bool isTooLong = game.nbMoves >= static_cast<unsigned int>(3 * board.getDimensionX() * board.getDimensionY());
+
+		_candidates.clear();
+		for (int y = 0; y < board.getDimensionY() && !isTooLong; ++y)
+		{
+			for (int x = 0; x < board.getDimensionX(); ++x)
+			{
+				if (board.getStoneAt({ x, y }) == Stone::NONE && !isEyeOf(board, { x, y }, stone))
+					_candidates.push_back({ x, y });
+			}
+		}
+
+		// putStoneAtPosition checks the move itself, the illegal ones are dropped until one is played
+		bool isPlayed = false;
+		while (!_candidates.empty() && !isPlayed)
+		{
+			const auto index = static_cast<size_t>(_random.nextBelow(_candidates.size()));
+			const auto pos = _candidates[index];
+
+			isPlayed = state.putStoneAtPosition(pos);
+			if (isPlayed)
+				game.lastMove = pos;
+
+			_candidates[index] = _candidates.back();
+			_candidates.pop_back();
+		}
+
+		if (!isPlayed)
+		{
+			state.pass();
+			game.lastMove = { -1, -1 };
+			if (state.isGameOver())
+				game.nbTicksBeforeReset = _nbTicksShowingResult;
+		}
+
+		game.nbMoves++;
+		game.version++;
+	}
+
+	void SelfPlayWorker::publish()
+	{
+		// The back buffer holds the games of two ticks ago, everything is written again
+		auto& summaries = _summaries.getBack();
+		summaries.resize(_games.size());
+		for (size_t i = 0; i < _games.size(); ++i)
+		{
+			const auto& game = _games[i];
+			auto& summary = summaries[i];
+			summary.stones = game.state.getBoard().getStoneBoard();
+			summary.lastMove = game.lastMove;
+			summary.currentPlayer = game.state.getCurrentPlayer();
+			summary.scoreBlack = game.state.getScoreBlack();
+			summary.scoreWhite = game.state.getScoreWhite();
+			summary.nbMoves = game.nbMoves;
+			summary.isGameOver = game.state.isGameOver();
+			summary.version = game.version;
+		}
+		_summaries.publish();
+
+		if (_onPublish)
+			_onPublish();
+	}
+}
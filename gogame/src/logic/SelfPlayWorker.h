@@ -0,0 +1,84 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "GameState.h"
+#include "Random.h"
+#include "TripleBuffer.h"
+
+namespace logic
+{
+	// What a spectator shows of one game. Much smaller than a GameSnapshot : no legality check to compute or copy
+	struct GameSummary
+	{
+		std::vector<Stone> stones;
+		// (-1, -1) at the start of a game and after a pass
+		Position lastMove{ -1, -1 };
+		Player currentPlayer = Player::BLACK;
+		unsigned int scoreBlack = 0;
+		unsigned int scoreWhite = 0;
+		unsigned int nbMoves = 0;
+		bool isGameOver = false;
+		// Changes with every move of the game : a reader compares it to skip the games it already shows
+		unsigned long long int version = 0;
+	};
+
+	// Plays many games at once on a thread of its own, for the monitor view. At each tick every game plays one move :
+	// a random legal move which doesn't fill an eye of the player, or a pass if there's none left. A finished game stays
+	// as it is for a few seconds, then starts again.
+	// The games are published all together through a triple buffer, like the snapshots of GameWorker
+	class SelfPlayWorker
+	{
+	public:
+		// 'onPublish' is called by the logic thread after each tick, to wake the UI up
+		SelfPlayWorker(int nbGames, int xDim, int yDim, double movesPerSecond, std::function<void()> onPublish);
+		~SelfPlayWorker();
+		SelfPlayWorker(const SelfPlayWorker&) = delete;
+		SelfPlayWorker& operator=(const SelfPlayWorker&) = delete;
+
+		// Joins the logic thread. Called by the destructor
+		void stop();
+
+		// Reader side, a single thread. Returns true if a new tick was published since the last call
+		bool updateSnapshot() { return _summaries.update(); }
+		const std::vector<GameSummary>& getSnapshot() const { return _summaries.getFront(); }
+
+	private:
+		struct Game
+		{
+			GameState state;
+			Position lastMove;
+			unsigned int nbMoves;
+			// Ticks left before a finished game starts again
+			unsigned int nbTicksBeforeReset;
+			unsigned long long int version;
+
+			Game(int xDim, int yDim) : state{ xDim, yDim }, lastMove{ -1, -1 }, nbMoves{ 0 }, nbTicksBeforeReset{ 0 }, version{ 0 } {}
+		};
+
+		void run();
+		void playMove(Game& game);
+		void publish();
+
+		std::vector<Game> _games;
+		// Seeded with the seed of the logic layer : the same seed plays the same games
+		CounterRandom _random;
+		// Reused by playMove, the empty points where the player may play
+		std::vector<Position> _candidates;
+
+		TripleBuffer<std::vector<GameSummary>> _summaries;
+		std::function<void()> _onPublish;
+		std::chrono::duration<double> _tickInterval;
+		unsigned int _nbTicksShowingResult;
+
+		bool _isStopping;
+		std::mutex _mutex;
+		std::condition_variable _stopRequested;
+
+		// Last member : the thread starts once everything else is constructed
+		std::thread _thread;
+	};
+}
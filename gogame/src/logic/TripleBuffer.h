@@ -0,0 +1,44 @@
+#pragma once
+#include <atomic>
+
+namespace logic
+{
+	// Single writer, single reader exchange of the latest value, without lock and without waiting. Each side owns a
+	// slot, the third one is in between : the writer fills its slot and swaps it with the middle one, the reader swaps
+	// its slot with the middle one when it holds a newer value. Values published faster than they're read are dropped.
+	// The writer gets back a slot holding an old value, it must overwrite all of it
+	template <typename T>
+	class TripleBuffer
+	{
+		static constexpr unsigned int indexMask = 3;
+		static constexpr unsigned int freshBit = 4;
+
+		T _slots[3];
+		unsigned int _back;
+		unsigned int _front;
+		// Index of the middle slot, with freshBit set when it holds a value the reader hasn't taken yet
+		std::atomic<unsigned int> _middle;
+
+	public:
+		TripleBuffer() : _back{ 0 }, _front{ 1 }, _middle{ 2 } {}
+		TripleBuffer(const TripleBuffer&) = delete;
+		TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+		// Writer side
+		T& getBack() { return _slots[_back]; }
+		void publish()
+		{
+			_back = _middle.exchange(_back | freshBit, std::memory_order_acq_rel) & indexMask;
+		}
+
+		// Reader side. Returns true if a newer value was published since the last call
+		bool update()
+		{
+			if ((_middle.load(std::memory_order_relaxed) & freshBit) == 0)
+				return false;
+			_front = _middle.exchange(_front, std::memory_order_acq_rel) & indexMask;
+			return true;
+		}
+		const T& getFront() const { return _slots[_front]; }
+	};
+}
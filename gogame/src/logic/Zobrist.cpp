@@ -0,0 +1,53 @@
+#include "Zobrist.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include "Random.h"
+
+namespace logic
+{
+	ZobristTable::ZobristTable(int sizeX, int sizeY, unsigned long long int seed) :
+		_keys(sizeX * sizeY)
+	{
+		// The dimensions are mixed in the stream, so two board sizes don't share their keys. Key k is the value k of the
+		// stream : it doesn't depend on the order they're computed in
+		const CounterRandom random{ CounterRandom::streamKey(seed, (static_cast<unsigned long long int>(sizeX) << 32) ^ static_cast<unsigned long long int>(sizeY)) };
+		for (size_t i = 0; i < _keys.size(); ++i)
+		{
+			_keys[i][0] = random.at(2 * i);
+			_keys[i][1] = random.at(2 * i + 1);
+		}
+	}
+
+	const ZobristTable& ZobristTable::forBoard(int sizeX, int sizeY)
+	{
+		return forBoard(sizeX, sizeY, getRandomSeed());
+	}
+
+	const ZobristTable& ZobristTable::forBoard(int sizeX, int sizeY, unsigned long long int seed)
+	{
+		static std::mutex mutex;
+		static std::map<std::tuple<int, int, unsigned long long int>, std::unique_ptr<ZobristTable>> tables;
+
+		std::lock_guard<std::mutex> lock(mutex);
+		auto& table = tables[std::make_tuple(sizeX, sizeY, seed)];
+		if (!table)
+			table.reset(new ZobristTable(sizeX, sizeY, seed));
+		return *table;
+	}
+
+	// Computes the hash value of a given board
+	// Acconrding to Google, we don't actually need to recompute the hash for the whole board, but only with XOR of specific
+	// positions that changed. Might give it a try if I have some time
+	unsigned long long int ZobristTable::computeHash(const std::vector<Stone>& stoneBoard) const
+	{
+		unsigned long long int h = 0;
+		for (size_t i = 0; i < _keys.size(); i++)
+		{
+			if (stoneBoard[i] != Stone::NONE)
+				h ^= getKey(static_cast<int>(i), stoneBoard[i]);
+		}
+		return h;
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <array>
+#include <vector>
+#include "util.h"
+
+namespace logic
+{
+	// Random keys used to hash a board (one key by position and stone color).
+	// The keys only depend on the board dimensions and on the seed, so there's one immutable table by board size and
+	// seed, created the first time it's asked for and shared by every GameState. With the same seed (see setRandomSeed),
+	// hashes are the same from one run to another
+	class ZobristTable
+	{
+		// One pair of keys (black, white) by position of the board
+		std::vector<std::array<unsigned long long int, 2>> _keys;
+
+		ZobristTable(int sizeX, int sizeY, unsigned long long int seed);
+
+	public:
+		ZobristTable(const ZobristTable&) = delete;
+		ZobristTable& operator=(const ZobristTable&) = delete;
+
+		// Thread safe. The returned table lives until the end of the program. The first one uses the seed of the logic layer
+		static const ZobristTable& forBoard(int sizeX, int sizeY);
+		static const ZobristTable& forBoard(int sizeX, int sizeY, unsigned long long int seed);
+
+		unsigned long long int getKey(int i, Stone stone) const { return _keys[i][static_cast<int>(stone)]; }
+		unsigned long long int computeHash(const std::vector<Stone>& stoneBoard) const;
+	};
+}
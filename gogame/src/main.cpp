@@ -1,7 +1,9 @@
-
+#include <algorithm>
+#include <chrono>
 #include <iostream>
-#include <cmath>
+#include <string>
 #include <stdexcept>
+#include <vector>
 
 #include <GL/glew.h>
 
@@ -11,37 +13,113 @@
 #define NANOVG_GL3_IMPLEMENTATION
 #include <nanovg.h>
 #include <nanovg_gl.h>
-
+#include <nanovg_gl_utils.h>
+
+#include "BoardSync.h"
+#include "EmbeddedFonts.h"
+#include "FrameLoop.h"
+#include "MonitorMode.h"
+#include "ReplayMode.h"
+#include "render/FrameProfiler.h"
 #include "render/GoModel.h"
-#include "logic\GameState.h"
+#include "render/Layout.h"
+#include "render/ShapeCache.h"
+#include "render/StoneLayer.h"
+#include "logic\GameRecord.h"
+#include "logic\GameWorker.h"
+#include "logic\Random.h"
+
+struct LoopOptions
+{
+	FrameLoopOptions loop;
+	// Empty for no CSV
+	std::string profileFile;
+	// With boards, the window shows that many self-play games instead of a game to play
+	int nbMonitorBoards = 0;
+	int monitorBoardSize = 19;
+	double monitorMovesPerSecond = 4.0;
+	// With a SGF file, the window replays its games instead
+	std::string replayFile;
+	// Seed of the Zobrist keys and of the self-play moves : the same seed plays the same games
+	unsigned long long seed = 0;
+	// nanovg uploads through orphaned buffers instead of the persistent mapped ring, to compare the two
+	bool noPersistentBuffers = false;
+};
 
-struct GameEvents
+// A game command is shown with the snapshot the logic thread publishes after it : its input is kept until then
+struct CommandLatency
 {
-	bool addStone = false;
-	bool pass = false;
-	bool newGame = false;
-	std::pair<int, int> pick = { -1, -1 };
-
-	void reset() { newGame = false; addStone = false; pass = false; pick = { -1, -1 }; }
-	bool fired() const { return (newGame || addStone || pass); }
-	bool pickChanged(std::pair<int, int> newPick) const { return newPick != pick; }
+	// Earliest input waiting for the logic thread, in glfw time. -1 if none
+	double inputTime = -1.0;
+	unsigned long long int nbPostedCommands = 0;
+
+	void onPosted(double time)
+	{
+		nbPostedCommands++;
+		if (inputTime < 0.0)
+			inputTime = time;
+	}
 };
 
-static GameEvents events;
 static render::Player player = render::Player::Black;
+static bool showIllegalPoints = false;
+static std::pair<int, int> shownPick = { -1, -1 };
+// Sequence number of the game snapshot the render model shows
+static unsigned long long int shownSnapshot = 0;
+static CommandLatency commandLatency;
 
-void mouse_button_callback(GLFWwindow*, int button, int action, int /*mods*/)
+void printUsage()
 {
-	if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS)
-		events.addStone = true;
+	std::cerr << "Usage: gogame [options]\n"
+		<< "  --swap-interval <n>   vertical blanks between presents, 0 disables vsync (default 1)\n"
+		<< "  --max-fps <n>         caps the frame rate\n"
+		<< "  --finish              waits for the GPU after each present\n"
+		<< "  --latency             shows the input-to-present latency ([L] toggles it), in every mode\n"
+		<< "  --profile [file.csv]  shows the frame profiler ([P] toggles it), and writes the time of each frame\n"
+		<< "  --monitor <n>         watches n self-play games instead of playing one\n"
+		<< "  --monitor-size <n>    board size of the watched games (default 19)\n"
+		<< "  --monitor-rate <n>    moves per second of each watched game (default 4)\n"
+		<< "  --replay <file.sgf>   replays the games of the file, with a move slider\n"
+		<< "  --seed <n>            seed of the hashes and of the self-play games (default 0)\n"
+		<< "  --no-persistent-buffers  nanovg orphans its buffers instead of writing in a persistent mapped ring\n";
 }
 
-void key_callback(GLFWwindow*, int key, int /*scancode*/, int action, int /*mods*/)
+LoopOptions parseOptions(int argc, char** argv)
 {
-	if (key == GLFW_KEY_SPACE && action == GLFW_PRESS)
-		events.pass = true;
-	else 	if (key == GLFW_KEY_N && action == GLFW_PRESS)
-		events.newGame = true;
+	LoopOptions options;
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+		if (arg == "--swap-interval" && i + 1 < argc)
+			options.loop.swapInterval = std::max(0, std::stoi(argv[++i]));
+		else if (arg == "--max-fps" && i + 1 < argc)
+			options.loop.maxFps = std::max(0.0, std::stod(argv[++i]));
+		else if (arg == "--finish")
+			options.loop.finishAfterSwap = true;
+		else if (arg == "--latency")
+			options.loop.showLatency = true;
+		else if (arg == "--profile")
+		{
+			options.loop.showProfiler = true;
+			if (i + 1 < argc && argv[i + 1][0] != '-')
+				options.profileFile = argv[++i];
+		}
+		else if (arg == "--monitor" && i + 1 < argc)
+			options.nbMonitorBoards = std::max(0, std::stoi(argv[++i]));
+		else if (arg == "--monitor-size" && i + 1 < argc)
+			options.monitorBoardSize = std::max(2, std::stoi(argv[++i]));
+		else if (arg == "--monitor-rate" && i + 1 < argc)
+			options.monitorMovesPerSecond = std::max(0.1, std::stod(argv[++i]));
+		else if (arg == "--replay" && i + 1 < argc)
+			options.replayFile = argv[++i];
+		else if (arg == "--seed" && i + 1 < argc)
+			options.seed = std::stoull(argv[++i]);
+		else if (arg == "--no-persistent-buffers")
+			options.noPersistentBuffers = true;
+		else
+			throw std::runtime_error("Unknown option " + arg);
+	}
+	return options;
 }
 
 GLFWwindow* initGlfw()
@@ -65,161 +143,316 @@ GLFWwindow* initGlfw()
 	// GLEW generates GL error because it calls glGetString(GL_EXTENSIONS), we'll consume it here.
 	glGetError();
 
-	glfwSetMouseButtonCallback(window, mouse_button_callback);
-	glfwSetKeyCallback(window, key_callback);
-
 	return window;
 }
 
-NVGcontext* initNanoVg()
+NVGcontext* initNanoVg(bool noPersistentBuffers)
 {
-	auto vg = nvgCreateGL3(NVG_ANTIALIAS | NVG_STENCIL_STROKES | NVG_DEBUG);
+	auto flags = NVG_ANTIALIAS | NVG_STENCIL_STROKES | NVG_DEBUG | NVG_SDF_TEXT;
+	if (noPersistentBuffers)
+		flags |= NVG_NO_PERSISTENT_BUFFERS;
+	auto vg = nvgCreateGL3(flags);
 	if (nullptr == vg)
 		throw std::runtime_error("Could not init nanovg.\n");
 
-	auto fontNormal = nvgCreateFont(vg, "sans", "font/Roboto-Regular.ttf");
-	if (-1 == fontNormal)
-		throw std::runtime_error("Could not init nanovg font.\n");
-
-	auto fontBold = nvgCreateFont(vg, "bold", "font/Roboto-Bold.ttf");
-	if (-1 == fontBold)
-		throw std::runtime_error("Could not init nanovg font.\n");
+	// The text fonts are in the executable, with their ASCII glyphs already rasterized
+	for (unsigned int i = 0; i < fonts::nbEmbeddedFonts; ++i)
+	{
+		const auto& embedded = fonts::embeddedFonts[i];
+		auto font = nvgCreateFontMem(vg, embedded.name, const_cast<unsigned char*>(embedded.data), int(embedded.dataSize), 0);
+		if (-1 == font)
+			throw std::runtime_error("Could not init nanovg font.\n");
+
+		// When the atlas is full, the glyphs left out are rasterized on demand like the other characters
+		unsigned int nbAdded = 0;
+		for (unsigned int j = 0; j < embedded.nbGlyphs; ++j)
+		{
+			const auto& glyph = embedded.glyphs[j];
+			if (nvgAddBakedGlyph(vg, font, glyph.codepoint, glyph.size10, glyph.width, glyph.height,
+				glyph.xadv10, glyph.xoff, glyph.yoff, embedded.pixels + glyph.pixelOffset))
+				++nbAdded;
+		}
+		if (nbAdded < embedded.nbGlyphs)
+			std::cerr << "Font atlas full, " << (embedded.nbGlyphs - nbAdded) << " of the " << embedded.nbGlyphs
+				<< " baked glyphs of '" << embedded.name << "' are not preloaded" << std::endl;
+	}
 
-	auto fontEmoji = nvgCreateFont(vg, "emoji", "font/NotoEmoji-Regular.ttf");
-	if (-1 == fontEmoji)
-		throw std::runtime_error("Could not init nanovg font.\n");
+	// The emoji font is big and almost never needed : it's only read from disk the first time a character
+	// is missing from the text fonts
+	nvgSetMissingGlyphCallback(vg, [](void* uptr, int, unsigned int) {
+		static bool isLoaded = false;
+		if (isLoaded)
+			return;
+		isLoaded = true;
+
+		auto vg = static_cast<NVGcontext*>(uptr);
+		auto fontEmoji = nvgCreateFont(vg, "emoji", "font/NotoEmoji-Regular.ttf");
+		if (-1 == fontEmoji)
+		{
+			std::cerr << "Could not load the emoji font" << std::endl;
+			return;
+		}
 
-	nvgAddFallbackFontId(vg, fontNormal, fontEmoji);
-	nvgAddFallbackFontId(vg, fontBold, fontEmoji);
+		nvgAddFallbackFontId(vg, nvgFindFont(vg, "sans"), fontEmoji);
+		nvgAddFallbackFontId(vg, nvgFindFont(vg, "bold"), fontEmoji);
+	}, vg);
 
 	return vg;
 }
 
-void processPickEvent(std::pair<int, int> pick, render::GoModel& renderModel, logic::GameState& gameState)
+void processPickEvent(std::pair<int, int> pick, render::GoModel& renderModel, const logic::GameSnapshot& snapshot)
 {
-	events.pick = pick;
+	shownPick = pick;
 	renderModel.board.setPickedPosition(pick.first, pick.second);
 
 	if (pick.first < 0 || pick.second < 0)
+	{
+		renderModel.infos.setMessage(snapshot.message);
 		return;
+	}
 
-	if (gameState.precomputeStonePlacement({ pick.first, pick.second }))
+	// The logic thread computed the legality of every point with the snapshot, hovering only reads it
+	if (snapshot.isLegalMove({ pick.first, pick.second }))
 		renderModel.board.setPickColor(player == render::Player::White ? render::PickColor::White : render::PickColor::Black);
 	else
 		renderModel.board.setPickColor(render::PickColor::Red);
-}
 
-void changePlayer(render::GoModel& renderModel, logic::GameState& gameState)
-{
-	using render::Player;
-	player = (gameState.getCurrentPlayer() == logic::Player::BLACK) ? render::Player::Black : render::Player::White;
-	renderModel.infos.setPlayer(player);
+	renderModel.infos.setMessage(snapshot.getMoveMessage({ pick.first, pick.second }));
 }
 
-void retrieveStones(render::GoModel& renderModel, logic::GameState& gameState)
+void updateIllegalPoints(render::GoModel& renderModel, const logic::GameSnapshot& snapshot)
 {
-	renderModel.stones.clear();
+	if (!showIllegalPoints)
+	{
+		renderModel.board.setIllegalPoints({});
+		return;
+	}
 
-	auto dimX = gameState.getBoardDimensionX();
-	auto dimY = gameState.getBoardDimensionY();
-	const auto& board = gameState.getBoard();
-	for (int y = 0; y < dimY; ++y)
+	// Occupied points are obviously illegal, only the empty ones are shown
+	std::vector<bool> illegalPoints(snapshot.dimX * snapshot.dimY, false);
+	for (int y = 0; y < snapshot.dimY; ++y)
 	{
-		for (int x = 0; x < dimX; ++x)
+		for (int x = 0; x < snapshot.dimX; ++x)
 		{
-			auto stoneColor = board.getStoneAt({ x, y });
-			if (stoneColor != logic::Stone::NONE)
-			{
-				renderModel.stones.emplace_back(x, y, (stoneColor == logic::Stone::BLACK) ? render::Player::Black : render::Player::White);
-			}
+			if (snapshot.getStoneAt({ x, y }) == logic::Stone::NONE)
+				illegalPoints[x + y * snapshot.dimX] = !snapshot.isLegalMove({ x, y });
 		}
 	}
+	renderModel.board.setIllegalPoints(std::move(illegalPoints));
+}
+
+void changePlayer(render::GoModel& renderModel, const logic::GameSnapshot& snapshot)
+{
+	player = (snapshot.currentPlayer == logic::Player::BLACK) ? render::Player::Black : render::Player::White;
+	renderModel.infos.setPlayer(player);
 }
 
-void processEvents(std::pair<int, int> pick, render::GoModel& renderModel, logic::GameState& gameState)
+// Brings the render model to a new snapshot of the game. When it follows the one shown, only its deltas are applied.
+// Snapshots published while the previous one was shown are skipped though, the stones are then compared with the
+// whole board
+void applySnapshot(const logic::GameSnapshot& snapshot, render::GoModel& renderModel)
 {
-	if (events.pickChanged(pick))
+	if (shownSnapshot != 0 && snapshot.sequence == shownSnapshot + 1)
 	{
-		processPickEvent(pick, renderModel, gameState);
-		renderModel.infos.setMessage(gameState.getMessage());
+		for (const auto& delta : snapshot.deltas)
+			applyBoardDelta(delta, renderModel.stones);
 	}
+	else
+		syncStones(snapshot.stones, snapshot.dimX, snapshot.dimY, renderModel.stones);
+	shownSnapshot = snapshot.sequence;
 
-	if (!events.fired())
-		return;
+	changePlayer(renderModel, snapshot);
+	updateIllegalPoints(renderModel, snapshot);
+	renderModel.infos.setScore(snapshot.scoreBlack, snapshot.scoreWhite);
+	renderModel.infos.setMessage(snapshot.message);
+}
 
-	auto firedEvent = events;
-	events.reset();
+// Returns what changed in the render model, and the input it shows
+SceneUpdate processEvents(const FrameInput& input, std::pair<int, int> pick, render::GoModel& renderModel, logic::GameWorker& game)
+{
+	SceneUpdate update;
 
-	if (firedEvent.addStone && pick.first >= 0 && pick.second >= 0)
+	const bool hasNewSnapshot = game.updateSnapshot();
+	const auto& snapshot = game.getSnapshot();
+	if (hasNewSnapshot)
 	{
-		if (gameState.putStoneAtPosition({ pick.first, pick.second }))
+		applySnapshot(snapshot, renderModel);
+		if (snapshot.nbCommands >= commandLatency.nbPostedCommands)
 		{
-			renderModel.stones.emplace_back(pick.first, pick.second, player);
-			changePlayer(renderModel, gameState);
-			retrieveStones(renderModel, gameState);
+			update.show(commandLatency.inputTime);
+			commandLatency.inputTime = -1.0;
 		}
+		else
+			update.show(-1.0);
+	}
+
+	// The legal moves change with the snapshot, the pick is colored again
+	const bool hasPickChanged = (pick != shownPick);
+	if (hasNewSnapshot || hasPickChanged)
+	{
+		processPickEvent(pick, renderModel, snapshot);
+		update.show(hasPickChanged ? input.inputTime : -1.0);
+	}
+
+	const auto& events = input.game;
+	if (!events.fired())
+		return update;
+
+	// The game commands are played by the logic thread, they show up with the snapshot it publishes after them :
+	// posting one changes nothing to draw yet
+	if (events.addStone && pick.first >= 0 && pick.second >= 0)
+	{
+		game.post(logic::GameWorker::Command::PLACE_STONE, { pick.first, pick.second });
+		commandLatency.onPosted(input.inputTime);
+	}
+	else if (events.pass)
+	{
+		game.post(logic::GameWorker::Command::PASS);
+		commandLatency.onPosted(input.inputTime);
+	}
+	else if (events.newGame)
+	{
+		game.post(logic::GameWorker::Command::NEW_GAME);
+		commandLatency.onPosted(input.inputTime);
+	}
+	else if (events.undo)
+	{
+		game.post(logic::GameWorker::Command::UNDO);
+		commandLatency.onPosted(input.inputTime);
 	}
-	else if (firedEvent.pass)
+	else if (events.redo)
 	{
-		gameState.pass();
-		changePlayer(renderModel, gameState);
+		game.post(logic::GameWorker::Command::REDO);
+		commandLatency.onPosted(input.inputTime);
 	}
-	else if (firedEvent.newGame)
+	else if (events.toggleIllegalPoints)
 	{
-		gameState.reset();
-		changePlayer(renderModel, gameState);
-		retrieveStones(renderModel, gameState);
+		showIllegalPoints = !showIllegalPoints;
+		updateIllegalPoints(renderModel, snapshot);
+		update.show(input.inputTime);
 	}
 
-	renderModel.infos.setScore(gameState.getScoreBlack(), gameState.getScoreWhite());
-	renderModel.infos.setMessage(gameState.getMessage());
+	return update;
 }
 
-int main(void)
+// The game to play. It runs on its own thread, and wakes the loop up when it publishes a new snapshot
+class GameScene : public FrameScene
 {
-	auto window = initGlfw();
-	auto vg = initNanoVg();
+public:
+	GameScene(NVGcontext& vg, int boardWidth, int boardHeight, render::ShapeCache& shapeCache)
+		: _context(vg, boardWidth, boardHeight), _model(_context), _game{ boardWidth, boardHeight, [] { glfwPostEmptyEvent(); } }
+	{
+		_context.setShapeCache(&shapeCache);
+		applySnapshot(_game.getSnapshot(), _model);
+
+		// Stones are drawn with instancing when the context allows it, with nanovg otherwise
+		if (!_stoneLayer.init())
+			std::cout << "Instanced stone layer unavailable, stones are drawn with nanovg" << std::endl;
+	}
+
+	std::pair<int, int> getBoardSize() const override { return std::make_pair(_context.boardWidth(), _context.boardHeight()); }
 
-	constexpr int boardWidth = 9;
-	constexpr int boardHeight = 9;
+	void setLayout(const render::Layout& layout) override
+	{
+		_context.setSquareSize(layout.squareSize());
+		render::invalidate(_model);
+	}
 
-	render::DrawContext context(*vg, boardWidth, boardHeight);
-	render::GoModel renderModel(context);
-	logic::GameState gameState{ boardWidth , boardHeight };
+	// The events may have moved the cursor or resized the window, the pick is computed after them
+	SceneUpdate update(const FrameInput& input, const render::Layout& layout) override
+	{
+		return processEvents(input, layout.pick(input.cursorX, input.cursorY), _model, _game);
+	}
 
-	// Loop until the user closes the window
-	int winWidth, winHeight;
-	double mx, my;
-	int fbWidth, fbHeight;
+	void prepare(float pxRatio) override { render::prepare(_model, pxRatio); }
+	void draw(const render::Layout& layout) override { render::draw(_model, layout, _stoneLayer.isValid() ? &_stoneLayer : nullptr); }
+	void drawAfterFlush(const render::Layout& layout) override { _stoneLayer.draw(layout.winWidth(), layout.winHeight()); }
 
-	while (!glfwWindowShouldClose(window))
+	// Under the Informations panel
+	std::pair<float, float> getOverlayOrigin(const render::Layout& layout) const override
 	{
-		glfwGetWindowSize(window, &winWidth, &winHeight);
-		glfwGetCursorPos(window, &mx, &my);
-		glfwGetFramebufferSize(window, &fbWidth, &fbHeight);
+		const auto panel = layout.sidePanelOrigin();
+		return std::make_pair(panel.first, panel.second + render::Informations::height() + 10.f);
+	}
+	std::string getTitle() const override { return "Nanovg"; }
 
-		context.setSquareSize(render::squareSizeFromCanvasSize(winWidth, winHeight, context));
-		auto pick = render::squarePosFromScreenPos(int(std::floor(mx)), int(std::floor(my)), context);
+	// The logic thread wakes glfw up, it must be stopped before glfwTerminate
+	void release()
+	{
+		_game.stop();
+		render::release(_model);
+		_stoneLayer.release();
+	}
 
-		// Update and render
-		glViewport(0, 0, fbWidth, fbHeight);
-		glClearColor(0.3f, 0.3f, 0.32f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT);
+private:
+	render::DrawContext _context;
+	render::GoModel _model;
+	logic::GameWorker _game;
+	render::StoneLayer _stoneLayer;
+};
 
-		// Calculate pixel ration for hi-dpi devices.
-		auto pxRatio = float(fbWidth) / float(winWidth);
+int main(int argc, char** argv)
+{
+	// The startup is measured from here to the first presented frame
+	const auto mainStart = std::chrono::steady_clock::now();
 
-		nvgBeginFrame(vg, winWidth, winHeight, pxRatio);
-		render::draw(renderModel);
-		nvgEndFrame(vg);
+	LoopOptions options;
+	try
+	{
+		options = parseOptions(argc, argv);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		printUsage();
+		return 1;
+	}
+	options.loop.mainStart = mainStart;
+	// Before any game : the tables keep the seed they're built with
+	logic::setRandomSeed(options.seed);
 
-		glfwSwapBuffers(window);
+	// Read before the window is created : a file which can't be replayed doesn't open it
+	std::vector<logic::GameRecord> replayGames;
+	if (!options.replayFile.empty())
+	{
+		try
+		{
+			replayGames = loadReplayGames(options.replayFile);
+		}
+		catch (const std::exception& e)
+		{
+			std::cerr << e.what() << std::endl;
+			return 1;
+		}
+	}
 
-		glfwPollEvents();
-		processEvents(pick, renderModel, gameState);
+	auto window = initGlfw();
+	glfwSwapInterval(options.loop.swapInterval);
+	auto vg = initNanoVg(options.noPersistentBuffers);
+
+	// Circles and rounded rectangles are tessellated once per size, then replayed
+	render::ShapeCache shapeCache;
+
+	// Always measuring, the overlay only shows it
+	render::FrameProfiler profiler;
+	profiler.init();
+	if (!options.profileFile.empty() && !profiler.openCsv(options.profileFile))
+		std::cerr << "Can't open " << options.profileFile << " for writing" << std::endl;
+
+	if (options.nbMonitorBoards > 0)
+		runMonitor(window, *vg, options.loop, options.nbMonitorBoards, options.monitorBoardSize, options.monitorMovesPerSecond, shapeCache, profiler);
+	else if (!replayGames.empty())
+		runReplay(window, *vg, options.loop, replayGames, shapeCache, profiler);
+	else
+	{
+		GameScene game(*vg, 9, 9, shapeCache);
+		runFrameLoop(window, *vg, options.loop, profiler, game);
+		game.release();
 	}
 
+	std::cout << "Shape cache: " << shapeCache.nbReplays() << " fills from " << shapeCache.nbTessellations() << " tessellations" << std::endl;
+
+	profiler.release();
 	glfwTerminate();
 	return 0;
-
-}
\ No newline at end of file
+}
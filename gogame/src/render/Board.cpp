@@ -5,6 +5,7 @@
 #include <nanovg.h>
 
 #include "utilities.h"
+#include "render/ShapeCache.h"
 
 namespace render {
 
@@ -34,8 +35,7 @@ namespace
       auto vg = &context.vgContext();
       const auto squareSize = context.squareSize();
 
-      const auto lineColor = nvgRGBA(27, 27, 27, 255);
-      const auto lineWidth = 2.f;
+      const auto lineWidth = render::lineWidth();
 
       nvgBeginPath(vg);
 
@@ -56,10 +56,38 @@ namespace
          nvgRect(vg, originX, y, xSize, lineWidth);
       }
 
-      nvgFillColor(vg, lineColor);
+      nvgFillColor(vg, lineColor());
       nvgFill(vg);
    }
 
+   void drawIllegalPoints(const std::vector<bool>& illegalPoints, int width, const DrawContext& context)
+   {
+      if (illegalPoints.empty())
+         return;
+
+      auto vg = &context.vgContext();
+      const auto squareSize = context.squareSize();
+      const auto stoneRadius = context.stoneRadiusF();
+      const auto size = 2.f * stoneRadius;
+
+      // All the points in one fill
+      std::vector<float> positions;
+      positions.reserve(illegalPoints.size() * 2);
+      for (size_t index = 0; index < illegalPoints.size(); ++index)
+      {
+         if (!illegalPoints[index])
+            continue;
+
+         const auto i = int(index) % width;
+         const auto j = int(index) / width;
+         positions.push_back(float(i * squareSize) - stoneRadius);
+         positions.push_back(float(j * squareSize) - stoneRadius);
+      }
+
+      nvgFillColor(vg, pickColor(PickColor::Red));
+      fillRoundedRects(context, positions.data(), int(positions.size() / 2), size, size, stoneRadius*.2f);
+   }
+
    void drawPick(int i, int j, PickColor color, const DrawContext& context)
    {
       if (i < 0 || j < 0)
@@ -74,20 +102,65 @@ namespace
       auto y = float(j * squareSize) - stoneRadius;
       auto size = 2.f * stoneRadius;
 
-      nvgBeginPath(vg);
-      nvgRoundedRect(vg, x, y, size, size, stoneRadius*.2f);
       nvgFillColor(vg, lineColor);
-      nvgFill(vg);
+      fillRoundedRect(context, x, y, size, size, stoneRadius*.2f);
    }
 }
 
 
 void Board::draw(const DrawContext& context) const
 {
+   const auto margin = context.margin();
+
+   if (_cache.isValid() && _cachedSquareSize == context.squareSize())
+   {
+      auto vg = &context.vgContext();
+      const auto hSize = float(boardWidthInPx(context));
+      const auto vSize = float((_height - 1) * context.squareSize() + 2 * margin);
+
+      nvgBeginPath(vg);
+      nvgRect(vg, originX - margin, originY - margin, hSize, vSize);
+      nvgFillPaint(vg, nvgImagePattern(vg, originX - margin, originY - margin, hSize, vSize, 0.f, _cache.image(), 1.f));
+      nvgFill(vg);
+   }
+   else
+   {
+      // No framebuffer (or not prepared for this size yet), we draw everything
+      drawBoard(_width, _height, context);
+      drawLines(_width, _height, context);
+   }
+
+   drawIllegalPoints(_illegalPoints, _width, context);
+   drawPick(_pickI, _pickJ, _pickColor, context);
+}
+
+void Board::prepare(const DrawContext& context, float pxRatio)
+{
+   if (_cache.isValid() && _cachedSquareSize == context.squareSize() && _cache.pxRatio() == pxRatio)
+      return;
+
+   auto vg = &context.vgContext();
+   const auto margin = context.margin();
+   const auto hSize = boardWidthInPx(context);
+   const auto vSize = (_height - 1) * context.squareSize() + 2 * margin;
+
+   _cachedSquareSize = 0;
+   if (!_cache.create(*vg, hSize, vSize, pxRatio, 0))
+      return;
+
+   _cache.beginFrame();
+   nvgTranslate(vg, float(margin), float(margin));
    drawBoard(_width, _height, context);
    drawLines(_width, _height, context);
+   _cache.endFrame();
 
-   drawPick(_pickI, _pickJ, _pickColor, context);
+   _cachedSquareSize = context.squareSize();
+}
+
+void Board::releaseCache()
+{
+   _cache.release();
+   _cachedSquareSize = 0;
 }
 
 void Board::setPickedPosition(int i, int j)
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <vector>
+
 #include "render/DrawableItem.h"
 #include "render/DrawContext.h"
+#include "render/OffscreenImage.h"
 #include "render/utilities.h"
 
 namespace render {
@@ -13,8 +16,19 @@ public:
 
    virtual void draw(const DrawContext& context) const override;
 
+   // The background and the lines only change with the square size : they're drawn once in an offscreen
+   // framebuffer, and each frame only draws its image. Must be called outside of nvgBeginFrame/nvgEndFrame
+   void prepare(const DrawContext& context, float pxRatio);
+   // Needs the GL context, so it must be called before it's destroyed
+   void releaseCache();
+   // The next prepare renders the cache again, whatever its size
+   void invalidateCache() { _cachedSquareSize = 0; }
+
    void setPickedPosition(int i, int j);
    void setPickColor(PickColor color) { _pickColor = color; }
+   // One value per intersection (i + j * width), true for the empty points where the player to move can't play.
+   // An empty vector hides the overlay
+   void setIllegalPoints(std::vector<bool> illegalPoints) { _illegalPoints = std::move(illegalPoints); }
 
    int maxStoneCount() const { return _width * _height; }
    int boardWidthInPx(const DrawContext& context) const;
@@ -27,6 +41,10 @@ private:
    int _pickJ = -1;
 
    PickColor _pickColor = PickColor::Red;
+   std::vector<bool> _illegalPoints;
+
+   OffscreenImage _cache;
+   int _cachedSquareSize = 0;
 };
 
 } // namespace render
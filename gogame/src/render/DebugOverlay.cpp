@@ -0,0 +1,42 @@
+#include "DebugOverlay.h"
+
+#include <algorithm>
+
+#include "render/utilities.h"
+
+namespace render {
+
+namespace
+{
+   constexpr float fontSize = 14.f;
+   constexpr float padding = 6.f;
+}
+
+void drawDebugOverlay(NVGcontext& vg, const std::vector<std::string>& lines, float winHeight)
+{
+   if (lines.empty())
+      return;
+
+   nvgFontSize(&vg, fontSize);
+   nvgFontFace(&vg, "sans");
+   nvgTextAlign(&vg, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
+
+   float width = 0.f;
+   for (const auto& line : lines)
+      width = std::max(width, nvgTextBounds(&vg, 0.f, 0.f, line.data(), line.data() + line.size(), nullptr));
+
+   const auto height = float(lines.size()) * fontSize + 2.f * padding;
+   const auto x = padding;
+   const auto y = winHeight - height - padding;
+
+   nvgBeginPath(&vg);
+   nvgRect(&vg, x, y, width + 2.f * padding, height);
+   nvgFillColor(&vg, color(0, 0, 0, 160));
+   nvgFill(&vg);
+
+   nvgFillColor(&vg, textColor());
+   for (size_t i = 0; i < lines.size(); ++i)
+      nvgText(&vg, x + padding, y + padding + float(i) * fontSize, lines[i].data(), lines[i].data() + lines[i].size());
+}
+
+} // namespace render
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <nanovg.h>
+
+namespace render {
+
+// Lines of diagnostic text drawn in a translucent box, at the bottom left of the window
+void drawDebugOverlay(NVGcontext& vg, const std::vector<std::string>& lines, float winHeight);
+
+} // namespace render
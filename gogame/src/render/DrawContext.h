@@ -6,6 +6,8 @@
 
 namespace render {
 
+class ShapeCache;
+
 class DrawContext
 {
 public:
@@ -16,21 +18,34 @@ public:
 
    int squareSize() const { return _squareSize; }
    float squareSizeF() const { return float(squareSize()); }
-   void setSquareSize(int value) { _squareSize = value; }
-
-   int margin() const { return int(std::ceil(squareSizeF() * marginFactor())); };
+   // The sizes which follow from it are computed here once, not at each access
+   void setSquareSize(int value)
+   {
+      _squareSize = value;
+      _margin = int(std::ceil(squareSizeF() * marginFactor()));
+      _stoneRadius = squareSizeF() * stoneFactor();
+   }
+
+   int margin() const { return _margin; };
    static constexpr float marginFactor() { return .5f; }
 
-   float stoneRadiusF() const { return float(squareSize()) * stoneFactor(); };
+   float stoneRadiusF() const { return _stoneRadius; };
    static constexpr float stoneFactor() { return .36f; }
 
    int boardWidth() const { return _boardWidth; }
    int boardHeight() const { return _boardHeight; }
 
+   // Optional, shared by the copies of the context
+   ShapeCache* shapeCache() const { return _shapeCache; }
+   void setShapeCache(ShapeCache* cache) { _shapeCache = cache; }
+
 private:
    NVGcontext& _vgContext;
+   ShapeCache* _shapeCache = nullptr;
 
    int _squareSize = 50;
+   int _margin = 25;
+   float _stoneRadius = 50.f * stoneFactor();
    int _boardWidth;
    int _boardHeight;
 };
@@ -0,0 +1,337 @@
+#include "FrameProfiler.h"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "render/utilities.h"
+
+namespace render {
+
+namespace
+{
+   constexpr float panelWidth = 260.f;
+   constexpr float padding = 8.f;
+   constexpr float graphHeight = 50.f;
+   constexpr float fontSize = 13.f;
+   // Frame budget at 60 Hz, drawn as a line on the graphs
+   constexpr float budgetMs = 1000.f / 60.f;
+
+   constexpr NVGcolor stageColor(int stage)
+   {
+      return (stage == 0) ? color(90, 160, 230) :
+         (stage == 1) ? color(160, 110, 220) :
+         (stage == 2) ? color(230, 170, 60) :
+         (stage == 3) ? color(230, 90, 70) :
+         (stage == 4) ? color(90, 200, 120) :
+         (stage == 5) ? color(200, 200, 200) :
+         color(120, 120, 120);
+   }
+}
+
+const char* FrameProfiler::stageName(Stage stage)
+{
+   switch (stage)
+   {
+   case Stage::Events: return "events";
+   case Stage::Prepare: return "prepare";
+   case Stage::Draw: return "draw";
+   case Stage::Flush: return "flush";
+   case Stage::Stones: return "stones";
+   case Stage::Overlay: return "overlay";
+   case Stage::Swap: return "swap";
+   default: return "";
+   }
+}
+
+FrameProfiler::~FrameProfiler()
+{
+   release();
+}
+
+void FrameProfiler::init()
+{
+   release();
+
+   _current.cpu.fill(0.f);
+   _current.gpu.fill(-1.f);
+
+   _hasQueries = GLEW_VERSION_3_3 || GLEW_ARB_timer_query;
+   if (!_hasQueries)
+      return;
+
+   for (auto& set : _querySets)
+   {
+      glGenQueries(nbStages, set.queries.data());
+      set.isIssued.fill(false);
+      set.isPending = false;
+   }
+}
+
+void FrameProfiler::release()
+{
+   if (_hasQueries)
+   {
+      if (_gpuStage >= 0)
+         endGpu();
+
+      // The oldest set first, so the CSV stays in frame order
+      std::array<QuerySet*, nbQuerySets> sets = { &_querySets[0], &_querySets[1] };
+      if (sets[0]->frame > sets[1]->frame)
+         std::swap(sets[0], sets[1]);
+      for (auto set : sets)
+      {
+         if (set->isPending)
+            collect(*set, true);
+         glDeleteQueries(nbStages, set->queries.data());
+      }
+   }
+   _hasQueries = false;
+   _csv.close();
+}
+
+bool FrameProfiler::openCsv(const std::string& fileName)
+{
+   _csv.open(fileName);
+   if (!_csv)
+      return false;
+
+   _csv << "frame";
+   for (int stage = 0; stage < nbStages; ++stage)
+      _csv << ",cpu_" << stageName(Stage(stage));
+   for (int stage = 0; stage < nbStages; ++stage)
+      _csv << ",gpu_" << stageName(Stage(stage));
+   _csv << '\n';
+   return true;
+}
+
+void FrameProfiler::beginFrame()
+{
+   _current.number = _nbFrames + 1;
+   _current.gpu.fill(-1.f);
+
+   if (!_hasQueries)
+      return;
+
+   // The set of two frames ago : its queries are read before being issued again
+   auto& set = _querySets[_current.number % nbQuerySets];
+   if (set.isPending)
+      collect(set, false);
+   set.isIssued.fill(false);
+   set.frame = _current.number;
+}
+
+void FrameProfiler::endFrame()
+{
+   if (_gpuStage >= 0)
+      endGpu();
+
+   _nbFrames = _current.number;
+   for (int stage = 0; stage < nbStages; ++stage)
+      _totalCpu[stage] += _current.cpu[stage];
+   historyFrame(_current.number) = _current;
+
+   // Without queries the frame is complete, otherwise it's written once its queries are read
+   if (_hasQueries)
+      _querySets[_current.number % nbQuerySets].isPending = true;
+   else
+      writeCsv(_current);
+
+   _current.cpu.fill(0.f);
+}
+
+void FrameProfiler::addCpuTime(Stage stage, double seconds)
+{
+   _current.cpu[int(stage)] += float(seconds * 1000.0);
+}
+
+void FrameProfiler::beginGpu(Stage stage)
+{
+   if (!_hasQueries)
+      return;
+   if (_gpuStage >= 0)
+      endGpu();
+
+   auto& set = _querySets[_current.number % nbQuerySets];
+   glBeginQuery(GL_TIME_ELAPSED, set.queries[int(stage)]);
+   set.isIssued[int(stage)] = true;
+   _gpuStage = int(stage);
+}
+
+void FrameProfiler::endGpu()
+{
+   if (_gpuStage < 0)
+      return;
+   glEndQuery(GL_TIME_ELAPSED);
+   _gpuStage = -1;
+}
+
+double FrameProfiler::averageCpuMs(Stage stage) const
+{
+   return _nbFrames > 0 ? _totalCpu[int(stage)] / double(_nbFrames) : 0.0;
+}
+
+void FrameProfiler::collect(QuerySet& set, bool wait)
+{
+   auto& frame = historyFrame(set.frame);
+   for (int stage = 0; stage < nbStages; ++stage)
+   {
+      if (!set.isIssued[stage])
+         continue;
+
+      if (!wait)
+      {
+         GLuint isAvailable = GL_FALSE;
+         glGetQueryObjectuiv(set.queries[stage], GL_QUERY_RESULT_AVAILABLE, &isAvailable);
+         if (isAvailable != GL_TRUE)
+            continue;
+      }
+
+      GLuint64 nanoseconds = 0;
+      glGetQueryObjectui64v(set.queries[stage], GL_QUERY_RESULT, &nanoseconds);
+      if (frame.number == set.frame)
+         frame.gpu[stage] = float(double(nanoseconds) * 1e-6);
+   }
+   set.isPending = false;
+
+   if (frame.number == set.frame)
+      writeCsv(frame);
+}
+
+void FrameProfiler::writeCsv(const FrameTimes& frame)
+{
+   if (!_csv.is_open())
+      return;
+
+   _csv << frame.number;
+   for (auto ms : frame.cpu)
+      _csv << ',' << ms;
+   for (auto ms : frame.gpu)
+   {
+      _csv << ',';
+      if (ms >= 0.f)
+         _csv << ms;
+   }
+   _csv << '\n';
+}
+
+void FrameProfiler::draw(NVGcontext& vg, float x, float y) const
+{
+   const auto nbShownFrames = int(std::min<unsigned long long int>(_nbFrames, historySize));
+   const auto graphWidth = panelWidth - 2.f * padding;
+   const auto barWidth = graphWidth / float(historySize);
+
+   // Averages over the shown frames, and the scale of the graphs
+   std::array<float, nbStages> cpuAverage = {};
+   std::array<float, nbStages> gpuAverage = {};
+   std::array<int, nbStages> nbGpuSamples = {};
+   float maxTotal = budgetMs;
+   for (int k = 0; k < nbShownFrames; ++k)
+   {
+      const auto& frame = historyFrame(_nbFrames - k);
+      float cpuTotal = 0.f;
+      float gpuTotal = 0.f;
+      for (int stage = 0; stage < nbStages; ++stage)
+      {
+         cpuAverage[stage] += frame.cpu[stage];
+         cpuTotal += frame.cpu[stage];
+         if (frame.gpu[stage] >= 0.f)
+         {
+            gpuAverage[stage] += frame.gpu[stage];
+            gpuTotal += frame.gpu[stage];
+            nbGpuSamples[stage]++;
+         }
+      }
+      maxTotal = std::max(maxTotal, std::max(cpuTotal, gpuTotal));
+   }
+   for (int stage = 0; stage < nbStages; ++stage)
+   {
+      cpuAverage[stage] /= float(std::max(nbShownFrames, 1));
+      gpuAverage[stage] /= float(std::max(nbGpuSamples[stage], 1));
+   }
+
+   const auto legendHeight = float(nbStages + 1) * fontSize;
+   const auto panelHeight = 3.f * padding + 2.f * (fontSize + graphHeight + padding) + legendHeight;
+
+   nvgBeginPath(&vg);
+   nvgRoundedRect(&vg, x, y, panelWidth, panelHeight, 6.f);
+   nvgFillColor(&vg, color(0, 0, 0, 170));
+   nvgFill(&vg);
+
+   nvgFontSize(&vg, fontSize);
+   nvgFontFace(&vg, "sans");
+   nvgTextAlign(&vg, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
+
+   auto drawGraph = [&](const char* title, float gy, bool isGpu) {
+      nvgFillColor(&vg, textColor());
+      nvgText(&vg, x + padding, gy, title, nullptr);
+      gy += fontSize;
+
+      const auto gx = x + padding;
+      nvgBeginPath(&vg);
+      nvgRect(&vg, gx, gy, graphWidth, graphHeight);
+      nvgFillColor(&vg, color(40, 40, 40, 200));
+      nvgFill(&vg);
+
+      // One fill per stage, each bar on top of the stages before it. The newest frame is on the right
+      std::array<float, historySize> base = {};
+      for (int stage = 0; stage < nbStages; ++stage)
+      {
+         nvgBeginPath(&vg);
+         for (int k = 0; k < nbShownFrames; ++k)
+         {
+            const auto& frame = historyFrame(_nbFrames - k);
+            const auto ms = isGpu ? frame.gpu[stage] : frame.cpu[stage];
+            if (ms <= 0.f)
+               continue;
+            const auto h = ms / maxTotal * graphHeight;
+            nvgRect(&vg, gx + graphWidth - float(k + 1) * barWidth, gy + graphHeight - base[k] - h, barWidth, h);
+            base[k] += h;
+         }
+         nvgFillColor(&vg, stageColor(stage));
+         nvgFill(&vg);
+      }
+
+      const auto budgetY = gy + graphHeight - budgetMs / maxTotal * graphHeight;
+      nvgBeginPath(&vg);
+      nvgRect(&vg, gx, budgetY, graphWidth, 1.f);
+      nvgFillColor(&vg, color(255, 255, 255, 120));
+      nvgFill(&vg);
+   };
+
+   auto ty = y + padding;
+   drawGraph("CPU", ty, false);
+   ty += fontSize + graphHeight + padding;
+   drawGraph(_hasQueries ? "GPU" : "GPU (no timer queries)", ty, true);
+   ty += fontSize + graphHeight + 2.f * padding;
+
+   // Legend, with the averages in ms
+   nvgFillColor(&vg, textColor());
+   nvgText(&vg, x + padding + 14.f, ty, "stage", nullptr);
+   nvgTextAlign(&vg, NVG_ALIGN_RIGHT | NVG_ALIGN_TOP);
+   nvgText(&vg, x + panelWidth * .7f, ty, "cpu ms", nullptr);
+   nvgText(&vg, x + panelWidth - padding, ty, "gpu ms", nullptr);
+   char text[16];
+   for (int stage = 0; stage < nbStages; ++stage)
+   {
+      const auto ly = ty + float(stage + 1) * fontSize;
+      nvgBeginPath(&vg);
+      nvgRect(&vg, x + padding, ly + 2.f, 9.f, 9.f);
+      nvgFillColor(&vg, stageColor(stage));
+      nvgFill(&vg);
+
+      nvgFillColor(&vg, textColor());
+      nvgTextAlign(&vg, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
+      nvgText(&vg, x + padding + 14.f, ly, stageName(Stage(stage)), nullptr);
+
+      nvgTextAlign(&vg, NVG_ALIGN_RIGHT | NVG_ALIGN_TOP);
+      snprintf(text, sizeof(text), "%.2f", cpuAverage[stage]);
+      nvgText(&vg, x + panelWidth * .7f, ly, text, nullptr);
+      if (nbGpuSamples[stage] > 0)
+      {
+         snprintf(text, sizeof(text), "%.2f", gpuAverage[stage]);
+         nvgText(&vg, x + panelWidth - padding, ly, text, nullptr);
+      }
+   }
+}
+
+} // namespace render
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <string>
+
+#include <GL/glew.h>
+#include <nanovg.h>
+
+namespace render {
+
+// Where the time of a frame goes. CPU stages are timed with a monotonic clock around the code, GPU stages with
+// GL_TIME_ELAPSED queries. The queries alternate between two sets and a set is read when it comes back, two frames
+// later : the profiler never waits for the GPU, a result that isn't available by then is dropped
+class FrameProfiler
+{
+public:
+   enum class Stage
+   {
+      Events,     // Applying the input and the game snapshots, between two frames
+      Prepare,    // Offscreen caches
+      Draw,       // Building the nanovg frame
+      Flush,      // nvgEndFrame : tessellation, upload, GL calls
+      Stones,     // Instanced stone layer
+      Overlay,    // Debug overlays, this one included
+      Swap,       // glfwSwapBuffers
+      Count
+   };
+   static constexpr int nbStages = int(Stage::Count);
+   static const char* stageName(Stage stage);
+
+   FrameProfiler() {}
+   ~FrameProfiler();
+
+   FrameProfiler(const FrameProfiler&) = delete;
+   FrameProfiler& operator=(const FrameProfiler&) = delete;
+
+   // Creates the queries. Without GL 3.3 or ARB_timer_query, only the CPU is measured
+   void init();
+   // Needs the GL context : waits for the last queries, writes their CSV lines and deletes the queries
+   void release();
+
+   // One line per frame : frame number, then the CPU and GPU milliseconds of each stage (GPU empty if unknown)
+   bool openCsv(const std::string& fileName);
+
+   void beginFrame();
+   void endFrame();
+
+   // CPU time spent outside a frame goes in the next one
+   void addCpuTime(Stage stage, double seconds);
+   // GL_TIME_ELAPSED queries can't be nested, only one GPU stage at a time
+   void beginGpu(Stage stage);
+   void endGpu();
+
+   // Since init, over all the frames
+   double averageCpuMs(Stage stage) const;
+   unsigned long long int nbFrames() const { return _nbFrames; }
+
+   // Stacked graphs of the last frames, CPU then GPU, with the averages of each stage. (x, y) is the top-left corner
+   void draw(NVGcontext& vg, float x, float y) const;
+
+private:
+   static constexpr int historySize = 120;
+   static constexpr int nbQuerySets = 2;
+
+   struct FrameTimes
+   {
+      unsigned long long int number = 0;
+      std::array<float, nbStages> cpu;
+      // Negative when unknown
+      std::array<float, nbStages> gpu;
+   };
+
+   struct QuerySet
+   {
+      std::array<GLuint, nbStages> queries;
+      std::array<bool, nbStages> isIssued;
+      unsigned long long int frame = 0;
+      bool isPending = false;
+   };
+
+   void collect(QuerySet& set, bool wait);
+   void writeCsv(const FrameTimes& frame);
+   FrameTimes& historyFrame(unsigned long long int number) { return _history[number % historySize]; }
+   const FrameTimes& historyFrame(unsigned long long int number) const { return _history[number % historySize]; }
+
+   std::array<FrameTimes, historySize> _history;
+   FrameTimes _current;
+   unsigned long long int _nbFrames = 0;
+   std::array<double, nbStages> _totalCpu = {};
+
+   std::array<QuerySet, nbQuerySets> _querySets;
+   bool _hasQueries = false;
+   int _gpuStage = -1;
+
+   std::ofstream _csv;
+};
+
+// Adds the time of a scope to a CPU stage
+class ScopedCpuTimer
+{
+public:
+   ScopedCpuTimer(FrameProfiler& profiler, FrameProfiler::Stage stage)
+      : _profiler(profiler), _stage(stage), _start(std::chrono::steady_clock::now()) {}
+   ~ScopedCpuTimer()
+   {
+      _profiler.addCpuTime(_stage, std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count());
+   }
+
+   ScopedCpuTimer(const ScopedCpuTimer&) = delete;
+   ScopedCpuTimer& operator=(const ScopedCpuTimer&) = delete;
+
+private:
+   FrameProfiler& _profiler;
+   FrameProfiler::Stage _stage;
+   std::chrono::steady_clock::time_point _start;
+};
+
+} // namespace render
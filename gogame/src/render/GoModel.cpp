@@ -2,27 +2,53 @@
 
 namespace render {
 
-void draw(const GoModel& model)
+void prepare(GoModel& model, float pxRatio)
+{
+   model.board.prepare(model.context, pxRatio);
+   model.stoneSprites.prepare(model.context, pxRatio);
+}
+
+void draw(const GoModel& model, const Layout& layout, StoneLayer* stoneLayer)
 {
    const auto& context = model.context;
    auto vg = &context.vgContext();
    nvgResetTransform(vg);
 
-   auto origin = boardOrigin(context);
+   const auto origin = layout.boardOrigin();
    nvgTranslate(vg, origin, origin);
 
    model.board.draw(context);
 
-   for (auto&& stone : model.stones)
-      stone.draw(context);
+   if (stoneLayer)
+   {
+      const auto squareSize = context.squareSizeF();
+      model.stones.forEachStone([&](const Stone& stone) {
+         stoneLayer->addStone(origin + float(stone.posX()) * squareSize, origin + float(stone.posY()) * squareSize, context.stoneRadiusF(), stone.player());
+      });
+   }
+   else if (!model.stoneSprites.draw(context, model.stones))
+   {
+      model.stones.forEachStone([&context](const Stone& stone) { stone.draw(context); });
+   }
 
    nvgTranslate(vg, -origin, -origin);
 
-   const auto tx = float(origin + model.board.boardWidthInPx(context) + 10);
-   const auto ty = float(origin - context.margin());
-   nvgTranslate(&context.vgContext(), tx, ty);
+   const auto panel = layout.sidePanelOrigin();
+   nvgTranslate(&context.vgContext(), panel.first, panel.second);
    model.infos.draw(context);
-   nvgTranslate(&context.vgContext(), -tx, -ty);
+   nvgTranslate(&context.vgContext(), -panel.first, -panel.second);
+}
+
+void invalidate(GoModel& model)
+{
+   model.board.invalidateCache();
+   model.stoneSprites.invalidate();
+}
+
+void release(GoModel& model)
+{
+   model.board.releaseCache();
+   model.stoneSprites.release();
 }
 
 } // namespace render
@@ -1,10 +1,11 @@
 #pragma once
 
-#include <vector>
-
 #include "render/DrawContext.h"
 #include "render/Board.h"
-#include "render/Stone.h"
+#include "render/Layout.h"
+#include "render/StoneGrid.h"
+#include "render/StoneLayer.h"
+#include "render/StoneSprites.h"
 #include "render/utilities.h"
 #include "render/Informations.h"
 
@@ -12,18 +13,27 @@ namespace render {
 
 struct GoModel
 {
-   GoModel(DrawContext& context) : context(context), board(context.boardWidth(), context.boardHeight())
-   { 
-      stones.reserve(board.maxStoneCount());
+   GoModel(DrawContext& context)
+      : context(context), board(context.boardWidth(), context.boardHeight()), stones(context.boardWidth(), context.boardHeight())
+   {
    }
 
    DrawContext& context;
 
    Board board;
-   std::vector<Stone> stones = {};
+   StoneGrid stones;
+   StoneSprites stoneSprites;
    Informations infos = {};
 };
 
-void draw(const GoModel& model);
+// Updates the offscreen caches of the model. Called before nvgBeginFrame, as it renders in its own frames
+void prepare(GoModel& model, float pxRatio);
+// With a stone layer, the stones are queued in it instead of being drawn with nanovg. The layout places the board
+// and the panel, its square size must be the one of the context
+void draw(const GoModel& model, const Layout& layout, StoneLayer* stoneLayer = nullptr);
+// After a resize : the offscreen caches are rendered again at the next prepare
+void invalidate(GoModel& model);
+// Releases the GPU resources of the model, while the GL context still exists
+void release(GoModel& model);
 
 } // namespace render
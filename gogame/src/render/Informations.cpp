@@ -3,6 +3,7 @@
 #include <string>
 #include <utility>
 
+#include "render/ShapeCache.h"
 #include "render/stone.h"
 
 namespace render
@@ -24,10 +25,8 @@ void drawFrame(const DrawContext& context)
    auto vg = &context.vgContext();
    constexpr auto size = frameSize();
 
-   nvgBeginPath(vg);
-   nvgRoundedRect(vg, 0, 0, size.first, size.second, size.first * .05f);
    nvgFillColor(vg, frameColor());
-   nvgFill(vg);
+   fillRoundedRect(context, 0.f, 0.f, size.first, size.second, size.first * .05f);
 }
 
 void drawStone(Player player, DrawContext context)
@@ -66,15 +65,13 @@ float drawScoreFrame(const DrawContext& context)
    constexpr auto frameWidth = size.first - margin * 2.f;
    constexpr auto frameHeight = size.second * .55f - margin * .8f;
 
-   nvgBeginPath(vg);
-   nvgRoundedRect(vg, 0.f, 0.f, frameWidth, frameHeight, size.first * .04f);
    nvgFillColor(vg, scoreFrameColor());
-   nvgFill(vg);
+   fillRoundedRect(context, 0.f, 0.f, frameWidth, frameHeight, size.first * .04f);
 
    return frameWidth;
 }
 
-void drawScoreText(int scoreB, int scoreW, float frameWidth, const DrawContext& context)
+void drawScoreText(const std::string& scoreB, const std::string& scoreW, float frameWidth, const DrawContext& context)
 {
    auto vg = &context.vgContext();
    constexpr auto ty = margin * .3f;
@@ -87,11 +84,11 @@ void drawScoreText(int scoreB, int scoreW, float frameWidth, const DrawContext&
    nvgText(vg, frameWidth * .25f, ty, "Black", NULL);
    nvgText(vg, frameWidth * .75f, ty, "White", NULL);
 
-   nvgText(vg, frameWidth * .25f, ty + fontSize, std::to_string(scoreB).data(), NULL);
-   nvgText(vg, frameWidth * .75f, ty + fontSize, std::to_string(scoreW).data(), NULL);
+   nvgText(vg, frameWidth * .25f, ty + fontSize, scoreB.data(), scoreB.data() + scoreB.size());
+   nvgText(vg, frameWidth * .75f, ty + fontSize, scoreW.data(), scoreW.data() + scoreW.size());
 }
 
-void drawScore(int scoreB, int scoreW, const DrawContext& context)
+void drawScore(const std::string& scoreB, const std::string& scoreW, const DrawContext& context)
 {
    auto vg = &context.vgContext();
    const auto size = frameSize();
@@ -104,7 +101,7 @@ void drawScore(int scoreB, int scoreW, const DrawContext& context)
    nvgTranslate(vg, -tx, -ty);
 }
 
-void drawMessageStringFrame(const std::string& message, float parentW, float parentH,
+void drawMessageStringFrame(const std::string& message, TextBoxLayout& layout, float parentW, float parentH,
    const DrawContext& context)
 {
    auto vg = &context.vgContext();
@@ -112,20 +109,15 @@ void drawMessageStringFrame(const std::string& message, float parentW, float par
    const auto frameWidth = parentW - margin * 2.f;
    const auto frameHeight = parentH - fontSize - margin * 2.f;
 
-   nvgBeginPath(vg);
-   nvgRoundedRect(vg, 0.f, 0.f, frameWidth, frameHeight, size.first * .04f);
    nvgFillColor(vg, scoreFrameColor());
-   nvgFill(vg);
+   fillRoundedRect(context, 0.f, 0.f, frameWidth, frameHeight, size.first * .04f);
 
-   nvgFontSize(vg, 18.0f);
-   nvgFontFace(vg, "sans");
    nvgFillColor(vg, textColor());
-   nvgTextAlign(vg, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
-
-   nvgTextBox(vg, margin, margin*.3f, frameWidth - 2.f*margin, message.data(), nullptr);
+   layout.update(*vg, message, "sans", 18.0f, frameWidth - 2.f*margin);
+   layout.draw(*vg, margin, margin*.3f);
 }
 
-void drawMessageFrame(const std::string& message, const DrawContext& context)
+void drawMessageFrame(const std::string& message, TextBoxLayout& layout, const DrawContext& context)
 {
    auto vg = &context.vgContext();
    constexpr auto size = frameSize();
@@ -135,10 +127,8 @@ void drawMessageFrame(const std::string& message, const DrawContext& context)
    constexpr auto frameX = 0.f;
    constexpr auto frameY = size.second + margin;
 
-   nvgBeginPath(vg);
-   nvgRoundedRect(vg, frameX, frameY, frameWidth, frameHeight, size.first * .05f);
    nvgFillColor(vg, frameColor());
-   nvgFill(vg);
+   fillRoundedRect(context, frameX, frameY, frameWidth, frameHeight, size.first * .05f);
 
    nvgFontSize(vg, fontSize);
    nvgFontFace(vg, "bold");
@@ -151,19 +141,37 @@ void drawMessageFrame(const std::string& message, const DrawContext& context)
    constexpr auto ty = frameY + fontSize + margin;
 
    nvgTranslate(vg, tx, ty);
-   drawMessageStringFrame(message, frameWidth, frameHeight, context);
+   drawMessageStringFrame(message, layout, frameWidth, frameHeight, context);
    nvgTranslate(vg, -tx, -ty);
 }
 
 } // namespace
 
+void Informations::setScore(int blackScore, int whiteScore)
+{
+   if (blackScore != _blackScore)
+      _blackScoreText = std::to_string(blackScore);
+   if (whiteScore != _whiteScore)
+      _whiteScoreText = std::to_string(whiteScore);
+
+   _whiteScore = whiteScore;
+   _blackScore = blackScore;
+}
+
+float Informations::height()
+{
+   // See drawMessageFrame
+   constexpr auto size = frameSize();
+   return size.second + margin + size.second * 1.8f;
+}
+
 void Informations::draw(const DrawContext& context) const
 {
    drawFrame(context);
    drawNextPlayer(_player, context);
-   drawScore(_blackScore, _whiteScore, context);
+   drawScore(_blackScoreText, _whiteScoreText, context);
 
-   drawMessageFrame(_message, context);
+   drawMessageFrame(_message, _messageLayout, context);
 }
 
 } // namespace render
\ No newline at end of file
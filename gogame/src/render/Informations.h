@@ -3,6 +3,7 @@
 #include <string>
 
 #include <render/DrawableItem.h>
+#include <render/TextLayout.h>
 #include <render/utilities.h>
 
 namespace render
@@ -13,17 +14,25 @@ class Informations : public DrawableItem
 public:
    Informations() {}
 
-   void setScore(int blackScore, int whiteScore) { _whiteScore = whiteScore; _blackScore = blackScore; }
+   void setScore(int blackScore, int whiteScore);
    void setPlayer(Player player) { _player = player; }
    void setMessage(const std::string& message) { _message = message; }
 
    virtual void draw(const DrawContext& context) const override;
 
+   // Of the whole panel, message frame included
+   static float height();
+
 private:
    int _whiteScore = 0;
    int _blackScore = 0;
    Player _player = Player::Black;
    std::string _message = "";
+
+   // Texts are formatted and laid out when they change, not at each frame
+   std::string _whiteScoreText = "0";
+   std::string _blackScoreText = "0";
+   mutable TextBoxLayout _messageLayout;
 };
 
 } // namespace render
@@ -0,0 +1,72 @@
+#include "Layout.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "render/DrawContext.h"
+
+namespace render {
+
+namespace
+{
+   // Distance from the window corner to the first intersection, in squares
+   constexpr float boardOriginFactor = 1.f;
+
+   // The board and its margin fill the window on its smallest side
+   int squareSizeFromCanvasSize(int winSize, int boardSize)
+   {
+      const auto size = float(winSize) / std::ceil(float(boardSize - 1) + boardOriginFactor + DrawContext::marginFactor());
+      return int(std::floor(size));
+   }
+
+   // A pixel picks the intersection whose stone covers it, squares being counted from the top-left of the stone
+   std::vector<short> buildPickTable(int winSize, int boardSize, int squareSize, float stoneRadius)
+   {
+      std::vector<short> table((std::max)(winSize, 0), -1);
+      if (squareSize <= 0)
+         return table;
+
+      const auto deltaOrigin = int(float(squareSize) * boardOriginFactor - stoneRadius);
+      for (int pixel = 0; pixel < winSize; ++pixel)
+      {
+         const auto position = float(pixel - deltaOrigin) / float(squareSize);
+         const auto index = int(std::floor(position));
+         if (index >= 0 && index < boardSize && position - std::floor(position) <= 2.f * DrawContext::stoneFactor())
+            table[pixel] = short(index);
+      }
+      return table;
+   }
+}
+
+Layout::Layout(int winWidth, int winHeight, int fbWidth, int fbHeight, int boardWidth, int boardHeight)
+   : _winWidth(winWidth), _winHeight(winHeight), _fbWidth(fbWidth), _fbHeight(fbHeight),
+   _boardWidth(boardWidth), _boardHeight(boardHeight)
+{
+   if (isEmpty())
+      return;
+
+   _pxRatio = float(fbWidth) / float(winWidth);
+
+   _squareSize = (std::min)(squareSizeFromCanvasSize(winWidth, boardWidth), squareSizeFromCanvasSize(winHeight, boardHeight));
+   // Same values as the DrawContext once it has this square size
+   _margin = int(std::ceil(float(_squareSize) * DrawContext::marginFactor()));
+   _stoneRadius = float(_squareSize) * DrawContext::stoneFactor();
+   _boardOrigin = boardOriginFactor * float(_squareSize);
+   // first point is (0,0), so width - 1
+   _boardWidthInPx = (boardWidth - 1) * _squareSize + 2 * _margin;
+   _sidePanelOrigin = std::make_pair(_boardOrigin + float(_boardWidthInPx + 10), _boardOrigin - float(_margin));
+
+   _pickColumns = buildPickTable(winWidth, boardWidth, _squareSize, _stoneRadius);
+   _pickRows = buildPickTable(winHeight, boardHeight, _squareSize, _stoneRadius);
+}
+
+std::pair<int, int> Layout::pick(double windowX, double windowY) const
+{
+   const auto x = int(std::floor(windowX));
+   const auto y = int(std::floor(windowY));
+   const auto i = (x >= 0 && x < int(_pickColumns.size())) ? int(_pickColumns[x]) : -1;
+   const auto j = (y >= 0 && y < int(_pickRows.size())) ? int(_pickRows[y]) : -1;
+   return std::make_pair(i, j);
+}
+
+} // namespace render
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+namespace render {
+
+// Everything in the window which only depends on its size and on the board size : square size, board origin, stone
+// radius, origin of the side panel, and the intersection under each pixel. It's computed in the GLFW size callbacks
+// and never changes afterwards, a resize builds a new one. The frames only read it
+class Layout
+{
+public:
+   // Empty window, nothing to draw or to pick
+   Layout() {}
+   Layout(int winWidth, int winHeight, int fbWidth, int fbHeight, int boardWidth, int boardHeight);
+
+   int winWidth() const { return _winWidth; }
+   int winHeight() const { return _winHeight; }
+   int fbWidth() const { return _fbWidth; }
+   int fbHeight() const { return _fbHeight; }
+   // For hi-dpi devices
+   float pxRatio() const { return _pxRatio; }
+   // A minimized window has no size
+   bool isEmpty() const { return _winWidth <= 0 || _winHeight <= 0; }
+
+   int boardWidth() const { return _boardWidth; }
+   int boardHeight() const { return _boardHeight; }
+   int squareSize() const { return _squareSize; }
+   int margin() const { return _margin; }
+   float stoneRadius() const { return _stoneRadius; }
+   // Window position of the first intersection, on both axes
+   float boardOrigin() const { return _boardOrigin; }
+   int boardWidthInPx() const { return _boardWidthInPx; }
+   // Top-left corner of the Informations panel, on the right of the board
+   std::pair<float, float> sidePanelOrigin() const { return _sidePanelOrigin; }
+
+   // Intersection under the window position, -1 on an axis where it's between two of them or outside of the board.
+   // A lookup in the table of each axis
+   std::pair<int, int> pick(double windowX, double windowY) const;
+
+private:
+   int _winWidth = 0;
+   int _winHeight = 0;
+   int _fbWidth = 0;
+   int _fbHeight = 0;
+   float _pxRatio = 1.f;
+
+   int _boardWidth = 0;
+   int _boardHeight = 0;
+   int _squareSize = 0;
+   int _margin = 0;
+   float _stoneRadius = 0.f;
+   float _boardOrigin = 0.f;
+   int _boardWidthInPx = 0;
+   std::pair<float, float> _sidePanelOrigin = { 0.f, 0.f };
+
+   // Intersection index of each pixel column and row, -1 for none
+   std::vector<short> _pickColumns;
+   std::vector<short> _pickRows;
+};
+
+} // namespace render
@@ -0,0 +1,214 @@
+#include "MonitorView.h"
+
+#include <algorithm>
+#include <string>
+
+#include "render/ShapeCache.h"
+
+namespace render {
+
+namespace
+{
+   // Space around each board, and height of the header above it
+   constexpr int cellGap = 6;
+   constexpr int headerHeight = 16;
+   constexpr float headerFontSize = 12.f;
+   // Below, the stones are a few pixels wide and nothing can be seen anyway
+   constexpr int minSquareSize = 3;
+
+   constexpr NVGcolor lastMoveColor() { return color(220, 50, 50); }
+
+   int boardHeightInPx(int height, const DrawContext& context)
+   {
+      // first point is (0,0), so height - 1
+      return (height - 1) * context.squareSize() + 2 * context.margin();
+   }
+
+   // Number of the board, move number and the player to move, then the score once the game is over
+   void drawHeader(int index, const MonitorView::BoardState& state, float x, float y, float width, const DrawContext& context)
+   {
+      auto vg = &context.vgContext();
+      const auto centerY = y + float(headerHeight) * .5f;
+      const auto stoneRadius = float(headerHeight) * .3f;
+
+      if (!state.isGameOver)
+      {
+         nvgFillColor(vg, stoneColor(state.nextPlayer));
+         fillCircle(context, x + stoneRadius, centerY, stoneRadius);
+      }
+
+      nvgFontSize(vg, headerFontSize);
+      nvgFontFace(vg, "sans");
+      nvgFillColor(vg, textColor());
+
+      const auto title = "#" + std::to_string(index + 1) + "  move " + std::to_string(state.nbMoves);
+      nvgTextAlign(vg, NVG_ALIGN_LEFT | NVG_ALIGN_MIDDLE);
+      nvgText(vg, x + 3.f * stoneRadius, centerY, title.data(), title.data() + title.size());
+
+      if (state.isGameOver)
+      {
+         const auto score = "B " + std::to_string(state.scoreBlack) + "  W " + std::to_string(state.scoreWhite);
+         nvgTextAlign(vg, NVG_ALIGN_RIGHT | NVG_ALIGN_MIDDLE);
+         nvgText(vg, x + width, centerY, score.data(), score.data() + score.size());
+      }
+   }
+}
+
+
+MonitorView::MonitorView(NVGcontext& vg, int nbBoards, int boardWidth, int boardHeight)
+   : _context(vg, boardWidth, boardHeight), _board(boardWidth, boardHeight),
+   _boards(nbBoards, BoardState(boardWidth, boardHeight)), _isDirty(nbBoards, 1)
+{
+}
+
+MonitorView::BoardState& MonitorView::editBoard(int index)
+{
+   _isDirty[index] = 1;
+   return _boards[index];
+}
+
+void MonitorView::setWindowSize(int winWidth, int winHeight)
+{
+   if (winWidth == _winWidth && winHeight == _winHeight)
+      return;
+
+   _winWidth = winWidth;
+   _winHeight = winHeight;
+
+   const auto width = _context.boardWidth();
+   const auto height = _context.boardHeight();
+   const auto count = nbBoards();
+
+   int bestSquareSize = 0;
+   int bestNbColumns = 1;
+   for (int nbColumns = 1; nbColumns <= count; ++nbColumns)
+   {
+      const auto nbRows = (count + nbColumns - 1) / nbColumns;
+      const auto maxBoardWidth = winWidth / nbColumns - cellGap;
+      const auto maxBoardHeight = winHeight / nbRows - cellGap - headerHeight;
+
+      // With its margins, a board of n lines is at most n squares (and a pixel) wide
+      const auto squareSize = (std::min)((maxBoardWidth - 1) / width, (maxBoardHeight - 1) / height);
+      if (squareSize > bestSquareSize)
+      {
+         bestSquareSize = squareSize;
+         bestNbColumns = nbColumns;
+      }
+   }
+
+   _context.setSquareSize((std::max)(bestSquareSize, minSquareSize));
+   _nbColumns = bestNbColumns;
+   _cellWidth = _board.boardWidthInPx(_context) + cellGap;
+   _cellHeight = boardHeightInPx(height, _context) + headerHeight + cellGap;
+
+   _board.invalidateCache();
+   _sprites.invalidate();
+   std::fill(_isDirty.begin(), _isDirty.end(), 1);
+}
+
+std::pair<float, float> MonitorView::cellOrigin(int index) const
+{
+   return std::make_pair(float((index % _nbColumns) * _cellWidth), float((index / _nbColumns) * _cellHeight));
+}
+
+void MonitorView::drawCell(int index) const
+{
+   auto vg = &_context.vgContext();
+   const auto& state = _boards[index];
+   const auto origin = cellOrigin(index);
+
+   // Opaque : in the image, it covers what the cell showed before
+   nvgBeginPath(vg);
+   nvgRect(vg, origin.first, origin.second, float(_cellWidth), float(_cellHeight));
+   nvgFillColor(vg, backgroundColor());
+   nvgFill(vg);
+
+   const auto x = origin.first + float(cellGap) * .5f;
+   const auto y = origin.second + float(cellGap) * .5f;
+   drawHeader(index, state, x, y, float(_cellWidth - cellGap), _context);
+
+   const auto margin = float(_context.margin());
+   const auto boardX = x + margin;
+   const auto boardY = y + float(headerHeight) + margin;
+   nvgTranslate(vg, boardX, boardY);
+
+   _board.draw(_context);
+   if (!_sprites.draw(_context, state.stones))
+      state.stones.forEachStone([this](const Stone& stone) { stone.draw(_context); });
+
+   if (state.lastMoveI >= 0 && state.lastMoveJ >= 0)
+   {
+      const auto squareSize = _context.squareSizeF();
+      nvgFillColor(vg, lastMoveColor());
+      fillCircle(_context, float(state.lastMoveI) * squareSize, float(state.lastMoveJ) * squareSize, _context.stoneRadiusF() * .35f);
+   }
+
+   nvgTranslate(vg, -boardX, -boardY);
+}
+
+int MonitorView::prepare(float pxRatio)
+{
+   if (_winWidth <= 0 || _winHeight <= 0)
+      return 0;
+
+   // Outside of the frame of the image, they render in their own
+   _board.prepare(_context, pxRatio);
+   _sprites.prepare(_context, pxRatio);
+
+   bool isNewImage = false;
+   if (!_image.isValid() || _image.width() != _winWidth || _image.height() != _winHeight || _image.pxRatio() != pxRatio)
+   {
+      if (!_image.create(_context.vgContext(), _winWidth, _winHeight, pxRatio, 0))
+         return 0;
+
+      std::fill(_isDirty.begin(), _isDirty.end(), 1);
+      isNewImage = true;
+   }
+
+   const auto nbDirty = int(std::count(_isDirty.begin(), _isDirty.end(), 1));
+   if (nbDirty == 0)
+      return 0;
+
+   // The cells which didn't change keep their pixels
+   _image.beginFrame(isNewImage);
+   for (int i = 0; i < nbBoards(); ++i)
+   {
+      if (!_isDirty[i])
+         continue;
+
+      drawCell(i);
+      _isDirty[i] = 0;
+   }
+   _image.endFrame();
+
+   return nbDirty;
+}
+
+void MonitorView::draw() const
+{
+   auto vg = &_context.vgContext();
+   nvgResetTransform(vg);
+
+   if (!_image.isValid())
+   {
+      for (int i = 0; i < nbBoards(); ++i)
+         drawCell(i);
+      return;
+   }
+
+   const auto width = float(_image.width());
+   const auto height = float(_image.height());
+   nvgBeginPath(vg);
+   nvgRect(vg, 0.f, 0.f, width, height);
+   nvgFillPaint(vg, nvgImagePattern(vg, 0.f, 0.f, width, height, 0.f, _image.image(), 1.f));
+   nvgFill(vg);
+}
+
+void MonitorView::release()
+{
+   _board.releaseCache();
+   _sprites.release();
+   _image.release();
+}
+
+} // namespace render
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <vector>
+
+#include <nanovg.h>
+
+#include "render/Board.h"
+#include "render/DrawContext.h"
+#include "render/OffscreenImage.h"
+#include "render/StoneGrid.h"
+#include "render/StoneSprites.h"
+#include "render/utilities.h"
+
+namespace render {
+
+// Grid of small boards, to watch many games at once. The boards are rendered in an image as big as the window, and
+// only the ones which changed are rendered again : a frame without change is a single image fill, whatever the number
+// of boards. All the boards have the same size, so the background, the lines and the stone sprites are shared
+class MonitorView
+{
+public:
+   // What a board shows. The stones are drawn with the sprites, one fill per color
+   struct BoardState
+   {
+      BoardState(int width, int height) : stones(width, height) {}
+
+      StoneGrid stones;
+      // -1 when there's no last move to mark
+      int lastMoveI = -1;
+      int lastMoveJ = -1;
+      Player nextPlayer = Player::Black;
+      int nbMoves = 0;
+      // The score is only shown once the game is over
+      bool isGameOver = false;
+      int scoreBlack = 0;
+      int scoreWhite = 0;
+   };
+
+   MonitorView(NVGcontext& vg, int nbBoards, int boardWidth, int boardHeight);
+
+   MonitorView(const MonitorView&) = delete;
+   MonitorView& operator=(const MonitorView&) = delete;
+
+   int nbBoards() const { return int(_boards.size()); }
+   const BoardState& board(int index) const { return _boards[index]; }
+   // The board is rendered again at the next prepare
+   BoardState& editBoard(int index);
+
+   // Optional, like the one of the single board view
+   void setShapeCache(ShapeCache* cache) { _context.setShapeCache(cache); }
+
+   // Places the boards in rows and columns, choosing the number of columns which makes them the biggest.
+   // Everything is rendered again when the layout changes
+   void setWindowSize(int winWidth, int winHeight);
+   int squareSize() const { return _context.squareSize(); }
+
+   // Renders the boards which changed, and returns their number. Called before nvgBeginFrame, like render::prepare
+   int prepare(float pxRatio);
+   // Inside nvgBeginFrame/nvgEndFrame. Without framebuffer, every board is drawn again
+   void draw() const;
+   // Needs the GL context, so it must be called before it's destroyed
+   void release();
+
+private:
+   std::pair<float, float> cellOrigin(int index) const;
+   void drawCell(int index) const;
+
+   DrawContext _context;
+   Board _board;
+   StoneSprites _sprites;
+   OffscreenImage _image;
+
+   std::vector<BoardState> _boards;
+   std::vector<unsigned char> _isDirty;
+
+   int _winWidth = 0;
+   int _winHeight = 0;
+   int _nbColumns = 1;
+   int _cellWidth = 0;
+   int _cellHeight = 0;
+};
+
+} // namespace render
@@ -0,0 +1,75 @@
+#include "OffscreenImage.h"
+
+#include <cmath>
+
+#include <GL/glew.h>
+
+#define NANOVG_GL3
+#include <nanovg_gl.h>
+#include <nanovg_gl_utils.h>
+
+namespace render {
+
+namespace
+{
+   int framebufferSize(int size, float pxRatio)
+   {
+      return int(std::ceil(float(size) * pxRatio));
+   }
+}
+
+
+OffscreenImage::~OffscreenImage()
+{
+   release();
+}
+
+bool OffscreenImage::create(NVGcontext& vg, int width, int height, float pxRatio, int imageFlags)
+{
+   release();
+
+   if (framebufferSize(width, pxRatio) <= 0 || framebufferSize(height, pxRatio) <= 0)
+      return false;
+
+   _framebuffer = nvgluCreateFramebuffer(&vg, framebufferSize(width, pxRatio), framebufferSize(height, pxRatio), imageFlags);
+   if (!_framebuffer)
+      return false;
+
+   _vg = &vg;
+   _width = width;
+   _height = height;
+   _pxRatio = pxRatio;
+   return true;
+}
+
+void OffscreenImage::release()
+{
+   nvgluDeleteFramebuffer(_framebuffer);
+   _framebuffer = nullptr;
+   _width = 0;
+   _height = 0;
+}
+
+int OffscreenImage::image() const
+{
+   return _framebuffer ? _framebuffer->image : -1;
+}
+
+void OffscreenImage::beginFrame(bool clear)
+{
+   nvgluBindFramebuffer(_framebuffer);
+   glViewport(0, 0, framebufferSize(_width, _pxRatio), framebufferSize(_height, _pxRatio));
+   glClearColor(0.f, 0.f, 0.f, 0.f);
+   // The stencil is always cleared, nanovg expects it empty at the start of a frame
+   glClear(clear ? GL_COLOR_BUFFER_BIT | GL_STENCIL_BUFFER_BIT : GL_STENCIL_BUFFER_BIT);
+
+   nvgBeginFrame(_vg, _width, _height, _pxRatio);
+}
+
+void OffscreenImage::endFrame()
+{
+   nvgEndFrame(_vg);
+   nvgluBindFramebuffer(nullptr);
+}
+
+} // namespace render
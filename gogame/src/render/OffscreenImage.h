@@ -0,0 +1,44 @@
+#pragma once
+
+#include <nanovg.h>
+
+struct NVGLUframebuffer;
+
+namespace render {
+
+// nanovg image backed by a GL framebuffer : we draw into it once with nanovg, then use it as a paint
+class OffscreenImage
+{
+public:
+   OffscreenImage() {}
+   ~OffscreenImage();
+
+   OffscreenImage(const OffscreenImage&) = delete;
+   OffscreenImage& operator=(const OffscreenImage&) = delete;
+
+   // Size in logical pixels, the framebuffer is scaled by pxRatio. Returns false if it couldn't be created
+   bool create(NVGcontext& vg, int width, int height, float pxRatio, int imageFlags);
+   // Needs the GL context, so it must be called before it's destroyed
+   void release();
+
+   bool isValid() const { return _framebuffer != nullptr; }
+   int image() const;
+   int width() const { return _width; }
+   int height() const { return _height; }
+   float pxRatio() const { return _pxRatio; }
+
+   // Binds the framebuffer, clears it and starts a nanovg frame on it. Must not be called inside another frame.
+   // Without clearing, the frame draws over what the image already holds
+   void beginFrame(bool clear = true);
+   // Ends the nanovg frame and binds the default framebuffer again. The viewport must be set again by the caller
+   void endFrame();
+
+private:
+   NVGcontext* _vg = nullptr;
+   NVGLUframebuffer* _framebuffer = nullptr;
+   int _width = 0;
+   int _height = 0;
+   float _pxRatio = 1.f;
+};
+
+} // namespace render
@@ -0,0 +1,107 @@
+#include "ReplaySlider.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "render/ShapeCache.h"
+
+namespace render {
+
+namespace
+{
+   // Same width as the message frame of the Informations panel
+   constexpr float sliderWidth = 270.f;
+   constexpr float fontSize = 18.f;
+   constexpr float trackY = 30.f;
+   constexpr float trackHeight = 6.f;
+   constexpr float knobRadius = 8.f;
+   // The track can be grabbed a bit above and below it
+   constexpr float grabMargin = 6.f;
+}
+
+void ReplaySlider::setNbMoves(int nbMoves)
+{
+   _nbMoves = (std::max)(0, nbMoves);
+   _move = (std::min)(_move, _nbMoves);
+   updateText();
+}
+
+void ReplaySlider::setMove(int move)
+{
+   move = (std::max)(0, (std::min)(move, _nbMoves));
+   if (move == _move)
+      return;
+
+   _move = move;
+   updateText();
+}
+
+void ReplaySlider::setCaption(const std::string& caption)
+{
+   _caption = caption;
+   updateText();
+}
+
+void ReplaySlider::updateText()
+{
+   _text = "Move " + std::to_string(_move) + " / " + std::to_string(_nbMoves);
+   if (!_caption.empty())
+      _text += "   " + _caption;
+}
+
+bool ReplaySlider::contains(float x, float y) const
+{
+   const auto localX = x - _origin.first;
+   const auto localY = y - _origin.second;
+   return localX >= -knobRadius && localX <= sliderWidth + knobRadius
+      && localY >= trackY - knobRadius - grabMargin && localY <= trackY + knobRadius + grabMargin;
+}
+
+int ReplaySlider::moveAt(float x) const
+{
+   const auto ratio = (std::max)(0.f, (std::min)((x - _origin.first) / sliderWidth, 1.f));
+   return int(std::lround(ratio * float(_nbMoves)));
+}
+
+void ReplaySlider::draw(const DrawContext& context) const
+{
+   auto vg = &context.vgContext();
+
+   nvgFontSize(vg, fontSize);
+   nvgFontFace(vg, "sans");
+   nvgFillColor(vg, textColor());
+   nvgTextAlign(vg, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
+   nvgText(vg, 0.f, 0.f, _text.data(), _text.data() + _text.size());
+
+   const auto ratio = _nbMoves > 0 ? float(_move) / float(_nbMoves) : 0.f;
+   const auto knobX = ratio * sliderWidth;
+   const auto top = trackY - trackHeight * .5f;
+
+   nvgFillColor(vg, frameColor());
+   fillRoundedRect(context, 0.f, top, sliderWidth, trackHeight, trackHeight * .5f);
+   if (knobX > 0.f)
+   {
+      // The played part is the whole track cut at the knob : a rectangle as wide as the knob position would be a new
+      // shape cache entry at each move, and scrubbing would fill the cache and flush it
+      nvgSave(vg);
+      nvgIntersectScissor(vg, 0.f, top, knobX, trackHeight);
+      nvgFillColor(vg, boardColor());
+      fillRoundedRect(context, 0.f, top, sliderWidth, trackHeight, trackHeight * .5f);
+      nvgRestore(vg);
+   }
+
+   nvgFillColor(vg, textColor());
+   fillCircle(context, knobX, trackY, knobRadius);
+}
+
+float ReplaySlider::width()
+{
+   return sliderWidth;
+}
+
+float ReplaySlider::height()
+{
+   return trackY + knobRadius;
+}
+
+} // namespace render
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <utility>
+
+#include "render/DrawableItem.h"
+#include "render/utilities.h"
+
+namespace render {
+
+// Move slider of the replay : a track, the part of the game already played, a knob on the current move and the move
+// number above them. It's drawn at its origin like the Informations panel, and keeps that origin to turn a mouse
+// position into a move
+class ReplaySlider : public DrawableItem
+{
+public:
+   void setNbMoves(int nbMoves);
+   void setMove(int move);
+   int nbMoves() const { return _nbMoves; }
+   int move() const { return _move; }
+   // Shown after the move number, e.g. the game of the collection
+   void setCaption(const std::string& caption);
+
+   // In window coordinates
+   void setOrigin(float x, float y) { _origin = std::make_pair(x, y); }
+   std::pair<float, float> origin() const { return _origin; }
+
+   // Whether the window position is on the track, the text above excluded
+   bool contains(float x, float y) const;
+   // Move under the window position x, clamped to the game : while dragging, the mouse can leave the track
+   int moveAt(float x) const;
+
+   virtual void draw(const DrawContext& context) const override;
+
+   static float width();
+   static float height();
+
+private:
+   void updateText();
+
+   int _nbMoves = 0;
+   int _move = 0;
+   std::string _caption;
+   std::pair<float, float> _origin = { 0.f, 0.f };
+
+   // Formatted when the move changes, not at each frame
+   std::string _text = "0 / 0";
+};
+
+} // namespace render
@@ -0,0 +1,117 @@
+#include "ShapeCache.h"
+
+#include "render/DrawContext.h"
+
+namespace render {
+
+namespace
+{
+   // A game uses a handful of shapes, more means the window was resized many times
+   constexpr size_t maxEntries = 32;
+}
+
+ShapeCache::~ShapeCache()
+{
+   clear();
+}
+
+const NVGcachedPath* ShapeCache::circle(NVGcontext& vg, float r)
+{
+   return find(vg, Shape::Circle, r, r, r);
+}
+
+const NVGcachedPath* ShapeCache::roundedRect(NVGcontext& vg, float w, float h, float r)
+{
+   return find(vg, Shape::RoundedRect, w, h, r);
+}
+
+void ShapeCache::clear()
+{
+   for (auto& entry : _entries)
+      nvgDeleteCachedPath(entry.path);
+   _entries.clear();
+}
+
+const NVGcachedPath* ShapeCache::find(NVGcontext& vg, Shape shape, float w, float h, float r)
+{
+   auto entry = _entries.begin();
+   while (entry != _entries.end() && (entry->shape != shape || entry->w != w || entry->h != h || entry->r != r))
+      ++entry;
+
+   if (entry != _entries.end() && nvgCachedPathMatches(&vg, entry->path))
+      return entry->path;
+
+   nvgBeginPath(&vg);
+   if (shape == Shape::Circle)
+      nvgCircle(&vg, 0.f, 0.f, r);
+   else
+      nvgRoundedRect(&vg, 0.f, 0.f, w, h, r);
+   auto path = nvgCacheFill(&vg, 0.f, 0.f);
+   nvgBeginPath(&vg);
+
+   if (nullptr == path)
+      return nullptr;
+   _nbTessellations++;
+
+   if (entry != _entries.end())
+   {
+      nvgDeleteCachedPath(entry->path);
+      entry->path = path;
+   }
+   else
+   {
+      if (_entries.size() >= maxEntries)
+         clear();
+      _entries.push_back({ shape, w, h, r, path });
+   }
+   return path;
+}
+
+void fillCircle(const DrawContext& context, float cx, float cy, float r)
+{
+   auto vg = &context.vgContext();
+   auto cache = context.shapeCache();
+   auto path = cache ? cache->circle(*vg, r) : nullptr;
+   if (path)
+   {
+      const float position[] = { cx, cy };
+      nvgFillCachedPath(vg, path, position, 1);
+      cache->addReplays(1);
+   }
+   else
+   {
+      nvgBeginPath(vg);
+      nvgCircle(vg, cx, cy, r);
+      nvgFill(vg);
+   }
+}
+
+void fillRoundedRect(const DrawContext& context, float x, float y, float w, float h, float r)
+{
+   const float position[] = { x, y };
+   fillRoundedRects(context, position, 1, w, h, r);
+}
+
+void fillRoundedRects(const DrawContext& context, const float* positions, int count, float w, float h, float r)
+{
+   if (count <= 0)
+      return;
+
+   auto vg = &context.vgContext();
+   auto cache = context.shapeCache();
+   auto path = cache ? cache->roundedRect(*vg, w, h, r) : nullptr;
+   if (path)
+   {
+      nvgFillCachedPath(vg, path, positions, count);
+      cache->addReplays(count);
+   }
+   else
+   {
+      nvgBeginPath(vg);
+      for (int i = 0; i < count; ++i)
+         nvgRoundedRect(vg, positions[2 * i], positions[2 * i + 1], w, h, r);
+      nvgFill(vg);
+   }
+}
+
+} // namespace render
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <vector>
+
+#include <nanovg.h>
+
+namespace render {
+
+class DrawContext;
+
+// Circles and rounded rectangles tessellated once, then replayed with a translation (see nvgFillCachedPath). A shape
+// is keyed by its geometry, and tessellated again when the scale of the transform or the pixel ratio change
+class ShapeCache
+{
+public:
+   ShapeCache() = default;
+   ShapeCache(const ShapeCache&) = delete;
+   ShapeCache& operator=(const ShapeCache&) = delete;
+   ~ShapeCache();
+
+   // Circle of radius r centered on (0, 0)
+   const NVGcachedPath* circle(NVGcontext& vg, float r);
+   // Rounded rectangle with its top-left corner on (0, 0)
+   const NVGcachedPath* roundedRect(NVGcontext& vg, float w, float h, float r);
+
+   void clear();
+
+   unsigned long long int nbTessellations() const { return _nbTessellations; }
+   unsigned long long int nbReplays() const { return _nbReplays; }
+   void addReplays(int count) { _nbReplays += count; }
+
+private:
+   enum class Shape { Circle, RoundedRect };
+
+   struct Entry
+   {
+      Shape shape;
+      float w;
+      float h;
+      float r;
+      NVGcachedPath* path;
+   };
+
+   const NVGcachedPath* find(NVGcontext& vg, Shape shape, float w, float h, float r);
+
+   std::vector<Entry> _entries;
+   unsigned long long int _nbTessellations = 0;
+   unsigned long long int _nbReplays = 0;
+};
+
+// These fill with the current fill paint, through the shape cache of the context when it has one
+
+void fillCircle(const DrawContext& context, float cx, float cy, float r);
+void fillRoundedRect(const DrawContext& context, float x, float y, float w, float h, float r);
+// All the rectangles in a single fill, 'positions' holds the (x, y) pairs of their top-left corners
+void fillRoundedRects(const DrawContext& context, const float* positions, int count, float w, float h, float r);
+
+} // namespace render
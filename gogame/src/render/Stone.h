@@ -13,10 +13,17 @@ public:
 
    virtual void draw(const DrawContext& context) const override;
 
+   int posX() const { return _posX; }
+   int posY() const { return _posY; }
+   Player player() const { return _player; }
+
 private:
    int _posX;
    int _posY;
    Player _player;
 };
 
+// Draws a stone centered on (x, y), with its shadow
+void drawStoneShape(float x, float y, Player player, const DrawContext& context);
+
 } // namespace render
@@ -0,0 +1,36 @@
+#include "StoneGrid.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace render {
+
+void StoneGrid::clear()
+{
+   std::fill(_cells.begin(), _cells.end(), Cell::Empty);
+   _stoneCount = 0;
+}
+
+void StoneGrid::setStone(int i, int j, Player player)
+{
+   assert(i >= 0 && i < _width && j >= 0 && j < _height);
+
+   auto& cell = _cells[j * _width + i];
+   if (cell == Cell::Empty)
+      _stoneCount++;
+
+   cell = (player == Player::White) ? Cell::White : Cell::Black;
+}
+
+void StoneGrid::removeStone(int i, int j)
+{
+   assert(i >= 0 && i < _width && j >= 0 && j < _height);
+
+   auto& cell = _cells[j * _width + i];
+   if (cell != Cell::Empty)
+      _stoneCount--;
+
+   cell = Cell::Empty;
+}
+
+} // namespace render
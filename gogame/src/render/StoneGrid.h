@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+
+#include "render/Stone.h"
+#include "render/utilities.h"
+
+namespace render {
+
+// Stones of a board, one cell per intersection. A move only touches the cells it changed
+class StoneGrid
+{
+public:
+   StoneGrid(int width, int height) : _width(width), _height(height), _cells(width * height, Cell::Empty) {}
+
+   void clear();
+   void setStone(int i, int j, Player player);
+   void removeStone(int i, int j);
+
+   int stoneCount() const { return _stoneCount; }
+
+   template <typename Function>
+   void forEachStone(Function function) const
+   {
+      if (_stoneCount == 0)
+         return;
+
+      for (int j = 0; j < _height; ++j)
+      {
+         for (int i = 0; i < _width; ++i)
+         {
+            const auto cell = _cells[j * _width + i];
+            if (cell != Cell::Empty)
+               function(Stone(i, j, (cell == Cell::White) ? Player::White : Player::Black));
+         }
+      }
+   }
+
+private:
+   enum class Cell : unsigned char
+   {
+      Empty, White, Black
+   };
+
+   int _width;
+   int _height;
+   std::vector<Cell> _cells;
+   int _stoneCount = 0;
+};
+
+} // namespace render
@@ -0,0 +1,201 @@
+#include "StoneLayer.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace render {
+
+namespace
+{
+   // A quad around each stone, large enough for its shadow. Built from the vertex index, so there's no vertex buffer
+   const char* vertexShader = R"(
+#version 150 core
+uniform vec2 viewSize;
+in vec4 instance;
+out vec2 localPos;
+flat out float isWhite;
+
+const float quadExtent = 1.25;
+
+void main()
+{
+   vec2 corner = vec2(float(gl_VertexID & 1), float(gl_VertexID >> 1)) * 2.0 - 1.0;
+   localPos = corner * quadExtent;
+   isWhite = instance.w;
+
+   vec2 pos = instance.xy + localPos * instance.z;
+   gl_Position = vec4(2.0 * pos.x / viewSize.x - 1.0, 1.0 - 2.0 * pos.y / viewSize.y, 0.0, 1.0);
+}
+)";
+
+   // Same layers as the nanovg stone (shadow, body, inner gradient, specular), in stone radius units.
+   // Colors are premultiplied, like nanovg's
+   const char* fragmentShader = R"(
+#version 150 core
+in vec2 localPos;
+flat in float isWhite;
+out vec4 outColor;
+
+vec4 over(vec4 src, vec4 dst) { return src + dst * (1.0 - src.a); }
+vec4 premul(vec3 color, float alpha) { return vec4(color * alpha, alpha); }
+float disc(vec2 center, float aa) { return clamp((1.0 - length(localPos - center)) / aa + 0.5, 0.0, 1.0); }
+
+void main()
+{
+   float aa = fwidth(localPos.x);
+
+   vec2 lightOffset = vec2(0.1, 0.15);
+   vec2 gradientStart = lightOffset - 1.0;
+   vec2 gradientDir = vec2(2.0);
+   float t = clamp(dot(localPos - gradientStart, gradientDir) / dot(gradientDir, gradientDir), 0.0, 1.0);
+
+   float shadow = disc(lightOffset, aa) * mix(1.0, 32.0 / 255.0, t);
+   vec4 color = premul(vec3(32.0 / 255.0), shadow);
+
+   float body = disc(vec2(0.0), aa);
+   color = over(premul(mix(vec3(5.0 / 255.0), vec3(242.0 / 255.0), isWhite), body), color);
+
+   float inner = body * mix(60.0 / 255.0, 0.0, t);
+   color = over(premul(vec3(mix(192.0 / 255.0, 0.0, isWhite)), inner), color);
+
+   float s = clamp((length(localPos - vec2(-0.5, -0.35)) - 0.02) / 0.88, 0.0, 1.0);
+   float specular = body * mix(227.0 / 255.0, 0.0, s);
+   color = over(premul(vec3(mix(128.0 / 255.0, 1.0, isWhite)), specular), color);
+
+   outColor = color;
+}
+)";
+
+   GLuint compileShader(GLenum type, const char* source)
+   {
+      auto shader = glCreateShader(type);
+      glShaderSource(shader, 1, &source, nullptr);
+      glCompileShader(shader);
+
+      GLint status;
+      glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+      if (status != GL_TRUE)
+      {
+         char log[512];
+         glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+         std::cerr << "Stone layer shader error : " << log << std::endl;
+         glDeleteShader(shader);
+         return 0;
+      }
+      return shader;
+   }
+}
+
+
+StoneLayer::~StoneLayer()
+{
+   release();
+}
+
+bool StoneLayer::init()
+{
+   release();
+
+   // glDrawArraysInstanced is GL 3.1, glVertexAttribDivisor GL 3.3
+   if (!GLEW_VERSION_3_3 && !(GLEW_VERSION_3_1 && GLEW_ARB_instanced_arrays))
+      return false;
+
+   auto vertex = compileShader(GL_VERTEX_SHADER, vertexShader);
+   auto fragment = compileShader(GL_FRAGMENT_SHADER, fragmentShader);
+   if (vertex == 0 || fragment == 0)
+   {
+      glDeleteShader(vertex);
+      glDeleteShader(fragment);
+      return false;
+   }
+
+   _program = glCreateProgram();
+   glAttachShader(_program, vertex);
+   glAttachShader(_program, fragment);
+   glBindAttribLocation(_program, 0, "instance");
+   glLinkProgram(_program);
+   glDeleteShader(vertex);
+   glDeleteShader(fragment);
+
+   GLint status;
+   glGetProgramiv(_program, GL_LINK_STATUS, &status);
+   if (status != GL_TRUE)
+   {
+      release();
+      return false;
+   }
+
+   _viewSizeLocation = glGetUniformLocation(_program, "viewSize");
+
+   glGenVertexArrays(1, &_vertexArray);
+   glGenBuffers(1, &_instanceBuffer);
+
+   glBindVertexArray(_vertexArray);
+   glBindBuffer(GL_ARRAY_BUFFER, _instanceBuffer);
+   glEnableVertexAttribArray(0);
+   glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), nullptr);
+   glVertexAttribDivisor(0, 1);
+   glBindVertexArray(0);
+   glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+   return true;
+}
+
+void StoneLayer::release()
+{
+   if (_program != 0)
+      glDeleteProgram(_program);
+   if (_vertexArray != 0)
+      glDeleteVertexArrays(1, &_vertexArray);
+   if (_instanceBuffer != 0)
+      glDeleteBuffers(1, &_instanceBuffer);
+
+   _program = 0;
+   _vertexArray = 0;
+   _instanceBuffer = 0;
+   _instanceBufferSize = 0;
+   _instances.clear();
+}
+
+void StoneLayer::addStone(float x, float y, float radius, Player player)
+{
+   _instances.push_back({ x, y, radius, (player == Player::White) ? 1.f : 0.f });
+}
+
+void StoneLayer::draw(int winWidth, int winHeight)
+{
+   if (!isValid() || _instances.empty())
+   {
+      _instances.clear();
+      return;
+   }
+
+   glBindBuffer(GL_ARRAY_BUFFER, _instanceBuffer);
+   const auto size = _instances.size() * sizeof(Instance);
+   if (size > _instanceBufferSize)
+      _instanceBufferSize = (std::max)(size, 2 * _instanceBufferSize);
+
+   // Orphaning : the driver gives us new storage instead of waiting for the previous frame to be done with it
+   glBufferData(GL_ARRAY_BUFFER, _instanceBufferSize, nullptr, GL_STREAM_DRAW);
+   glBufferSubData(GL_ARRAY_BUFFER, 0, size, _instances.data());
+
+   glUseProgram(_program);
+   glUniform2f(_viewSizeLocation, float(winWidth), float(winHeight));
+
+   glEnable(GL_BLEND);
+   glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+   glDisable(GL_CULL_FACE);
+   glDisable(GL_DEPTH_TEST);
+   glDisable(GL_STENCIL_TEST);
+
+   glBindVertexArray(_vertexArray);
+   glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, GLsizei(_instances.size()));
+   glBindVertexArray(0);
+
+   glUseProgram(0);
+   glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+   _instances.clear();
+}
+
+} // namespace render
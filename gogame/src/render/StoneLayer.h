@@ -0,0 +1,55 @@
+#pragma once
+
+#include <vector>
+
+#include <GL/glew.h>
+
+#include "render/utilities.h"
+
+namespace render {
+
+// Draws every stone of every board with a single instanced draw call, without nanovg. The shadow, the body and the
+// specular highlights are computed in the fragment shader. The stones are queued while the models are drawn, then
+// the layer is drawn over the nanovg frame
+class StoneLayer
+{
+public:
+   StoneLayer() {}
+   ~StoneLayer();
+
+   StoneLayer(const StoneLayer&) = delete;
+   StoneLayer& operator=(const StoneLayer&) = delete;
+
+   // Compiles the shaders and creates the buffers. Returns false if the GL context can't draw instances
+   bool init();
+   // Needs the GL context, so it must be called before it's destroyed
+   void release();
+
+   bool isValid() const { return _program != 0; }
+
+   // Window coordinates, in logical pixels
+   void addStone(float x, float y, float radius, Player player);
+
+   // Uploads the queued stones, draws them on the bound framebuffer and empties the queue.
+   // Must be called after nvgEndFrame, nanovg sets its own GL state again at the next frame
+   void draw(int winWidth, int winHeight);
+
+private:
+   struct Instance
+   {
+      float x;
+      float y;
+      float radius;
+      float isWhite;
+   };
+
+   std::vector<Instance> _instances;
+
+   GLuint _program = 0;
+   GLuint _vertexArray = 0;
+   GLuint _instanceBuffer = 0;
+   GLint _viewSizeLocation = -1;
+   size_t _instanceBufferSize = 0;
+};
+
+} // namespace render
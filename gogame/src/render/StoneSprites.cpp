@@ -0,0 +1,79 @@
+#include "StoneSprites.h"
+
+#include <nanovg.h>
+
+namespace render {
+
+namespace
+{
+   bool renderSprite(OffscreenImage& sprite, Player player, const DrawContext& context, float pxRatio)
+   {
+      const auto squareSize = context.squareSize();
+      if (!sprite.create(context.vgContext(), squareSize, squareSize, pxRatio, NVG_IMAGE_REPEATX | NVG_IMAGE_REPEATY))
+         return false;
+
+      const auto center = context.squareSizeF() * .5f;
+
+      sprite.beginFrame();
+      drawStoneShape(center, center, player, context);
+      sprite.endFrame();
+
+      return true;
+   }
+
+   void fillStones(const OffscreenImage& sprite, Player player, const DrawContext& context, const StoneGrid& stones)
+   {
+      auto vg = &context.vgContext();
+      const auto squareSize = context.squareSizeF();
+      const auto halfSquare = squareSize * .5f;
+
+      bool isEmpty = true;
+      nvgBeginPath(vg);
+      stones.forEachStone([&](const Stone& stone) {
+         if (stone.player() != player)
+            return;
+
+         nvgRect(vg, float(stone.posX()) * squareSize - halfSquare, float(stone.posY()) * squareSize - halfSquare, squareSize, squareSize);
+         isEmpty = false;
+      });
+
+      if (isEmpty)
+         return;
+
+      // The pattern repeats the sprite on every intersection, the rectangles only select the ones with a stone
+      nvgFillPaint(vg, nvgImagePattern(vg, -halfSquare, -halfSquare, squareSize, squareSize, 0.f, sprite.image(), 1.f));
+      nvgFill(vg);
+   }
+}
+
+
+void StoneSprites::prepare(const DrawContext& context, float pxRatio)
+{
+   if (_cachedSquareSize == context.squareSize() && _blackSprite.pxRatio() == pxRatio)
+      return;
+
+   _cachedSquareSize = 0;
+   if (!renderSprite(_blackSprite, Player::Black, context, pxRatio) || !renderSprite(_whiteSprite, Player::White, context, pxRatio))
+      return;
+
+   _cachedSquareSize = context.squareSize();
+}
+
+void StoneSprites::release()
+{
+   _blackSprite.release();
+   _whiteSprite.release();
+   _cachedSquareSize = 0;
+}
+
+bool StoneSprites::draw(const DrawContext& context, const StoneGrid& stones) const
+{
+   if (_cachedSquareSize != context.squareSize())
+      return false;
+
+   fillStones(_blackSprite, Player::Black, context, stones);
+   fillStones(_whiteSprite, Player::White, context, stones);
+   return true;
+}
+
+} // namespace render
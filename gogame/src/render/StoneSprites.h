@@ -0,0 +1,29 @@
+#pragma once
+
+#include "render/DrawContext.h"
+#include "render/OffscreenImage.h"
+#include "render/StoneGrid.h"
+
+namespace render {
+
+// Black and white stones rendered once per square size. Each sprite is a tile of one square with the stone at its
+// center, repeated on the whole board : all the stones of a color are drawn with a single fill
+class StoneSprites
+{
+public:
+   // Must be called outside of nvgBeginFrame/nvgEndFrame
+   void prepare(const DrawContext& context, float pxRatio);
+   void release();
+   // The next prepare renders the sprites again
+   void invalidate() { _cachedSquareSize = 0; }
+
+   // Returns false if the sprites aren't ready for the current square size, the stones must be drawn one by one then
+   bool draw(const DrawContext& context, const StoneGrid& stones) const;
+
+private:
+   OffscreenImage _blackSprite;
+   OffscreenImage _whiteSprite;
+   int _cachedSquareSize = 0;
+};
+
+} // namespace render
@@ -0,0 +1,48 @@
+#include "TextLayout.h"
+
+namespace render {
+
+void TextBoxLayout::update(NVGcontext& vg, const std::string& text, const char* font, float size, float width)
+{
+   nvgFontSize(&vg, size);
+   nvgFontFace(&vg, font);
+   nvgTextAlign(&vg, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
+
+   if (_isValid && _size == size && _width == width && _font == font && _text == text)
+      return;
+
+   _text = text;
+   _font = font;
+   _size = size;
+   _width = width;
+   _lines.clear();
+
+   nvgTextMetrics(&vg, nullptr, nullptr, &_lineHeight);
+
+   // Same breaking as nvgTextBox
+   const char* begin = _text.data();
+   const char* end = begin + _text.size();
+   const char* current = begin;
+   NVGtextRow rows[4];
+   int nbRows;
+   while ((nbRows = nvgTextBreakLines(&vg, current, end, width, rows, 4)) > 0)
+   {
+      for (int i = 0; i < nbRows; ++i)
+         _lines.push_back({ size_t(rows[i].start - begin), size_t(rows[i].end - begin) });
+      current = rows[nbRows - 1].next;
+   }
+
+   _isValid = true;
+}
+
+void TextBoxLayout::draw(NVGcontext& vg, float x, float y) const
+{
+   const char* text = _text.data();
+   for (auto&& line : _lines)
+   {
+      nvgText(&vg, x, y, text + line.begin, text + line.end);
+      y += _lineHeight;
+   }
+}
+
+} // namespace render
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <nanovg.h>
+
+namespace render {
+
+// Line breaks of a text box, kept between frames. They're computed again only when the text, the font, the size or
+// the width of the box change : drawing the box is then one nvgText per line, without reflowing the text
+class TextBoxLayout
+{
+public:
+   // Sets the font state and updates the lines if needed. The text is copied
+   void update(NVGcontext& vg, const std::string& text, const char* font, float size, float width);
+   // Draws the lines, left aligned, with the font state set by update
+   void draw(NVGcontext& vg, float x, float y) const;
+
+private:
+   struct Line
+   {
+      size_t begin;
+      size_t end;
+   };
+
+   std::string _text;
+   std::string _font;
+   float _size = 0.f;
+   float _width = 0.f;
+   float _lineHeight = 0.f;
+   bool _isValid = false;
+   std::vector<Line> _lines;
+};
+
+} // namespace render
@@ -44,15 +44,13 @@ constexpr auto pickColor(PickColor pickColor)
    }
 }
 
+constexpr NVGcolor backgroundColor() { return color(77, 77, 82); }
 constexpr NVGcolor boardColor() { return color(192, 150, 102); };
+constexpr NVGcolor lineColor() { return color(27, 27, 27); }
+// In pixels, whatever the square size
+constexpr float lineWidth() { return 2.f; }
 constexpr NVGcolor frameColor() { return color(105, 105, 105); };
 constexpr NVGcolor scoreFrameColor() { return color(75, 75, 75); }
 constexpr NVGcolor textColor(){ return color(215, 215, 215); }
 
-float boardOrigin(const DrawContext& context);
-
-int squareSizeFromCanvasSize(int winWidth, int winHeight, const DrawContext& context);
-
-std::pair<int, int> squarePosFromScreenPos(int windowX, int windowY, const DrawContext& context);
-
 } // namespace render
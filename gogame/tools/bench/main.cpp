@@ -0,0 +1,519 @@
+// Microbenchmarks of the logic layer : the time and the allocations of each GameState operation, on positions of
+// 9x9, 13x13 and 19x19 boards and on whole games. The positions are generated from a seed (0 by default), so two runs (or two
+// commits) measure the same work. The results can be written as JSON, to compare them from one commit to the next
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "logic/GameRecord.h"
+#include "logic/GameState.h"
+#include "logic/Random.h"
+
+namespace
+{
+	// Every allocation of the process goes through the operator new below. The benchmarks run on the main thread only
+	unsigned long long nbAllocations = 0;
+}
+
+void* operator new(std::size_t size)
+{
+	nbAllocations++;
+	if (void* pointer = std::malloc(size > 0 ? size : 1))
+		return pointer;
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete[](void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	struct Options
+	{
+		std::vector<std::string> gameFiles;
+		// Minimum measured time by benchmark
+		double minSeconds = 0.2;
+		// Only the benchmarks whose name contains it
+		std::string filter;
+		std::vector<int> boardSizes = { 9, 13, 19 };
+		// Empty for no JSON, "-" for the standard output
+		std::string jsonFile;
+		// Seed of the random games and of the Zobrist keys
+		unsigned long long seed = 0;
+	};
+
+	struct Result
+	{
+		std::string name;
+		int boardSize = 0;
+		unsigned long long nbOps = 0;
+		double nsPerOp = 0.;
+		double allocationsPerOp = 0.;
+	};
+
+	// Tells the stream of the random games apart from the other uses of the seed
+	constexpr unsigned long long positionSalt = 2;
+	// States copied before a batch of operations which modify them : the copies aren't measured
+	constexpr int batchSize = 64;
+
+	void printUsage()
+	{
+		std::cerr << "Usage: gogame_bench [options] [file.sgf ...]\n"
+			<< "  --time <s>       minimum measured time by benchmark (default 0.2)\n"
+			<< "  --filter <text>  only the benchmarks whose name contains it\n"
+			<< "  --size <n>       only this board size (default 9, 13 and 19)\n"
+			<< "  --json <file>    writes the results as JSON, - for the standard output\n"
+			<< "  --seed <n>       seed of the random games and of the hashes (default 0)\n"
+			<< "The games of the SGF files are replayed as benchmarks of their own\n";
+	}
+
+	Options parseOptions(int argc, char** argv)
+	{
+		Options options;
+		for (int i = 1; i < argc; ++i)
+		{
+			std::string arg = argv[i];
+			if (arg == "--time" && i + 1 < argc)
+				options.minSeconds = std::max(0.001, std::stod(argv[++i]));
+			else if (arg == "--filter" && i + 1 < argc)
+				options.filter = argv[++i];
+			else if (arg == "--size" && i + 1 < argc)
+				options.boardSizes = { std::max(2, std::stoi(argv[++i])) };
+			else if (arg == "--json" && i + 1 < argc)
+				options.jsonFile = argv[++i];
+			else if (arg == "--seed" && i + 1 < argc)
+				options.seed = std::stoull(argv[++i]);
+			else if (!arg.empty() && arg[0] == '-')
+				throw std::runtime_error("Unknown option " + arg);
+			else
+				options.gameFiles.push_back(arg);
+		}
+		return options;
+	}
+
+	// The table goes to the error output when the JSON takes the standard one
+	void printResult(const Options& options, const Result& result)
+	{
+		auto& output = (options.jsonFile == "-") ? std::cerr : std::cout;
+		const auto size = std::to_string(result.boardSize) + "x" + std::to_string(result.boardSize);
+		output << std::left << std::setw(32) << result.name << std::setw(6) << size << std::right << std::fixed
+			<< std::setprecision(1) << std::setw(12) << result.nsPerOp << " ns/op"
+			<< std::setprecision(2) << std::setw(10) << result.allocationsPerOp << " allocs/op"
+			<< std::setw(12) << result.nbOps << " ops" << std::endl;
+	}
+
+	// Runs 'prepare' (not measured) then 'run' (measured) until the minimum time is reached. 'run' returns the number
+	// of operations it did. A first round warms the caches and the tables built on first use, like the Zobrist keys
+	template <typename Prepare, typename Run>
+	Result measure(const std::string& name, int boardSize, double minSeconds, Prepare prepare, Run run)
+	{
+		prepare();
+		run();
+
+		Result result;
+		result.name = name;
+		result.boardSize = boardSize;
+
+		double seconds = 0.;
+		unsigned long long allocations = 0;
+		while (seconds < minSeconds)
+		{
+			prepare();
+			const auto allocationsBefore = nbAllocations;
+			const auto start = Clock::now();
+			result.nbOps += run();
+			seconds += std::chrono::duration<double>(Clock::now() - start).count();
+			allocations += nbAllocations - allocationsBefore;
+		}
+
+		result.nsPerOp = seconds * 1e9 / double(std::max(1ull, result.nbOps));
+		result.allocationsPerOp = double(allocations) / double(std::max(1ull, result.nbOps));
+		return result;
+	}
+
+	// Same operation on batchSize copies of a state, which the operation modifies
+	template <typename Operation>
+	Result measureOnCopies(const std::string& name, const logic::GameState& state, double minSeconds, Operation operation)
+	{
+		std::vector<logic::GameState> copies;
+		return measure(name, state.getBoardDimensionX(), minSeconds,
+			[&] { copies.assign(batchSize, state); },
+			[&] {
+				for (int i = 0; i < batchSize; ++i)
+					operation(copies[i], i);
+				return static_cast<unsigned long long>(batchSize);
+			});
+	}
+
+	// A move of our random players doesn't fill one of their own eyes : an empty point surrounded by their stones
+	bool isOwnEye(const logic::Board& board, logic::Position pos, logic::Stone stone)
+	{
+		const logic::Position neighbours[] = { logic::getNorthPosition(pos), logic::getSouthPosition(pos), logic::getWestPosition(pos), logic::getEastPosition(pos) };
+		for (const auto& neighbour : neighbours)
+		{
+			if (board.isPositionInsideBoard(neighbour) && board.getStoneAt(neighbour) != stone)
+				return false;
+		}
+		return true;
+	}
+
+	// Plays random moves until 'nbMoves' are played, or until a player has no move left (a finished game then).
+	// The moves are appended to 'record' if it's given
+	void playRandomMoves(logic::GameState& state, int nbMoves, logic::CounterRandom& prng, logic::GameRecord* record = nullptr)
+	{
+		const auto sizeX = state.getBoardDimensionX();
+		const auto sizeY = state.getBoardDimensionY();
+		std::vector<logic::Position> candidates;
+
+		for (int move = 0; move < nbMoves; ++move)
+		{
+			const auto& board = state.getBoard();
+			const auto stone = logic::playerToStone(state.getCurrentPlayer());
+			candidates.clear();
+			for (int y = 0; y < sizeY; ++y)
+			{
+				for (int x = 0; x < sizeX; ++x)
+				{
+					if (board.noStoneAtPosition({ x, y }) && !isOwnEye(board, { x, y }, stone))
+						candidates.push_back({ x, y });
+				}
+			}
+			// std::shuffle isn't the same on every standard library, the positions would differ from one compiler to the other
+			for (size_t i = candidates.size(); i > 1; --i)
+				std::swap(candidates[i - 1], candidates[prng.nextBelow(i)]);
+
+			const auto player = state.getCurrentPlayer();
+			const auto played = std::find_if(candidates.begin(), candidates.end(), [&](logic::Position pos) { return state.putStoneAtPosition(pos); });
+			if (played == candidates.end())
+				return;
+
+			if (record)
+				record->moves.push_back({ player, false, *played });
+		}
+	}
+
+	// Legal moves of the position, a few of them spread on the board
+	std::vector<logic::Position> sampleLegalMoves(logic::GameState state, int maxMoves)
+	{
+		std::vector<logic::Position> moves;
+		const auto sizeX = state.getBoardDimensionX();
+		const auto sizeY = state.getBoardDimensionY();
+		const auto nbPoints = sizeX * sizeY;
+		// A step prime with the usual board sizes, to visit the points in a scattered order
+		for (int k = 0, i = 0; k < nbPoints && int(moves.size()) < maxMoves; ++k, i = (i + 7) % nbPoints)
+		{
+			const logic::Position pos{ i % sizeX, i / sizeX };
+			if (state.precomputeStonePlacement(pos))
+				moves.push_back(pos);
+		}
+		return moves;
+	}
+
+	// Plays a stone of the given color, whoever's turn it is
+	void placeStone(logic::GameState& state, logic::Player player, logic::Position pos)
+	{
+		if (state.getCurrentPlayer() != player)
+			state.changePlayer();
+		if (!state.putStoneAtPosition(pos))
+			throw std::runtime_error("Can't build the benchmark position");
+	}
+
+	// Two black chains of half a column each, on both sides of the empty middle point. Black plays there to merge them
+	logic::GameState mergePosition(int size, logic::Position& mergeMove)
+	{
+		logic::GameState state{ size, size };
+		for (int y = 0; y < size; ++y)
+		{
+			if (y != size / 2)
+				placeStone(state, logic::Player::BLACK, { 2, y });
+		}
+		if (state.getCurrentPlayer() != logic::Player::BLACK)
+			state.changePlayer();
+		mergeMove = { 2, size / 2 };
+		return state;
+	}
+
+	// A black chain on the second column, surrounded by white stones but for its last point. White plays there to
+	// capture the size - 1 stones
+	logic::GameState capturePosition(int size, logic::Position& captureMove)
+	{
+		logic::GameState state{ size, size };
+		for (int y = 0; y < size - 1; ++y)
+			placeStone(state, logic::Player::BLACK, { 1, y });
+		for (int y = 0; y < size; ++y)
+			placeStone(state, logic::Player::WHITE, { 2, y });
+		for (int y = 0; y < size - 1; ++y)
+			placeStone(state, logic::Player::WHITE, { 0, y });
+		if (state.getCurrentPlayer() != logic::Player::WHITE)
+			state.changePlayer();
+		captureMove = { 1, size - 1 };
+		return state;
+	}
+
+	// Replays the games from the start, the operation is a move
+	Result measureReplay(const std::string& name, const std::vector<logic::GameRecord>& games, double minSeconds)
+	{
+		return measure(name, games.front().sizeX, minSeconds, [] {}, [&] {
+			unsigned long long nbMoves = 0;
+			for (const auto& game : games)
+			{
+				logic::GameState state{ game.sizeX, game.sizeY };
+				for (const auto& move : game.moves)
+				{
+					if (move.player != state.getCurrentPlayer())
+						state.changePlayer();
+					if (move.isPass)
+						state.pass();
+					else if (!state.putStoneAtPosition(move.pos))
+						break;
+					nbMoves++;
+				}
+			}
+			return nbMoves;
+		});
+	}
+
+	void runBoardBenchmarks(int size, const Options& options, std::vector<Result>& results)
+	{
+		auto isSelected = [&](const std::string& name) { return options.filter.empty() || name.find(options.filter) != std::string::npos; };
+		auto add = [&](const Result& result) {
+			results.push_back(result);
+			printResult(options, result);
+		};
+
+		// One stream by board size : a size gets the same positions whatever the others measured
+		logic::CounterRandom prng{ logic::CounterRandom::streamKey(logic::CounterRandom::streamKey(options.seed, positionSalt), static_cast<unsigned long long>(size)) };
+
+		// Middle game : the board is about 40% full
+		logic::GameState middleGame{ size, size };
+		playRandomMoves(middleGame, size * size * 2 / 5, prng);
+		const auto legalMoves = sampleLegalMoves(middleGame, 16);
+
+		// End of the game : neither player has a move left but filling its own eyes
+		logic::GameRecord randomGame;
+		randomGame.sizeX = size;
+		randomGame.sizeY = size;
+		logic::GameState endGame{ size, size };
+		playRandomMoves(endGame, 3 * size * size, prng, &randomGame);
+
+		if (isSelected("putStoneAtPosition") && !legalMoves.empty())
+		{
+			add(measureOnCopies("putStoneAtPosition", middleGame, options.minSeconds, [&](logic::GameState& state, int i) {
+				state.putStoneAtPosition(legalMoves[i % legalMoves.size()]);
+			}));
+		}
+
+		if (isSelected("precomputeStonePlacement"))
+		{
+			// Every point, legal or not : the hovering of the UI asks for all of them
+			add(measure("precomputeStonePlacement", size, options.minSeconds, [] {}, [&] {
+				for (int y = 0; y < size; ++y)
+				{
+					for (int x = 0; x < size; ++x)
+						middleGame.precomputeStonePlacement({ x, y });
+				}
+				return static_cast<unsigned long long>(size * size);
+			}));
+		}
+
+		if (isSelected("fillSnapshot"))
+		{
+			// The legality of every point and the copy of the position : what the game worker does at each publish.
+			// The copies of the state start without the legality map, like a state after a move
+			std::vector<logic::GameSnapshot> snapshots(batchSize);
+			add(measureOnCopies("fillSnapshot", middleGame, options.minSeconds, [&](logic::GameState& state, int i) {
+				state.fillSnapshot(snapshots[i]);
+			}));
+		}
+
+		if (isSelected("computeFinalScore"))
+		{
+			add(measureOnCopies("computeFinalScore", endGame, options.minSeconds, [](logic::GameState& state, int) {
+				state.computeFinalScore();
+			}));
+		}
+
+		if (isSelected("computeHash"))
+		{
+			const auto stones = middleGame.getBoard().getStoneBoard();
+			unsigned long long sum = 0;
+			add(measure("computeHash", size, options.minSeconds, [] {}, [&] {
+				for (int i = 0; i < batchSize; ++i)
+					sum += middleGame.computeHash(stones);
+				return static_cast<unsigned long long>(batchSize);
+			}));
+			// Keeps the hashes from being optimized away
+			if (sum == 1)
+				std::cout << std::endl;
+		}
+
+		if (isSelected("mergeChains"))
+		{
+			logic::Position move;
+			const auto state = mergePosition(size, move);
+			add(measureOnCopies("mergeChains", state, options.minSeconds, [&](logic::GameState& copy, int) {
+				copy.putStoneAtPosition(move);
+			}));
+		}
+
+		if (isSelected("captureChain"))
+		{
+			logic::Position move;
+			const auto state = capturePosition(size, move);
+			add(measureOnCopies("captureChain", state, options.minSeconds, [&](logic::GameState& copy, int) {
+				copy.putStoneAtPosition(move);
+			}));
+		}
+
+		if (isSelected("replayRandomGame") && !randomGame.moves.empty())
+			add(measureReplay("replayRandomGame", { randomGame }, options.minSeconds));
+	}
+
+	// Recorded games, one benchmark by file and board size. The operation is a move
+	void runGameBenchmarks(const Options& options, std::vector<Result>& results)
+	{
+		for (const auto& fileName : options.gameFiles)
+		{
+			const std::string name = "replay:" + fileName;
+			if (!options.filter.empty() && name.find(options.filter) == std::string::npos)
+				continue;
+
+			std::ifstream file(fileName, std::ios::binary);
+			if (!file)
+			{
+				std::cerr << "Can't open " << fileName << std::endl;
+				continue;
+			}
+			std::stringstream content;
+			content << file.rdbuf();
+
+			std::vector<logic::GameRecord> games;
+			try
+			{
+				games = logic::parseSgf(content.str());
+			}
+			catch (const std::exception& e)
+			{
+				std::cerr << fileName << ": " << e.what() << std::endl;
+				continue;
+			}
+
+			for (const auto size : options.boardSizes)
+			{
+				std::vector<logic::GameRecord> sameSize;
+				std::copy_if(games.begin(), games.end(), std::back_inserter(sameSize), [size](const logic::GameRecord& game) {
+					return !game.hasSetupStones && game.sizeX == size && game.sizeY == size && !game.moves.empty();
+				});
+				if (sameSize.empty())
+					continue;
+
+				results.push_back(measureReplay(name, sameSize, options.minSeconds));
+				printResult(options, results.back());
+			}
+		}
+	}
+
+	std::string escapeJson(const std::string& text)
+	{
+		std::string escaped;
+		for (const auto c : text)
+		{
+			if (c == '"' || c == '\\')
+				escaped += '\\';
+			if (static_cast<unsigned char>(c) >= 0x20)
+				escaped += c;
+		}
+		return escaped;
+	}
+
+	void writeJson(std::ostream& output, unsigned long long seed, const std::vector<Result>& results)
+	{
+		output << std::fixed << std::setprecision(2) << "{\n  \"seed\": " << seed << ",\n  \"benchmarks\": [\n";
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			const auto& result = results[i];
+			output << "    { \"name\": \"" << escapeJson(result.name) << "\", \"boardSize\": " << result.boardSize
+				<< ", \"nsPerOp\": " << result.nsPerOp << ", \"allocationsPerOp\": " << result.allocationsPerOp
+				<< ", \"nbOps\": " << result.nbOps << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+		}
+		output << "  ]\n}\n";
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	try
+	{
+		options = parseOptions(argc, argv);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		printUsage();
+		return 1;
+	}
+	logic::setRandomSeed(options.seed);
+
+	std::vector<Result> results;
+	try
+	{
+		for (const auto size : options.boardSizes)
+			runBoardBenchmarks(size, options, results);
+		runGameBenchmarks(options, results);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	if (options.jsonFile == "-")
+		writeJson(std::cout, options.seed, results);
+	else if (!options.jsonFile.empty())
+	{
+		std::ofstream output(options.jsonFile);
+		writeJson(output, options.seed, results);
+		if (!output)
+		{
+			std::cerr << "Can't write " << options.jsonFile << std::endl;
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,434 @@
+// Correctness checks of the logic layer, against the plainest way to get a position : a fresh GameState replaying the
+// moves from the start of the game. Random games, generated from a seed, are used to check
+//   - every seek of ReplayTimeline, with several checkpoint intervals
+//   - every undo, redo and jump of the game tree of GameState
+// The mismatches are printed, and the exit code is 1 if there is any
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "logic/GameRecord.h"
+#include "logic/GameState.h"
+#include "logic/GameTree.h"
+#include "logic/Random.h"
+#include "logic/ReplayTimeline.h"
+
+namespace
+{
+	struct Options
+	{
+		int nbGames = 200;
+		// Seeks of the timeline check, spread over the games. As many for each checkpoint interval
+		int nbSeeks = 100000;
+		// Operations (move, pass, undo, redo, jump) of the game tree check, by game
+		int nbTreeSteps = 200;
+		// Seed of the random games and of the Zobrist keys
+		unsigned long long seed = 0;
+	};
+
+	// Tells the streams of the checks apart from the other uses of the seed
+	constexpr unsigned long long timelineSalt = 5;
+	constexpr unsigned long long treeSalt = 6;
+	// Mismatches printed in full, the next ones are only counted
+	constexpr unsigned long long maxPrintedMismatches = 10;
+
+	const int boardSizes[] = { 9, 13, 19 };
+	// 1 and 5 put the checkpoints on or close to every move, the default is the one of the replay mode
+	const int checkpointIntervals[] = { 1, 5, logic::ReplayTimeline::defaultCheckpointInterval };
+
+	void printUsage()
+	{
+		std::cerr << "Usage: gogame_check [options]\n"
+			<< "  --games <n>  random games of each check (default 200)\n"
+			<< "  --seeks <n>  seeks of the replay timeline over all the games, by checkpoint interval (default 100000)\n"
+			<< "  --steps <n>  moves, passes, undos, redos and jumps in the game tree of each game (default 200)\n"
+			<< "  --seed <n>   seed of the random games and of the hashes (default 0)\n";
+	}
+
+	Options parseOptions(int argc, char** argv)
+	{
+		Options options;
+		for (int i = 1; i < argc; ++i)
+		{
+			std::string arg = argv[i];
+			if (arg == "--games" && i + 1 < argc)
+				options.nbGames = std::max(1, std::stoi(argv[++i]));
+			else if (arg == "--seeks" && i + 1 < argc)
+				options.nbSeeks = std::max(0, std::stoi(argv[++i]));
+			else if (arg == "--steps" && i + 1 < argc)
+				options.nbTreeSteps = std::max(0, std::stoi(argv[++i]));
+			else if (arg == "--seed" && i + 1 < argc)
+				options.seed = std::stoull(argv[++i]);
+			else
+				throw std::runtime_error("Unknown option " + arg);
+		}
+		return options;
+	}
+
+	class Mismatches
+	{
+		unsigned long long _count = 0;
+
+	public:
+		unsigned long long getCount() const { return _count; }
+
+		void report(const std::string& check, int game, const std::string& what)
+		{
+			if (++_count <= maxPrintedMismatches)
+				std::cerr << check << ", game " << game << ": " << what << std::endl;
+		}
+	};
+
+	// A move of our random players doesn't fill one of their own eyes : an empty point surrounded by their stones
+	bool isOwnEye(const logic::Board& board, logic::Position pos, logic::Stone stone)
+	{
+		const logic::Position neighbours[] = { logic::getNorthPosition(pos), logic::getSouthPosition(pos), logic::getWestPosition(pos), logic::getEastPosition(pos) };
+		for (const auto& neighbour : neighbours)
+		{
+			if (board.isPositionInsideBoard(neighbour) && board.getStoneAt(neighbour) != stone)
+				return false;
+		}
+		return true;
+	}
+
+	// Random game until a player has no move left, with a pass now and then (never two in a row, which would end
+	// it). One game in four ends with a move on an occupied point, which the replay must refuse
+	logic::GameRecord randomGame(int size, logic::CounterRandom& prng)
+	{
+		logic::GameRecord record;
+		record.sizeX = size;
+		record.sizeY = size;
+
+		logic::GameState state{ size, size };
+		std::vector<logic::Position> candidates;
+		for (;;)
+		{
+			const auto player = state.getCurrentPlayer();
+			const bool isAfterPass = !record.moves.empty() && record.moves.back().isPass;
+			if (!isAfterPass && prng.nextBelow(32) == 0)
+			{
+				state.pass();
+				record.moves.push_back({ player, true, {} });
+				continue;
+			}
+
+			const auto& board = state.getBoard();
+			const auto stone = logic::playerToStone(player);
+			candidates.clear();
+			for (int y = 0; y < size; ++y)
+			{
+				for (int x = 0; x < size; ++x)
+				{
+					if (board.noStoneAtPosition({ x, y }) && !isOwnEye(board, { x, y }, stone))
+						candidates.push_back({ x, y });
+				}
+			}
+			for (size_t i = candidates.size(); i > 1; --i)
+				std::swap(candidates[i - 1], candidates[prng.nextBelow(i)]);
+
+			const auto played = std::find_if(candidates.begin(), candidates.end(), [&](logic::Position pos) { return state.putStoneAtPosition(pos); });
+			if (played == candidates.end())
+				break;
+			record.moves.push_back({ player, false, *played });
+		}
+
+		if (prng.nextBelow(4) == 0)
+		{
+			for (const auto& move : record.moves)
+			{
+				if (!move.isPass && state.getBoard().getStoneAt(move.pos) != logic::Stone::NONE)
+				{
+					record.moves.push_back({ state.getCurrentPlayer(), false, move.pos });
+					break;
+				}
+			}
+		}
+		return record;
+	}
+
+	// What the timeline must give after each number of moves
+	struct ReferencePosition
+	{
+		std::vector<logic::Stone> stones;
+		logic::Position lastMove{ -1, -1 };
+		logic::Player nextPlayer = logic::Player::BLACK;
+		unsigned int capturesBlack = 0;
+		unsigned int capturesWhite = 0;
+	};
+
+	unsigned int countStones(const std::vector<logic::Stone>& stones, logic::Stone stone)
+	{
+		return static_cast<unsigned int>(std::count(stones.begin(), stones.end(), stone));
+	}
+
+	// The positions of the game, up to the first move our rules refuse
+	std::vector<ReferencePosition> replayReference(const logic::GameRecord& game)
+	{
+		logic::GameState state{ game.sizeX, game.sizeY };
+		std::vector<ReferencePosition> positions(1);
+		positions[0].stones = state.getBoard().getStoneBoard();
+
+		for (const auto& move : game.moves)
+		{
+			auto position = positions.back();
+			const auto opponentStone = logic::playerToStone(logic::opposingPlayer(move.player));
+			const auto nbOpponentStones = countStones(position.stones, opponentStone);
+			if (move.isPass)
+				state.pass();
+			else if (!state.putStoneAtPosition(move.pos))
+				break;
+
+			position.stones = state.getBoard().getStoneBoard();
+			position.lastMove = move.isPass ? logic::Position{ -1, -1 } : move.pos;
+			position.nextPlayer = logic::opposingPlayer(move.player);
+			const auto nbCaptured = nbOpponentStones - countStones(position.stones, opponentStone);
+			if (move.player == logic::Player::BLACK)
+				position.capturesBlack += nbCaptured;
+			else
+				position.capturesWhite += nbCaptured;
+			positions.push_back(std::move(position));
+		}
+		return positions;
+	}
+
+	void checkTimeline(const Options& options, Mismatches& mismatches)
+	{
+		logic::CounterRandom prng{ logic::CounterRandom::streamKey(logic::getRandomSeed(), timelineSalt) };
+		const auto mismatchesBefore = mismatches.getCount();
+		unsigned long long nbSeeks = 0;
+
+		for (int game = 0; game < options.nbGames; ++game)
+		{
+			const auto record = randomGame(boardSizes[game % 3], prng);
+			const auto reference = replayReference(record);
+			const auto nbMoves = static_cast<int>(reference.size()) - 1;
+			const auto nbGameSeeks = options.nbSeeks / options.nbGames + (game < options.nbSeeks % options.nbGames ? 1 : 0);
+
+			for (const auto interval : checkpointIntervals)
+			{
+				const logic::ReplayTimeline timeline{ record, interval };
+				const auto context = "interval " + std::to_string(interval);
+				if (timeline.getNbMoves() != nbMoves || timeline.isTruncated() != (nbMoves < int(record.moves.size())))
+				{
+					mismatches.report("timeline", game, context + ", " + std::to_string(timeline.getNbMoves()) + " moves instead of " + std::to_string(nbMoves));
+					continue;
+				}
+
+				for (int move = 0; move <= nbMoves; ++move)
+				{
+					const auto& expected = reference[move];
+					const auto lastMove = timeline.getLastMove(move);
+					if (lastMove.x != expected.lastMove.x || lastMove.y != expected.lastMove.y || timeline.getNextPlayer(move) != expected.nextPlayer
+						|| timeline.getCapturesBlack(move) != expected.capturesBlack || timeline.getCapturesWhite(move) != expected.capturesWhite)
+						mismatches.report("timeline", game, context + ", wrong move information after move " + std::to_string(move));
+				}
+
+				// Jumps anywhere, steps of one move like the arrow keys, and seeks without a current position
+				std::vector<logic::Stone> stones;
+				int current = -1;
+				for (int seek = 0; seek < nbGameSeeks; ++seek)
+				{
+					int target;
+					const auto kind = prng.nextBelow(8);
+					if (kind < 4 || current < 0)
+						target = static_cast<int>(prng.nextBelow(nbMoves + 1));
+					else if (kind < 7)
+						target = std::max(0, std::min(current + (kind == 4 ? -1 : 1), nbMoves));
+					else
+					{
+						current = -1;
+						target = static_cast<int>(prng.nextBelow(nbMoves + 1));
+					}
+
+					const auto nbApplied = timeline.seek(current, target, stones);
+					++nbSeeks;
+					if (stones != reference[target].stones)
+						mismatches.report("timeline", game, context + ", wrong stones seeking from move " + std::to_string(current) + " to " + std::to_string(target));
+					else if (nbApplied >= interval && nbApplied > 0)
+						mismatches.report("timeline", game, context + ", " + std::to_string(nbApplied) + " moves applied seeking from move " + std::to_string(current) + " to " + std::to_string(target));
+					current = target;
+				}
+			}
+		}
+
+		std::cout << "timeline: " << options.nbGames << " games, " << nbSeeks << " seeks with " << (std::end(checkpointIntervals) - std::begin(checkpointIntervals)) << " checkpoint intervals, "
+			<< (mismatches.getCount() - mismatchesBefore) << " mismatches" << std::endl;
+	}
+
+	// Moves from the root to the current node, as the tree recorded them
+	std::vector<const logic::GameTreeNode*> currentLine(const logic::GameTree& tree)
+	{
+		std::vector<const logic::GameTreeNode*> line;
+		for (auto id = tree.getCurrent(); id != tree.getRoot(); id = tree.getNode(id).parent)
+			line.push_back(&tree.getNode(id));
+		std::reverse(line.begin(), line.end());
+		return line;
+	}
+
+	// Empty when the state is the one of a fresh GameState playing 'line', what differs otherwise
+	std::string compareWithReplay(const logic::GameState& state, const std::vector<const logic::GameTreeNode*>& line)
+	{
+		logic::GameState reference{ state.getBoardDimensionX(), state.getBoardDimensionY() };
+		for (const auto node : line)
+		{
+			if (node->player != reference.getCurrentPlayer())
+				return "move out of turn in the line";
+			if (node->isPass)
+				reference.pass();
+			else if (!reference.putStoneAtPosition(node->pos))
+				return "the line doesn't replay";
+		}
+
+		if (state.getBoard().getStoneBoard() != reference.getBoard().getStoneBoard())
+			return "wrong stones";
+		if (state.getCurrentHash() != reference.getCurrentHash())
+			return "wrong hash";
+		if (state.getCurrentPlayer() != reference.getCurrentPlayer())
+			return "wrong player to move";
+		if (state.isGameOver() != reference.isGameOver())
+			return "wrong end of game";
+		if (state.isGameOver() && (state.getScoreBlack() != reference.getScoreBlack() || state.getScoreWhite() != reference.getScoreWhite()))
+			return "wrong score";
+		return {};
+	}
+
+	// Random walk in the tree of a game : moves (some of them illegal), passes, undos, redos of any variation, and
+	// jumps to any node. It starts after a part of a random game, so that the moves capture stones now and then.
+	// After each step, the state is compared with a replay of the line from the root to the current node, and the
+	// line with the one expected from the steps
+	void checkGameTree(const Options& options, Mismatches& mismatches)
+	{
+		logic::CounterRandom prng{ logic::CounterRandom::streamKey(logic::getRandomSeed(), treeSalt) };
+		const auto mismatchesBefore = mismatches.getCount();
+		unsigned long long nbUndos = 0;
+		unsigned long long nbRedos = 0;
+		unsigned long long nbJumps = 0;
+
+		for (int game = 0; game < options.nbGames; ++game)
+		{
+			const auto size = boardSizes[game % 3];
+			logic::GameState state{ size, size };
+			const auto& tree = state.getGameTree();
+			// Depth of the current node, as the steps should leave it
+			unsigned int expectedDepth = 0;
+
+			const auto opening = randomGame(size, prng);
+			const auto nbOpeningMoves = prng.nextBelow(opening.moves.size() + 1);
+			for (size_t i = 0; i < nbOpeningMoves; ++i)
+			{
+				const auto& move = opening.moves[i];
+				if (move.isPass)
+					state.pass();
+				else if (!state.putStoneAtPosition(move.pos))
+					break;
+				++expectedDepth;
+			}
+
+			for (int step = 0; step < options.nbTreeSteps; ++step)
+			{
+				std::string action;
+				const auto kind = prng.nextBelow(20);
+				if (kind < 10)
+				{
+					const logic::Position pos{ static_cast<int>(prng.nextBelow(size)), static_cast<int>(prng.nextBelow(size)) };
+					action = "move (" + std::to_string(pos.x) + ", " + std::to_string(pos.y) + ")";
+					if (state.putStoneAtPosition(pos))
+						++expectedDepth;
+				}
+				else if (kind < 11)
+				{
+					action = "pass";
+					if (!state.isGameOver())
+					{
+						state.pass();
+						++expectedDepth;
+					}
+				}
+				else if (kind < 15)
+				{
+					action = "undo";
+					if (state.undo() != (expectedDepth > 0))
+						mismatches.report("game tree", game, "undo " + std::string(expectedDepth > 0 ? "refused" : "accepted") + " at depth " + std::to_string(expectedDepth));
+					else if (expectedDepth > 0)
+					{
+						--expectedDepth;
+						++nbUndos;
+					}
+				}
+				else if (kind < 19)
+				{
+					const auto nbVariations = state.getNbVariations();
+					const auto variation = static_cast<unsigned int>(prng.nextBelow(nbVariations + 1));
+					action = "redo " + std::to_string(variation);
+					const auto expectedChild = (variation < nbVariations) ? tree.getChild(tree.getCurrent(), variation) : logic::noNode;
+					if (state.redo(variation) != (expectedChild != logic::noNode))
+						mismatches.report("game tree", game, "redo of variation " + std::to_string(variation) + " out of " + std::to_string(nbVariations));
+					else if (expectedChild != logic::noNode)
+					{
+						++expectedDepth;
+						++nbRedos;
+						if (tree.getCurrent() != expectedChild)
+							mismatches.report("game tree", game, "redo went to another node");
+					}
+				}
+				else
+				{
+					const auto target = static_cast<logic::NodeID>(prng.nextBelow(tree.getNbNodes()));
+					action = "jump to node " + std::to_string(target);
+					if (!state.goToNode(target) || tree.getCurrent() != target)
+						mismatches.report("game tree", game, "jump to node " + std::to_string(target) + " failed");
+					expectedDepth = tree.getNode(tree.getCurrent()).depth;
+					++nbJumps;
+				}
+
+				const auto line = currentLine(tree);
+				auto difference = compareWithReplay(state, line);
+				if (difference.empty() && line.size() != expectedDepth)
+					difference = "the current node is at depth " + std::to_string(line.size()) + " instead of " + std::to_string(expectedDepth);
+				if (!difference.empty())
+				{
+					mismatches.report("game tree", game, difference + " after step " + std::to_string(step) + " (" + action + ")");
+					// The next steps would all differ the same way
+					break;
+				}
+			}
+		}
+
+		std::cout << "game tree: " << options.nbGames << " games, " << nbUndos << " undos, " << nbRedos << " redos, "
+			<< nbJumps << " jumps, " << (mismatches.getCount() - mismatchesBefore) << " mismatches" << std::endl;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	try
+	{
+		options = parseOptions(argc, argv);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		printUsage();
+		return 1;
+	}
+	logic::setRandomSeed(options.seed);
+
+	Mismatches mismatches;
+	try
+	{
+		checkTimeline(options, mismatches);
+		checkGameTree(options, mismatches);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	return mismatches.getCount() == 0 ? 0 : 1;
+}
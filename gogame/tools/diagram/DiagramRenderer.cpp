@@ -0,0 +1,295 @@
+#include "DiagramRenderer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include "render/utilities.h"
+
+namespace diagram
+{
+	namespace
+	{
+		// Shading of the stone layer (see StoneLayer.cpp), in stone radius units
+		constexpr float quadExtent = 1.25f;
+		constexpr float lightOffsetX = .1f;
+		constexpr float lightOffsetY = .15f;
+
+		struct Rgba
+		{
+			float r, g, b, a;
+		};
+
+		float clamp01(float value) { return std::min(1.f, std::max(0.f, value)); }
+		float mix(float from, float to, float t) { return from + (to - from) * t; }
+
+		Rgba premul(float r, float g, float b, float alpha) { return { r * alpha, g * alpha, b * alpha, alpha }; }
+		Rgba over(const Rgba& src, const Rgba& dst)
+		{
+			const float k = 1.f - src.a;
+			return { src.r + dst.r * k, src.g + dst.g * k, src.b + dst.b * k, src.a + dst.a * k };
+		}
+
+		// Coverage of the unit disc centered on (cx, cy), antialiased over 'aa'
+		float disc(float x, float y, float cx, float cy, float aa)
+		{
+			return clamp01((1.f - std::hypot(x - cx, y - cy)) / aa + .5f);
+		}
+
+		Rgba shadeStone(float x, float y, float aa, logic::Stone stone)
+		{
+			const bool isWhite = stone == logic::Stone::WHITE;
+			const auto body = render::stoneColor(isWhite ? render::Player::White : render::Player::Black);
+
+			const float gradientStartX = lightOffsetX - 1.f;
+			const float gradientStartY = lightOffsetY - 1.f;
+			const float t = clamp01(((x - gradientStartX) * 2.f + (y - gradientStartY) * 2.f) / 8.f);
+
+			const float shadow = disc(x, y, lightOffsetX, lightOffsetY, aa) * mix(1.f, 32.f / 255.f, t);
+			Rgba color = premul(32.f / 255.f, 32.f / 255.f, 32.f / 255.f, shadow);
+
+			const float coverage = disc(x, y, 0.f, 0.f, aa);
+			color = over(premul(body.r, body.g, body.b, coverage), color);
+
+			const float inner = coverage * mix(60.f / 255.f, 0.f, t);
+			const float innerGrey = isWhite ? 0.f : 192.f / 255.f;
+			color = over(premul(innerGrey, innerGrey, innerGrey, inner), color);
+
+			const float s = clamp01((std::hypot(x + .5f, y + .35f) - .02f) / .88f);
+			const float specular = coverage * mix(227.f / 255.f, 0.f, s);
+			const float specularGrey = isWhite ? 1.f : 128.f / 255.f;
+			color = over(premul(specularGrey, specularGrey, specularGrey, specular), color);
+
+			return color;
+		}
+
+		unsigned char toByte(float value)
+		{
+			return static_cast<unsigned char>(clamp01(value) * 255.f + .5f);
+		}
+
+		void fillRect(RgbImage& image, int x, int y, int width, int height, const NVGcolor& color)
+		{
+			const int x0 = std::max(0, x);
+			const int y0 = std::max(0, y);
+			const int x1 = std::min(image.width, x + width);
+			const int y1 = std::min(image.height, y + height);
+			const unsigned char rgb[] = { toByte(color.r), toByte(color.g), toByte(color.b) };
+
+			for (int row = y0; row < y1; ++row)
+			{
+				unsigned char* pixel = image.pixels.data() + (row * image.width + x0) * 3;
+				for (int column = x0; column < x1; ++column, pixel += 3)
+				{
+					pixel[0] = rgb[0];
+					pixel[1] = rgb[1];
+					pixel[2] = rgb[2];
+				}
+			}
+		}
+
+		std::string number(float value)
+		{
+			char buffer[32];
+			std::snprintf(buffer, sizeof(buffer), "%.3g", value);
+			return buffer;
+		}
+
+		std::string hexColor(const NVGcolor& color)
+		{
+			char buffer[8];
+			std::snprintf(buffer, sizeof(buffer), "#%02x%02x%02x", toByte(color.r), toByte(color.g), toByte(color.b));
+			return buffer;
+		}
+
+		// The stone of render::drawStoneShape centered on (0, 0) : shadow, body, inner gradient and specular highlight
+		std::string svgStoneSymbol(const char* id, logic::Stone stone, float r)
+		{
+			const bool isWhite = stone == logic::Stone::WHITE;
+			const auto body = render::stoneColor(isWhite ? render::Player::White : render::Player::Black);
+			const std::string innerGrey = isWhite ? "#000000" : "#c0c0c0";
+			const std::string specularGrey = isWhite ? "#ffffff" : "#808080";
+			const std::string name = id;
+
+			// The linear gradients go from (-r(1 - dx), -r(1 - dy)) to (r(1 + dx), r(1 + dy)), like in drawStoneShape
+			const auto gradientLine = "gradientUnits=\"userSpaceOnUse\" x1=\"" + number(-r * (1.f - lightOffsetX)) + "\" y1=\"" + number(-r * (1.f - lightOffsetY))
+				+ "\" x2=\"" + number(r * (1.f + lightOffsetX)) + "\" y2=\"" + number(r * (1.f + lightOffsetY)) + "\"";
+
+			std::string svg;
+			svg += "<linearGradient id=\"" + name + "Shadow\" " + gradientLine + ">"
+				"<stop offset=\"0\" stop-color=\"#202020\"/><stop offset=\"1\" stop-color=\"#202020\" stop-opacity=\"0.125\"/></linearGradient>\n";
+			svg += "<linearGradient id=\"" + name + "Inner\" " + gradientLine + ">"
+				"<stop offset=\"0\" stop-color=\"" + innerGrey + "\" stop-opacity=\"0.235\"/><stop offset=\"1\" stop-color=\"" + innerGrey + "\" stop-opacity=\"0\"/></linearGradient>\n";
+			svg += "<radialGradient id=\"" + name + "Specular\" gradientUnits=\"userSpaceOnUse\" cx=\"" + number(-r * .5f) + "\" cy=\"" + number(-r * .35f) + "\" r=\"" + number(r * .9f) + "\">"
+				"<stop offset=\"0.022\" stop-color=\"" + specularGrey + "\" stop-opacity=\"0.89\"/><stop offset=\"1\" stop-color=\"" + specularGrey + "\" stop-opacity=\"0\"/></radialGradient>\n";
+
+			const auto radius = number(r);
+			svg += "<g id=\"" + name + "\">"
+				"<circle cx=\"" + number(r * lightOffsetX) + "\" cy=\"" + number(r * lightOffsetY) + "\" r=\"" + radius + "\" fill=\"url(#" + name + "Shadow)\"/>"
+				"<circle r=\"" + radius + "\" fill=\"" + hexColor(body) + "\"/>"
+				"<circle r=\"" + radius + "\" fill=\"url(#" + name + "Inner)\"/>"
+				"<circle r=\"" + radius + "\" fill=\"url(#" + name + "Specular)\"/></g>\n";
+			return svg;
+		}
+	}
+
+	DiagramRenderer::DiagramRenderer(int squareSize) :
+		_squareSize{ std::max(2, squareSize) }
+	{
+		_margin = static_cast<int>(std::ceil(float(_squareSize) * render::DrawContext::marginFactor()));
+		_stoneRadius = float(_squareSize) * render::DrawContext::stoneFactor();
+
+		renderSprite(logic::Stone::BLACK, _blackSprite);
+		renderSprite(logic::Stone::WHITE, _whiteSprite);
+	}
+
+	int DiagramRenderer::getImageWidth(int dimX) const
+	{
+		// first point is (0,0), so dimX - 1
+		return (dimX - 1) * _squareSize + 2 * _margin;
+	}
+
+	int DiagramRenderer::getImageHeight(int dimY) const
+	{
+		return (dimY - 1) * _squareSize + 2 * _margin;
+	}
+
+	void DiagramRenderer::renderEmptyBoard(int dimX, int dimY)
+	{
+		_emptyBoard.width = getImageWidth(dimX);
+		_emptyBoard.height = getImageHeight(dimY);
+		_emptyBoard.pixels.resize(_emptyBoard.width * _emptyBoard.height * 3);
+
+		fillRect(_emptyBoard, 0, 0, _emptyBoard.width, _emptyBoard.height, render::boardColor());
+
+		// Same rectangles as render::Board : the lines start on the intersection and are lineWidth wide
+		const int lineWidth = static_cast<int>(render::lineWidth());
+		const int linesWidth = (dimX - 1) * _squareSize;
+		const int linesHeight = (dimY - 1) * _squareSize;
+		for (int i = 0; i < dimX; ++i)
+			fillRect(_emptyBoard, _margin + i * _squareSize, _margin, lineWidth, linesHeight + lineWidth, render::lineColor());
+		for (int j = 0; j < dimY; ++j)
+			fillRect(_emptyBoard, _margin, _margin + j * _squareSize, linesWidth, lineWidth, render::lineColor());
+
+		_emptyBoardDimX = dimX;
+		_emptyBoardDimY = dimY;
+	}
+
+	void DiagramRenderer::renderSprite(logic::Stone stone, Sprite& sprite) const
+	{
+		// The stone is centered on a pixel corner, the sprite covers its shadow on each side
+		const int extent = static_cast<int>(std::ceil(quadExtent * _stoneRadius));
+		sprite.size = 2 * extent;
+		sprite.pixels.resize(sprite.size * sprite.size * 4);
+
+		const float aa = 1.f / _stoneRadius;
+		for (int y = 0; y < sprite.size; ++y)
+		{
+			for (int x = 0; x < sprite.size; ++x)
+			{
+				const auto color = shadeStone((float(x - extent) + .5f) * aa, (float(y - extent) + .5f) * aa, aa, stone);
+				float* pixel = sprite.pixels.data() + (y * sprite.size + x) * 4;
+				pixel[0] = color.r * 255.f;
+				pixel[1] = color.g * 255.f;
+				pixel[2] = color.b * 255.f;
+				pixel[3] = color.a;
+			}
+		}
+	}
+
+	void DiagramRenderer::blend(const Sprite& sprite, int centerX, int centerY, RgbImage& image) const
+	{
+		const int left = centerX - sprite.size / 2;
+		const int top = centerY - sprite.size / 2;
+		const int x0 = std::max(0, -left);
+		const int y0 = std::max(0, -top);
+		const int x1 = std::min(sprite.size, image.width - left);
+		const int y1 = std::min(sprite.size, image.height - top);
+
+		for (int y = y0; y < y1; ++y)
+		{
+			const float* src = sprite.pixels.data() + (y * sprite.size + x0) * 4;
+			unsigned char* dst = image.pixels.data() + ((top + y) * image.width + left + x0) * 3;
+			for (int x = x0; x < x1; ++x, src += 4, dst += 3)
+			{
+				if (src[3] <= 0.f)
+					continue;
+
+				const float k = 1.f - src[3];
+				dst[0] = static_cast<unsigned char>(src[0] + float(dst[0]) * k + .5f);
+				dst[1] = static_cast<unsigned char>(src[1] + float(dst[1]) * k + .5f);
+				dst[2] = static_cast<unsigned char>(src[2] + float(dst[2]) * k + .5f);
+			}
+		}
+	}
+
+	void DiagramRenderer::render(const logic::Board& board, RgbImage& image)
+	{
+		const int dimX = board.getDimensionX();
+		const int dimY = board.getDimensionY();
+		if (dimX != _emptyBoardDimX || dimY != _emptyBoardDimY)
+			renderEmptyBoard(dimX, dimY);
+
+		image.width = _emptyBoard.width;
+		image.height = _emptyBoard.height;
+		image.pixels = _emptyBoard.pixels;
+
+		for (int j = 0; j < dimY; ++j)
+		{
+			for (int i = 0; i < dimX; ++i)
+			{
+				const auto stone = board.getStoneAt({ i, j });
+				if (stone != logic::Stone::NONE)
+					blend(stone == logic::Stone::BLACK ? _blackSprite : _whiteSprite, _margin + i * _squareSize, _margin + j * _squareSize, image);
+			}
+		}
+	}
+
+	std::string renderSvg(const logic::Board& board, int squareSize)
+	{
+		squareSize = std::max(2, squareSize);
+		const int dimX = board.getDimensionX();
+		const int dimY = board.getDimensionY();
+		const int margin = static_cast<int>(std::ceil(float(squareSize) * render::DrawContext::marginFactor()));
+		const float stoneRadius = float(squareSize) * render::DrawContext::stoneFactor();
+		const int width = (dimX - 1) * squareSize + 2 * margin;
+		const int height = (dimY - 1) * squareSize + 2 * margin;
+		const int lineWidth = static_cast<int>(render::lineWidth());
+
+		std::string svg;
+		svg.reserve(4096 + dimX * dimY * 48);
+		svg += "<svg xmlns=\"http://www.w3.org/2000/svg\" xmlns:xlink=\"http://www.w3.org/1999/xlink\" width=\"" + std::to_string(width)
+			+ "\" height=\"" + std::to_string(height) + "\" viewBox=\"0 0 " + std::to_string(width) + " " + std::to_string(height) + "\">\n";
+		svg += "<defs>\n" + svgStoneSymbol("b", logic::Stone::BLACK, stoneRadius) + svgStoneSymbol("w", logic::Stone::WHITE, stoneRadius) + "</defs>\n";
+		svg += "<rect width=\"" + std::to_string(width) + "\" height=\"" + std::to_string(height) + "\" fill=\"" + hexColor(render::boardColor()) + "\"/>\n";
+
+		// All the lines in one path, one rectangle each
+		svg += "<path fill=\"" + hexColor(render::lineColor()) + "\" d=\"";
+		for (int i = 0; i < dimX; ++i)
+		{
+			svg += "M" + std::to_string(margin + i * squareSize) + " " + std::to_string(margin) + "h" + std::to_string(lineWidth)
+				+ "v" + std::to_string((dimY - 1) * squareSize + lineWidth) + "h-" + std::to_string(lineWidth) + "z";
+		}
+		for (int j = 0; j < dimY; ++j)
+		{
+			svg += "M" + std::to_string(margin) + " " + std::to_string(margin + j * squareSize) + "h" + std::to_string((dimX - 1) * squareSize)
+				+ "v" + std::to_string(lineWidth) + "h-" + std::to_string((dimX - 1) * squareSize) + "z";
+		}
+		svg += "\"/>\n";
+
+		for (int j = 0; j < dimY; ++j)
+		{
+			for (int i = 0; i < dimX; ++i)
+			{
+				const auto stone = board.getStoneAt({ i, j });
+				if (stone == logic::Stone::NONE)
+					continue;
+
+				svg += "<use xlink:href=\"#";
+				svg += (stone == logic::Stone::BLACK) ? 'b' : 'w';
+				svg += "\" x=\"" + std::to_string(margin + i * squareSize) + "\" y=\"" + std::to_string(margin + j * squareSize) + "\"/>\n";
+			}
+		}
+
+		svg += "</svg>\n";
+		return svg;
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "logic/Board.h"
+
+namespace diagram
+{
+	// 8 bits RGB, rows from top to bottom without padding
+	struct RgbImage
+	{
+		int width = 0;
+		int height = 0;
+		std::vector<unsigned char> pixels;
+	};
+
+	// Software renderer of board diagrams, without display or GPU. It draws the board like the game does : same
+	// colors, margins, lines and stone radius (see render::Board and render::DrawContext), and the same stone shading
+	// as the instanced stone layer, computed on the CPU.
+	// The empty board and the two stone sprites are rendered once per board size, a diagram is then a copy of the
+	// empty board and one blend of a sprite by stone. A renderer isn't thread safe : use one per thread
+	class DiagramRenderer
+	{
+	public:
+		explicit DiagramRenderer(int squareSize);
+
+		int getSquareSize() const { return _squareSize; }
+		// Size of the image of a board, margins included
+		int getImageWidth(int dimX) const;
+		int getImageHeight(int dimY) const;
+
+		// The vector of the image is reused, rendering diagrams of the same size doesn't allocate
+		void render(const logic::Board& board, RgbImage& image);
+
+	private:
+		// Premultiplied RGBA, centered on an intersection
+		struct Sprite
+		{
+			int size = 0;
+			std::vector<float> pixels;
+		};
+
+		void renderEmptyBoard(int dimX, int dimY);
+		void renderSprite(logic::Stone stone, Sprite& sprite) const;
+		void blend(const Sprite& sprite, int centerX, int centerY, RgbImage& image) const;
+
+		int _squareSize;
+		int _margin;
+		float _stoneRadius;
+
+		RgbImage _emptyBoard;
+		int _emptyBoardDimX = 0;
+		int _emptyBoardDimY = 0;
+
+		Sprite _blackSprite;
+		Sprite _whiteSprite;
+	};
+
+	// Same diagram as a vector image : the stones are circles with gradients, defined once and instanced
+	std::string renderSvg(const logic::Board& board, int squareSize);
+}
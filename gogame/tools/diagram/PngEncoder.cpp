@@ -0,0 +1,307 @@
+#include "PngEncoder.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+
+namespace diagram
+{
+	namespace
+	{
+		const std::array<std::uint32_t, 256>& crcTable()
+		{
+			static const std::array<std::uint32_t, 256> table = [] {
+				std::array<std::uint32_t, 256> values;
+				for (std::uint32_t n = 0; n < 256; ++n)
+				{
+					std::uint32_t c = n;
+					for (int k = 0; k < 8; ++k)
+						c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+					values[n] = c;
+				}
+				return values;
+			}();
+			return table;
+		}
+
+		std::uint32_t crc32(const unsigned char* data, size_t size)
+		{
+			const auto& table = crcTable();
+			std::uint32_t c = 0xFFFFFFFFu;
+			for (size_t i = 0; i < size; ++i)
+				c = table[(c ^ data[i]) & 0xFF] ^ (c >> 8);
+			return c ^ 0xFFFFFFFFu;
+		}
+
+		void writeUint32(std::vector<unsigned char>& out, std::uint32_t value)
+		{
+			out.push_back(static_cast<unsigned char>(value >> 24));
+			out.push_back(static_cast<unsigned char>(value >> 16));
+			out.push_back(static_cast<unsigned char>(value >> 8));
+			out.push_back(static_cast<unsigned char>(value));
+		}
+
+		// Chunks are written in place : the length is patched and the CRC computed once the data is there
+		size_t beginChunk(std::vector<unsigned char>& out, const char* type)
+		{
+			const size_t start = out.size();
+			writeUint32(out, 0);
+			out.insert(out.end(), type, type + 4);
+			return start;
+		}
+
+		void endChunk(std::vector<unsigned char>& out, size_t start)
+		{
+			const auto length = static_cast<std::uint32_t>(out.size() - start - 8);
+			out[start] = static_cast<unsigned char>(length >> 24);
+			out[start + 1] = static_cast<unsigned char>(length >> 16);
+			out[start + 2] = static_cast<unsigned char>(length >> 8);
+			out[start + 3] = static_cast<unsigned char>(length);
+			writeUint32(out, crc32(out.data() + start + 4, length + 4));
+		}
+
+		// Deflate writes its bits from the least significant one, and the Huffman codes from their most significant one
+		class BitWriter
+		{
+			std::vector<unsigned char>& _out;
+			std::uint64_t _bits = 0;
+			int _nbBits = 0;
+
+		public:
+			explicit BitWriter(std::vector<unsigned char>& out) : _out(out) {}
+
+			void write(std::uint32_t bits, int count)
+			{
+				_bits |= std::uint64_t(bits) << _nbBits;
+				_nbBits += count;
+				while (_nbBits >= 8)
+				{
+					_out.push_back(static_cast<unsigned char>(_bits));
+					_bits >>= 8;
+					_nbBits -= 8;
+				}
+			}
+
+			void flush()
+			{
+				if (_nbBits > 0)
+					_out.push_back(static_cast<unsigned char>(_bits));
+				_bits = 0;
+				_nbBits = 0;
+			}
+		};
+
+		struct HuffmanCode
+		{
+			std::uint16_t bits;
+			std::uint8_t length;
+		};
+
+		// Fixed literal/length codes of RFC 1951, 3.2.6, already bit reversed
+		const std::array<HuffmanCode, 288>& fixedCodes()
+		{
+			static const std::array<HuffmanCode, 288> codes = [] {
+				std::array<HuffmanCode, 288> values;
+				for (int symbol = 0; symbol < 288; ++symbol)
+				{
+					int code, length;
+					if (symbol < 144) { code = 0x30 + symbol; length = 8; }
+					else if (symbol < 256) { code = 0x190 + symbol - 144; length = 9; }
+					else if (symbol < 280) { code = symbol - 256; length = 7; }
+					else { code = 0xC0 + symbol - 280; length = 8; }
+
+					int reversed = 0;
+					for (int i = 0; i < length; ++i)
+						reversed |= ((code >> i) & 1) << (length - 1 - i);
+					values[symbol] = { static_cast<std::uint16_t>(reversed), static_cast<std::uint8_t>(length) };
+				}
+				return values;
+			}();
+			return codes;
+		}
+
+		constexpr int lengthBases[] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+		constexpr int lengthExtraBits[] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+		constexpr int distanceBases[] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073,
+			4097, 6145, 8193, 12289, 16385, 24577 };
+		constexpr int distanceExtraBits[] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+		constexpr int minMatch = 3;
+		constexpr int maxMatch = 258;
+		constexpr int windowSize = 32768;
+
+		constexpr int hashBits = 13;
+
+		void writeSymbol(BitWriter& writer, int symbol)
+		{
+			const auto& code = fixedCodes()[symbol];
+			writer.write(code.bits, code.length);
+		}
+
+		int findCode(const int* bases, int nbCodes, int value)
+		{
+			int index = 0;
+			while (index + 1 < nbCodes && bases[index + 1] <= value)
+				index++;
+			return index;
+		}
+
+		void writeMatch(BitWriter& writer, int length, int distance)
+		{
+			const int lengthCode = findCode(lengthBases, 29, length);
+			writeSymbol(writer, 257 + lengthCode);
+			writer.write(length - lengthBases[lengthCode], lengthExtraBits[lengthCode]);
+
+			// The fixed distance codes are their 5 bits index, reversed
+			const int distanceCode = findCode(distanceBases, 30, distance);
+			int reversed = 0;
+			for (int i = 0; i < 5; ++i)
+				reversed |= ((distanceCode >> i) & 1) << (4 - i);
+			writer.write(reversed, 5);
+			writer.write(distance - distanceBases[distanceCode], distanceExtraBits[distanceCode]);
+		}
+
+		int matchLength(const std::vector<unsigned char>& data, size_t position, size_t candidate)
+		{
+			const size_t maxLength = std::min<size_t>(maxMatch, data.size() - position);
+			size_t length = 0;
+			// 8 bytes at a time while they're equal (memcmp of a constant size is a single comparison)
+			while (length + 8 <= maxLength && std::memcmp(&data[candidate + length], &data[position + length], 8) == 0)
+				length += 8;
+			while (length < maxLength && data[candidate + length] == data[position + length])
+				length++;
+			return static_cast<int>(length);
+		}
+
+		// Greedy LZ77 with a single final block of fixed Huffman codes. A diagram repeats itself in a few ways : the
+		// previous pixel (board color), the previous row (lines), and the other stones of the same color (found
+		// through a hash of the next 4 bytes). These three candidates are tried at each position, the longest wins
+		void deflate(const std::vector<unsigned char>& data, size_t rowSize, std::vector<unsigned char>& out)
+		{
+			static thread_local std::vector<int> lastPositions;
+			lastPositions.assign(size_t(1) << hashBits, -1);
+
+			BitWriter writer(out);
+			writer.write(1, 1);
+			writer.write(1, 2);
+
+			size_t i = 0;
+			while (i < data.size())
+			{
+				int bestLength = 0;
+				size_t bestDistance = 0;
+				auto tryDistance = [&](size_t distance) {
+					// Can't be longer than the best one if it differs at its end
+					if (distance == 0 || distance > i || distance > size_t(windowSize) || bestLength == maxMatch
+						|| (bestLength > 0 && (i + bestLength >= data.size() || data[i - distance + bestLength] != data[i + bestLength])))
+						return;
+					const int length = matchLength(data, i, i - distance);
+					if (length > bestLength)
+					{
+						bestLength = length;
+						bestDistance = distance;
+					}
+				};
+
+				tryDistance(3);
+				tryDistance(rowSize);
+				if (i + 4 <= data.size())
+				{
+					std::uint32_t next;
+					std::copy(data.begin() + i, data.begin() + i + 4, reinterpret_cast<unsigned char*>(&next));
+					const auto hash = (next * 2654435761u) >> (32 - hashBits);
+					if (lastPositions[hash] >= 0)
+						tryDistance(i - size_t(lastPositions[hash]));
+					lastPositions[hash] = static_cast<int>(i);
+				}
+
+				if (bestLength >= minMatch)
+				{
+					writeMatch(writer, bestLength, static_cast<int>(bestDistance));
+					i += bestLength;
+				}
+				else
+				{
+					writeSymbol(writer, data[i]);
+					i++;
+				}
+			}
+
+			writeSymbol(writer, 256);
+			writer.flush();
+		}
+
+		std::uint32_t adler32(const std::vector<unsigned char>& data)
+		{
+			constexpr size_t blockSize = 16;
+			std::uint32_t a = 1;
+			std::uint32_t b = 0;
+			size_t i = 0;
+			while (i < data.size())
+			{
+				// 5552 bytes at most between the modulos, they can't overflow before
+				const size_t end = std::min(data.size(), i + 5552);
+
+				// A block adds the sum of its bytes to 'a', and to 'b' blockSize times 'a' plus each byte weighted by
+				// the number of bytes from it to the end of the block : no dependency between the bytes of a block
+				for (; i + blockSize <= end; i += blockSize)
+				{
+					std::uint32_t sum = 0;
+					std::uint32_t weightedSum = 0;
+					for (size_t k = 0; k < blockSize; ++k)
+					{
+						sum += data[i + k];
+						weightedSum += std::uint32_t(blockSize - k) * data[i + k];
+					}
+					b += std::uint32_t(blockSize) * a + weightedSum;
+					a += sum;
+				}
+				for (; i < end; ++i)
+				{
+					a += data[i];
+					b += a;
+				}
+				a %= 65521;
+				b %= 65521;
+			}
+			return (b << 16) | a;
+		}
+	}
+
+	void encodePng(const RgbImage& image, std::vector<unsigned char>& png)
+	{
+		png.clear();
+		const unsigned char signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		png.insert(png.end(), std::begin(signature), std::end(signature));
+
+		auto chunk = beginChunk(png, "IHDR");
+		writeUint32(png, static_cast<std::uint32_t>(image.width));
+		writeUint32(png, static_cast<std::uint32_t>(image.height));
+		// 8 bits by channel, RGB, deflate, adaptive filtering, no interlace
+		const unsigned char header[] = { 8, 2, 0, 0, 0 };
+		png.insert(png.end(), std::begin(header), std::end(header));
+		endChunk(png, chunk);
+
+		// Rows without filter : the matches with the previous pixel and the previous row do the same work, without the
+		// pass over the image
+		static thread_local std::vector<unsigned char> rows;
+		const size_t stride = static_cast<size_t>(image.width) * 3;
+		rows.resize((stride + 1) * image.height);
+		for (int y = 0; y < image.height; ++y)
+		{
+			rows[y * (stride + 1)] = 0;
+			std::copy(image.pixels.begin() + y * stride, image.pixels.begin() + (y + 1) * stride, rows.begin() + y * (stride + 1) + 1);
+		}
+
+		chunk = beginChunk(png, "IDAT");
+		// zlib header : deflate with a 32K window, fastest compression level
+		png.push_back(0x78);
+		png.push_back(0x01);
+		deflate(rows, stride + 1, png);
+		writeUint32(png, adler32(rows));
+		endChunk(png, chunk);
+
+		chunk = beginChunk(png, "IEND");
+		endChunk(png, chunk);
+	}
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include <vector>
+#include "DiagramRenderer.h"
+
+namespace diagram
+{
+	// Encodes an image as a RGB PNG. The deflate stream is a simple greedy LZ77 with the fixed Huffman codes, tuned for
+	// diagrams : far faster than zlib's default level, and the files stay small (flat colors, repeated lines and
+	// stones). The vector is cleared and reused
+	void encodePng(const RgbImage& image, std::vector<unsigned char>& png);
+}
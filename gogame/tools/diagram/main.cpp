@@ -0,0 +1,243 @@
+// Renders board diagrams of recorded games (SGF) to PNG or SVG, without display or GPU : thumbnails for a game
+// archive, or figures for a report. Each thread takes the next file, replays its games and renders them with its
+// own renderer, so nothing is shared but the file index and the counters
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logic/GameRecord.h"
+#include "logic/GameState.h"
+#include "DiagramRenderer.h"
+#include "PngEncoder.h"
+
+namespace
+{
+	struct Options
+	{
+		std::vector<std::string> inputFiles;
+		std::string outputDirectory = ".";
+		bool writePng = true;
+		bool writeSvg = false;
+		int squareSize = 16;
+		// Position after that many moves, -1 for the end of the game
+		int moveNumber = -1;
+		int nbJobs = std::max(1u, std::thread::hardware_concurrency());
+		// Renders each diagram that many times, to measure the renderer without the replay and the disk
+		int nbRepeats = 1;
+	};
+
+	struct Statistics
+	{
+		std::atomic<unsigned long long> nbGames{ 0 };
+		std::atomic<unsigned long long> nbSkippedGames{ 0 };
+		std::atomic<unsigned long long> nbDiagrams{ 0 };
+		std::atomic<unsigned long long> nbBytes{ 0 };
+		// Rendering and encoding only, summed over the threads
+		std::atomic<unsigned long long> renderNanoseconds{ 0 };
+	};
+
+	void printUsage()
+	{
+		std::cerr << "Usage: gogame_diagram [options] file.sgf [file.sgf ...]\n"
+			<< "  -o <directory>   output directory, it must exist (default .)\n"
+			<< "  --format <f>     png, svg or both (default png)\n"
+			<< "  --square <n>     square size in pixels (default 16)\n"
+			<< "  --move <n>       position after n moves (default: end of the game)\n"
+			<< "  --jobs <n>       rendering threads (default: one per core)\n"
+			<< "  --repeat <n>     renders each diagram n times, to measure the throughput\n";
+	}
+
+	Options parseOptions(int argc, char** argv)
+	{
+		Options options;
+		for (int i = 1; i < argc; ++i)
+		{
+			std::string arg = argv[i];
+			if (arg == "-o" && i + 1 < argc)
+				options.outputDirectory = argv[++i];
+			else if (arg == "--format" && i + 1 < argc)
+			{
+				const std::string format = argv[++i];
+				if (format != "png" && format != "svg" && format != "both")
+					throw std::runtime_error("Unknown format " + format);
+				options.writePng = format != "svg";
+				options.writeSvg = format != "png";
+			}
+			else if (arg == "--square" && i + 1 < argc)
+				options.squareSize = std::max(2, std::stoi(argv[++i]));
+			else if (arg == "--move" && i + 1 < argc)
+				options.moveNumber = std::max(0, std::stoi(argv[++i]));
+			else if (arg == "--jobs" && i + 1 < argc)
+				options.nbJobs = std::max(1, std::stoi(argv[++i]));
+			else if (arg == "--repeat" && i + 1 < argc)
+				options.nbRepeats = std::max(1, std::stoi(argv[++i]));
+			else if (!arg.empty() && arg[0] == '-')
+				throw std::runtime_error("Unknown option " + arg);
+			else
+				options.inputFiles.push_back(arg);
+		}
+
+		if (options.inputFiles.empty())
+			throw std::runtime_error("No input file");
+
+		return options;
+	}
+
+	// "games/2019/abc.sgf" -> "abc"
+	std::string fileStem(const std::string& path)
+	{
+		const auto slash = path.find_last_of("/\\");
+		auto name = (slash == std::string::npos) ? path : path.substr(slash + 1);
+		const auto dot = name.find_last_of('.');
+		return (dot == std::string::npos || dot == 0) ? name : name.substr(0, dot);
+	}
+
+	// Plays the main line up to 'moveNumber' (or to the end). Unlike the exporter, we don't stop at a move played
+	// out of turn : the diagram shows the stones, whoever played them. A move our rules refuse ends the replay
+	void replay(const logic::GameRecord& game, int moveNumber, logic::GameState& gameState)
+	{
+		int nbMoves = 0;
+		for (const auto& move : game.moves)
+		{
+			if (moveNumber >= 0 && nbMoves >= moveNumber)
+				break;
+
+			if (move.player != gameState.getCurrentPlayer())
+				gameState.changePlayer();
+
+			if (move.isPass)
+				gameState.pass();
+			else if (!gameState.putStoneAtPosition(move.pos))
+				break;
+			nbMoves++;
+		}
+	}
+
+	bool writeFile(const std::string& fileName, const char* data, size_t size)
+	{
+		std::ofstream file(fileName, std::ios::binary);
+		file.write(data, size);
+		if (!file)
+			std::cerr << "Can't write " << fileName << std::endl;
+		return file.good();
+	}
+
+	void renderStage(const Options& options, std::atomic<size_t>& nextFile, Statistics& stats)
+	{
+		diagram::DiagramRenderer renderer(options.squareSize);
+		diagram::RgbImage image;
+		std::vector<unsigned char> png;
+		std::string svg;
+
+		for (size_t fileIndex = nextFile++; fileIndex < options.inputFiles.size(); fileIndex = nextFile++)
+		{
+			const auto& fileName = options.inputFiles[fileIndex];
+			std::ifstream file(fileName, std::ios::binary);
+			if (!file)
+			{
+				std::cerr << "Can't open " << fileName << std::endl;
+				continue;
+			}
+
+			std::stringstream content;
+			content << file.rdbuf();
+
+			std::vector<logic::GameRecord> games;
+			try
+			{
+				games = logic::parseSgf(content.str());
+			}
+			catch (const std::exception& e)
+			{
+				std::cerr << fileName << ": " << e.what() << std::endl;
+				continue;
+			}
+
+			for (size_t gameIndex = 0; gameIndex < games.size(); ++gameIndex)
+			{
+				const auto& game = games[gameIndex];
+				stats.nbGames++;
+				// GameState can't replay setup stones
+				if (game.hasSetupStones || game.sizeX < 2 || game.sizeY < 2)
+				{
+					stats.nbSkippedGames++;
+					continue;
+				}
+
+				logic::GameState gameState{ game.sizeX, game.sizeY };
+				replay(game, options.moveNumber, gameState);
+				const auto& board = gameState.getBoard();
+
+				const auto start = std::chrono::steady_clock::now();
+				for (int repeat = 0; repeat < options.nbRepeats; ++repeat)
+				{
+					if (options.writePng)
+					{
+						renderer.render(board, image);
+						diagram::encodePng(image, png);
+					}
+					if (options.writeSvg)
+						svg = diagram::renderSvg(board, options.squareSize);
+				}
+				stats.renderNanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+				stats.nbDiagrams += options.nbRepeats;
+
+				// A collection gets one file by game
+				auto outputName = options.outputDirectory + "/" + fileStem(fileName);
+				if (games.size() > 1)
+					outputName += "-" + std::to_string(gameIndex + 1);
+
+				if (options.writePng && writeFile(outputName + ".png", reinterpret_cast<const char*>(png.data()), png.size()))
+					stats.nbBytes += png.size();
+				if (options.writeSvg && writeFile(outputName + ".svg", svg.data(), svg.size()))
+					stats.nbBytes += svg.size();
+			}
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	try
+	{
+		options = parseOptions(argc, argv);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		printUsage();
+		return 1;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+
+	Statistics stats;
+	std::atomic<size_t> nextFile{ 0 };
+	std::vector<std::thread> threads;
+	for (int i = 0; i < options.nbJobs; ++i)
+		threads.emplace_back(renderStage, std::cref(options), std::ref(nextFile), std::ref(stats));
+
+	for (auto& thread : threads)
+		thread.join();
+
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	const auto renderSeconds = double(stats.renderNanoseconds) * 1e-9;
+	std::cout << stats.nbGames << " games (" << stats.nbSkippedGames << " skipped), "
+		<< stats.nbDiagrams << " diagrams, " << stats.nbBytes << " bytes written in " << elapsed << " s" << std::endl;
+	if (stats.nbDiagrams > 0 && renderSeconds > 0.0)
+	{
+		std::cout << renderSeconds * 1e6 / double(stats.nbDiagrams) << " us of rendering and encoding by diagram, "
+			<< double(stats.nbDiagrams) / renderSeconds << " diagrams/s by thread (" << options.nbJobs << " threads)" << std::endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,53 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace exporter
+{
+	// Bounded queue linking two stages of the pipeline. The bound is what keeps a fast stage from piling up
+	// the whole data set in memory while a slower one (usually the disk) catches up.
+	// The queue is closed once every producer called producerDone(), pop() then drains what's left and returns false
+	template <typename T>
+	class BlockingQueue
+	{
+		std::deque<T> _items;
+		size_t _capacity;
+		int _nbProducers;
+		std::mutex _mutex;
+		std::condition_variable _notFull;
+		std::condition_variable _notEmpty;
+
+	public:
+		BlockingQueue(size_t capacity, int nbProducers) : _capacity{ capacity }, _nbProducers{ nbProducers } {}
+
+		void push(T item)
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_notFull.wait(lock, [this] { return _items.size() < _capacity; });
+			_items.push_back(std::move(item));
+			_notEmpty.notify_one();
+		}
+
+		bool pop(T& item)
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_notEmpty.wait(lock, [this] { return !_items.empty() || _nbProducers == 0; });
+			if (_items.empty())
+				return false;
+
+			item = std::move(_items.front());
+			_items.pop_front();
+			_notFull.notify_one();
+			return true;
+		}
+
+		void producerDone()
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_nbProducers--;
+			if (_nbProducers == 0)
+				_notEmpty.notify_all();
+		}
+	};
+}
@@ -0,0 +1,166 @@
+#include "FeatureEncoder.h"
+#include <algorithm>
+#include <array>
+#include "logic/GameState.h"
+
+namespace exporter
+{
+	namespace
+	{
+		// Symmetry s flips x if bit 0 is set, flips y if bit 1 is set, then transposes if bit 2 is set
+		int transformIndex(int i, int sizeX, int sizeY, int symmetry)
+		{
+			int x = i % sizeX;
+			int y = i / sizeX;
+			if (symmetry & 1)
+				x = sizeX - 1 - x;
+			if (symmetry & 2)
+				y = sizeY - 1 - y;
+			if (symmetry & 4)
+				std::swap(x, y);
+			// Transposition is only used on square boards, so the row length doesn't change
+			return x + y * sizeX;
+		}
+
+		constexpr size_t headerSize = 14;
+
+		void writeLittleEndian(std::array<unsigned char, headerSize>& header, size_t offset, unsigned int value, size_t nbBytes)
+		{
+			for (size_t k = 0; k < nbBytes; ++k)
+				header[offset + k] = static_cast<unsigned char>((value >> (8 * k)) & 0xFF);
+		}
+	}
+
+	std::vector<ReplayedPosition> replayGame(const logic::GameRecord& game)
+	{
+		std::vector<ReplayedPosition> positions;
+		positions.reserve(game.moves.size());
+
+		logic::GameState gameState{ game.sizeX, game.sizeY };
+		const int sizeBoard = game.sizeX * game.sizeY;
+		const logic::Board& board = gameState.getBoard();
+
+		int recentMoves[nbHistoryPlanes];
+		std::fill(std::begin(recentMoves), std::end(recentMoves), -1);
+
+		for (const auto& move : game.moves)
+		{
+			if (move.player != gameState.getCurrentPlayer())
+				break;
+
+			ReplayedPosition position;
+			position.sizeX = game.sizeX;
+			position.sizeY = game.sizeY;
+			position.toMove = gameState.getCurrentPlayer();
+			position.stones = board.getStoneBoard();
+			position.liberties.assign(sizeBoard, 0u);
+			position.legalMoves.assign(sizeBoard, false);
+			std::copy(std::begin(recentMoves), std::end(recentMoves), std::begin(position.recentMoves));
+			position.nextMove = move.isPass ? sizeBoard : move.pos.x + move.pos.y * game.sizeX;
+			position.outcome = game.hasWinner ? (game.winner == position.toMove ? 1 : -1) : 0;
+
+			for (int i = 0; i < sizeBoard; ++i)
+			{
+				logic::Position pos{ i % game.sizeX, i / game.sizeX };
+				// The map of the whole position is computed once, on the first call, as the game does for its UI
+				if (board.noStoneAtPosition(i))
+					position.legalMoves[i] = gameState.isLegalMove(pos);
+				else
+					position.liberties[i] = board.getNbLibertiesOfChainAtPosition(pos);
+			}
+
+			if (move.isPass)
+				gameState.pass();
+			else if (!gameState.putStoneAtPosition(move.pos))
+				break;
+
+			std::copy_backward(std::begin(recentMoves), std::end(recentMoves) - 1, std::end(recentMoves));
+			recentMoves[0] = move.isPass ? -1 : position.nextMove;
+
+			positions.push_back(std::move(position));
+		}
+
+		return positions;
+	}
+
+	size_t Chunk::sampleSize() const
+	{
+		const size_t planeSize = (sizeX * sizeY + 7) / 8;
+		return nbPlanes * planeSize + 4;
+	}
+
+	std::vector<unsigned char> Chunk::serialize() const
+	{
+		std::array<unsigned char, headerSize> header = { { 'G', 'G', 'F', 'P' } };
+		writeLittleEndian(header, 4, 1, 2);
+		writeLittleEndian(header, 6, sizeX, 1);
+		writeLittleEndian(header, 7, sizeY, 1);
+		writeLittleEndian(header, 8, nbPlanes, 1);
+		writeLittleEndian(header, 9, 0, 1);
+		writeLittleEndian(header, 10, nbSamples, 4);
+
+		std::vector<unsigned char> bytes(headerSize + samples.size());
+		std::copy(header.begin(), header.end(), bytes.begin());
+		std::copy(samples.begin(), samples.end(), bytes.begin() + headerSize);
+
+		return bytes;
+	}
+
+	void encodePosition(const ReplayedPosition& position, bool symmetries, Chunk& chunk)
+	{
+		const int sizeBoard = position.sizeX * position.sizeY;
+		const int planeSize = (sizeBoard + 7) / 8;
+		const logic::Stone ownStone = logic::playerToStone(position.toMove);
+		const logic::Stone opponentStone = logic::playerToStone(logic::opposingPlayer(position.toMove));
+
+		const bool isSquare = (position.sizeX == position.sizeY);
+		const int nbTransforms = !symmetries ? 1 : (isSquare ? nbSymmetries : nbSymmetries / 2);
+
+		for (int symmetry = 0; symmetry < nbTransforms; ++symmetry)
+		{
+			const size_t sampleOffset = chunk.samples.size();
+			chunk.samples.resize(sampleOffset + chunk.sampleSize(), 0);
+			auto& samples = chunk.samples;
+
+			auto setBit = [&](int plane, int i) {
+				int j = transformIndex(i, position.sizeX, position.sizeY, symmetry);
+				samples[sampleOffset + plane * planeSize + j / 8] |= static_cast<unsigned char>(1u << (j % 8));
+			};
+
+			for (int i = 0; i < sizeBoard; ++i)
+			{
+				logic::Stone stone = position.stones[i];
+				if (stone == ownStone)
+					setBit(0, i);
+				else if (stone == opponentStone)
+					setBit(1, i);
+				else
+					setBit(2, i);
+
+				if (stone != logic::Stone::NONE)
+					setBit(3 + std::min(position.liberties[i], 4u) - 1, i);
+
+				if (position.legalMoves[i])
+					setBit(legalPlane, i);
+			}
+
+			for (int k = 0; k < nbHistoryPlanes; ++k)
+			{
+				if (position.recentMoves[k] >= 0)
+					setBit(7 + k, position.recentMoves[k]);
+			}
+
+			int move = position.nextMove;
+			if (move < sizeBoard)
+				move = transformIndex(move, position.sizeX, position.sizeY, symmetry);
+
+			const size_t trailer = sampleOffset + nbPlanes * planeSize;
+			samples[trailer] = static_cast<unsigned char>(move & 0xFF);
+			samples[trailer + 1] = static_cast<unsigned char>((move >> 8) & 0xFF);
+			samples[trailer + 2] = static_cast<unsigned char>(static_cast<signed char>(position.outcome));
+			samples[trailer + 3] = static_cast<unsigned char>(position.toMove == logic::Player::BLACK ? 0 : 1);
+
+			chunk.nbSamples++;
+		}
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "logic/GameRecord.h"
+
+namespace exporter
+{
+	// Feature planes, one bit by intersection each, from the point of view of the player to move:
+	//   0      : stones of the player to move
+	//   1      : stones of the opponent
+	//   2      : empty intersections
+	//   3 - 6  : stones whose chain has 1, 2, 3, 4+ liberties
+	//   7 - 10 : last move, the one before, ... (4 moves of history)
+	//   11     : legal moves for the player to move
+	constexpr int nbHistoryPlanes = 4;
+	constexpr int nbPlanes = 7 + nbHistoryPlanes + 1;
+	constexpr int legalPlane = 7 + nbHistoryPlanes;
+
+	constexpr int nbSymmetries = 8;
+
+	// Raw position taken from a replay, before any encoding
+	struct ReplayedPosition
+	{
+		int sizeX;
+		int sizeY;
+		logic::Player toMove;
+		std::vector<logic::Stone> stones;
+		std::vector<unsigned int> liberties;
+		std::vector<bool> legalMoves;
+		// Last moves as intersection indices, most recent first. -1 for a pass or no move
+		int recentMoves[nbHistoryPlanes];
+		// Move played from this position, sizeX * sizeY for a pass
+		int nextMove;
+		// +1 if the player to move won the game, -1 otherwise, 0 if unknown
+		int outcome;
+	};
+
+	// Replays the main line of a game with the logic layer and returns one position by move.
+	// The replay stops at the first move our rules refuse (wrong player, superko...), the positions before are kept
+	std::vector<ReplayedPosition> replayGame(const logic::GameRecord& game);
+
+	// Group of encoded samples sharing the same board size, written as a whole:
+	//   header : "GGFP", version (uint16), sizeX (uint8), sizeY (uint8), nbPlanes (uint8), flags (uint8), nbSamples (uint32)
+	//   sample : nbPlanes bit-packed planes of (sizeX * sizeY + 7) / 8 bytes, move (uint16), outcome (int8), player to move (uint8)
+	// Everything is little endian
+	struct Chunk
+	{
+		int sizeX = 0;
+		int sizeY = 0;
+		unsigned int nbSamples = 0;
+		std::vector<unsigned char> samples;
+
+		size_t sampleSize() const;
+		std::vector<unsigned char> serialize() const;
+	};
+
+	// Encodes a position in the chunk. With symmetries, the 8 rotations/reflections of the position are added
+	// (only the 4 that keep the board shape on rectangular boards)
+	void encodePosition(const ReplayedPosition& position, bool symmetries, Chunk& chunk);
+}
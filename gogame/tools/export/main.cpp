@@ -0,0 +1,227 @@
+// Replays recorded games (SGF) with the logic layer and writes feature planes for training.
+// The work is split in a pipeline : parse -> replay -> encode -> write, each stage on its own thread(s),
+// linked by bounded queues, so the slowest stage (hopefully the disk) sets the pace
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logic/GameRecord.h"
+#include "BlockingQueue.h"
+#include "FeatureEncoder.h"
+
+namespace
+{
+	struct Options
+	{
+		std::vector<std::string> inputFiles;
+		std::string outputFile = "features.bin";
+		bool symmetries = false;
+		int nbJobs = std::max(1u, std::thread::hardware_concurrency() / 2);
+		unsigned int samplesByChunk = 4096;
+	};
+
+	struct Statistics
+	{
+		std::atomic<unsigned long long> nbGames{ 0 };
+		std::atomic<unsigned long long> nbSkippedGames{ 0 };
+		std::atomic<unsigned long long> nbPositions{ 0 };
+		std::atomic<unsigned long long> nbSamples{ 0 };
+		std::atomic<unsigned long long> nbBytes{ 0 };
+	};
+
+	void printUsage()
+	{
+		std::cerr << "Usage: gogame_export [options] file.sgf [file.sgf ...]\n"
+			<< "  -o <file>     output file (default features.bin)\n"
+			<< "  --augment     add the 8 symmetries of each position\n"
+			<< "  --jobs <n>    number of replay and encode threads\n"
+			<< "  --chunk <n>   samples by chunk (default 4096)\n";
+	}
+
+	Options parseOptions(int argc, char** argv)
+	{
+		Options options;
+		for (int i = 1; i < argc; ++i)
+		{
+			std::string arg = argv[i];
+			if (arg == "-o" && i + 1 < argc)
+				options.outputFile = argv[++i];
+			else if (arg == "--augment")
+				options.symmetries = true;
+			else if (arg == "--jobs" && i + 1 < argc)
+				options.nbJobs = std::max(1, std::stoi(argv[++i]));
+			else if (arg == "--chunk" && i + 1 < argc)
+				options.samplesByChunk = std::max(1, std::stoi(argv[++i]));
+			else if (!arg.empty() && arg[0] == '-')
+				throw std::runtime_error("Unknown option " + arg);
+			else
+				options.inputFiles.push_back(arg);
+		}
+
+		if (options.inputFiles.empty())
+			throw std::runtime_error("No input file");
+
+		return options;
+	}
+
+	void parseStage(const Options& options, exporter::BlockingQueue<logic::GameRecord>& games, Statistics& stats)
+	{
+		for (const auto& fileName : options.inputFiles)
+		{
+			std::ifstream file(fileName, std::ios::binary);
+			if (!file)
+			{
+				std::cerr << "Can't open " << fileName << std::endl;
+				continue;
+			}
+
+			std::stringstream content;
+			content << file.rdbuf();
+
+			try
+			{
+				for (auto& game : logic::parseSgf(content.str()))
+				{
+					stats.nbGames++;
+					// The chunk header stores the dimensions on one byte, and GameState can't replay setup stones
+					if (game.hasSetupStones || game.sizeX < 2 || game.sizeY < 2 || game.sizeX > 255 || game.sizeY > 255)
+					{
+						stats.nbSkippedGames++;
+						continue;
+					}
+					games.push(std::move(game));
+				}
+			}
+			catch (const std::exception& e)
+			{
+				std::cerr << fileName << ": " << e.what() << std::endl;
+			}
+		}
+		games.producerDone();
+	}
+
+	void replayStage(exporter::BlockingQueue<logic::GameRecord>& games,
+		exporter::BlockingQueue<std::vector<exporter::ReplayedPosition>>& positions, Statistics& stats)
+	{
+		logic::GameRecord game;
+		while (games.pop(game))
+		{
+			auto replayed = exporter::replayGame(game);
+			stats.nbPositions += replayed.size();
+			if (!replayed.empty())
+				positions.push(std::move(replayed));
+		}
+		positions.producerDone();
+	}
+
+	void encodeStage(const Options& options, exporter::BlockingQueue<std::vector<exporter::ReplayedPosition>>& positions,
+		exporter::BlockingQueue<exporter::Chunk>& chunks, Statistics& stats)
+	{
+		// One pending chunk by board size, so a chunk never mixes dimensions
+		std::vector<exporter::Chunk> pendingChunks;
+
+		std::vector<exporter::ReplayedPosition> game;
+		while (positions.pop(game))
+		{
+			for (const auto& position : game)
+			{
+				auto chunk = std::find_if(pendingChunks.begin(), pendingChunks.end(), [&](const exporter::Chunk& c) {
+					return c.sizeX == position.sizeX && c.sizeY == position.sizeY;
+				});
+				if (chunk == pendingChunks.end())
+				{
+					exporter::Chunk newChunk;
+					newChunk.sizeX = position.sizeX;
+					newChunk.sizeY = position.sizeY;
+					newChunk.samples.reserve(newChunk.sampleSize() * options.samplesByChunk);
+					pendingChunks.push_back(std::move(newChunk));
+					chunk = pendingChunks.end() - 1;
+				}
+
+				exporter::encodePosition(position, options.symmetries, *chunk);
+				if (chunk->nbSamples >= options.samplesByChunk)
+				{
+					stats.nbSamples += chunk->nbSamples;
+					exporter::Chunk fullChunk = std::move(*chunk);
+					pendingChunks.erase(chunk);
+					chunks.push(std::move(fullChunk));
+				}
+			}
+		}
+
+		for (auto& chunk : pendingChunks)
+		{
+			stats.nbSamples += chunk.nbSamples;
+			chunks.push(std::move(chunk));
+		}
+		chunks.producerDone();
+	}
+
+	void writeStage(std::ofstream& output, exporter::BlockingQueue<exporter::Chunk>& chunks, Statistics& stats)
+	{
+		exporter::Chunk chunk;
+		while (chunks.pop(chunk))
+		{
+			auto bytes = chunk.serialize();
+			output.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+			stats.nbBytes += bytes.size();
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	try
+	{
+		options = parseOptions(argc, argv);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		printUsage();
+		return 1;
+	}
+
+	std::ofstream output(options.outputFile, std::ios::binary);
+	if (!output)
+	{
+		std::cerr << "Can't open " << options.outputFile << " for writing" << std::endl;
+		return 1;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+
+	// Queues are kept short : a few items by consumer is enough to absorb the jitter between stages
+	Statistics stats;
+	exporter::BlockingQueue<logic::GameRecord> games(4 * options.nbJobs, 1);
+	exporter::BlockingQueue<std::vector<exporter::ReplayedPosition>> positions(4 * options.nbJobs, options.nbJobs);
+	exporter::BlockingQueue<exporter::Chunk> chunks(4, options.nbJobs);
+
+	std::vector<std::thread> threads;
+	threads.emplace_back(parseStage, std::cref(options), std::ref(games), std::ref(stats));
+	for (int i = 0; i < options.nbJobs; ++i)
+	{
+		threads.emplace_back(replayStage, std::ref(games), std::ref(positions), std::ref(stats));
+		threads.emplace_back(encodeStage, std::cref(options), std::ref(positions), std::ref(chunks), std::ref(stats));
+	}
+	threads.emplace_back(writeStage, std::ref(output), std::ref(chunks), std::ref(stats));
+
+	for (auto& thread : threads)
+		thread.join();
+
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cout << stats.nbGames << " games (" << stats.nbSkippedGames << " skipped), "
+		<< stats.nbPositions << " positions, " << stats.nbSamples << " samples, "
+		<< stats.nbBytes << " bytes in " << elapsed << " s" << std::endl;
+
+	return output.good() ? 0 : 1;
+}
@@ -0,0 +1,175 @@
+// Build step of the game : embeds TTF files in a C++ source file, with their printable ASCII glyphs rasterized
+// by fontstash in SDF mode. The game adds these glyphs to its atlas at startup instead of rasterizing them on the
+// first frames. In SDF mode a glyph serves every font size, so one size is baked.
+//
+// Usage: gogame_fontbake output.cpp name=file.ttf [name=file.ttf ...]
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#define FONTSTASH_IMPLEMENTATION
+#define STB_TRUETYPE_IMPLEMENTATION
+#include <fontstash.h>
+
+namespace
+{
+	constexpr int atlasSize = 1024;
+	constexpr unsigned int firstCodepoint = 32;
+	constexpr unsigned int lastCodepoint = 126;
+
+	struct FontFile
+	{
+		std::string name;
+		std::string path;
+		std::vector<unsigned char> data;
+	};
+
+	std::vector<unsigned char> readFile(const std::string& path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		if (!file)
+			throw std::runtime_error("can't open " + path);
+		return std::vector<unsigned char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+
+	void writeBytes(std::ostream& out, const std::string& arrayName, const unsigned char* data, size_t size)
+	{
+		out << "\tconst unsigned char " << arrayName << "[] = {";
+		for (size_t i = 0; i < size; ++i)
+		{
+			if (i % 24 == 0)
+				out << "\n\t\t";
+			out << int(data[i]) << ",";
+		}
+		// An empty array isn't valid C++
+		if (size == 0)
+			out << "0";
+		out << "\n\t};\n";
+	}
+
+	// Rasterizes the ASCII glyphs of the font, then writes the font, the glyph table and the pixels
+	void writeFont(std::ostream& out, FONScontext* stash, const FontFile& font, int index)
+	{
+		const int fontId = fonsAddFontMem(stash, font.name.c_str(), const_cast<unsigned char*>(font.data.data()), int(font.data.size()), 0);
+		if (fontId == FONS_INVALID)
+			throw std::runtime_error("can't load " + font.path);
+
+		fonsSetFont(stash, fontId);
+		fonsSetSize(stash, float(FONS_SDF_SIZE));
+		for (unsigned int codepoint = firstCodepoint; codepoint <= lastCodepoint; ++codepoint)
+		{
+			const char text[2] = { char(codepoint), 0 };
+			fonsTextBounds(stash, 0.f, 0.f, text, nullptr, nullptr);
+		}
+
+		const FONSfont* fontData = stash->fonts[fontId];
+		std::vector<unsigned char> pixels;
+		std::ostringstream glyphs;
+		int nbGlyphs = 0;
+		for (int i = 0; i < fontData->nglyphs; ++i)
+		{
+			const FONSglyph& glyph = fontData->glyphs[i];
+			// Missing glyphs are left to the fallback fonts of the game
+			if (glyph.index == 0)
+				continue;
+
+			const int width = glyph.x1 - glyph.x0;
+			const int height = glyph.y1 - glyph.y0;
+			glyphs << "\t\t{ " << glyph.codepoint << ", " << glyph.size << ", " << width << ", " << height << ", "
+				<< glyph.xadv << ", " << glyph.xoff << ", " << glyph.yoff << ", " << pixels.size() << " },\n";
+
+			for (int y = glyph.y0; y < glyph.y1; ++y)
+			{
+				const unsigned char* row = stash->texData + glyph.x0 + y * atlasSize;
+				pixels.insert(pixels.end(), row, row + width);
+			}
+			nbGlyphs++;
+		}
+
+		const std::string prefix = "font" + std::to_string(index);
+		writeBytes(out, prefix + "Data", font.data.data(), font.data.size());
+		writeBytes(out, prefix + "Pixels", pixels.data(), pixels.size());
+		out << "\tconst EmbeddedGlyph " << prefix << "Glyphs[] = {\n" << glyphs.str();
+		if (nbGlyphs == 0)
+			out << "\t\t{ 0, 0, 0, 0, 0, 0, 0, 0 },\n";
+		out << "\t};\n"
+			<< "\tconstexpr unsigned int " << prefix << "NbGlyphs = " << nbGlyphs << ";\n\n";
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		std::cerr << "Usage: gogame_fontbake output.cpp name=file.ttf [name=file.ttf ...]\n";
+		return 1;
+	}
+
+	try
+	{
+		std::vector<FontFile> fonts;
+		for (int i = 2; i < argc; ++i)
+		{
+			std::string arg = argv[i];
+			auto separator = arg.find('=');
+			if (separator == std::string::npos)
+				throw std::runtime_error("expected name=file.ttf, got " + arg);
+
+			FontFile font;
+			font.name = arg.substr(0, separator);
+			font.path = arg.substr(separator + 1);
+			font.data = readFile(font.path);
+			fonts.push_back(std::move(font));
+		}
+
+		FONSparams params;
+		std::memset(&params, 0, sizeof(params));
+		params.width = atlasSize;
+		params.height = atlasSize;
+		params.flags = FONS_ZERO_TOPLEFT | FONS_SDF;
+		FONScontext* stash = fonsCreateInternal(&params);
+		if (!stash)
+			throw std::runtime_error("can't create the font stash");
+
+		std::ostringstream out;
+		out << "// Generated by gogame_fontbake, do not edit\n\n"
+			<< "#include \"EmbeddedFonts.h\"\n\n"
+			<< "namespace fonts\n{\nnamespace\n{\n";
+		for (size_t i = 0; i < fonts.size(); ++i)
+			writeFont(out, stash, fonts[i], int(i));
+		out << "}\n\n"
+			<< "\tconst EmbeddedFont embeddedFonts[] = {\n";
+		for (size_t i = 0; i < fonts.size(); ++i)
+		{
+			const std::string prefix = "font" + std::to_string(i);
+			out << "\t\t{ \"" << fonts[i].name << "\", " << prefix << "Data, " << fonts[i].data.size() << ", "
+				<< prefix << "Glyphs, " << prefix << "NbGlyphs, " << prefix << "Pixels },\n";
+		}
+		out << "\t};\n"
+			<< "\tconst unsigned int nbEmbeddedFonts = " << fonts.size() << ";\n"
+			<< "}\n";
+
+		fonsDeleteInternal(stash);
+
+		// Always written, even when the content is the same : the build compares its date with the baker and the fonts,
+		// an older file would run the step again on every build
+		std::ofstream output(argv[1], std::ios::binary);
+		if (!output)
+			throw std::runtime_error(std::string("can't write ") + argv[1]);
+		output << out.str();
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << "gogame_fontbake: " << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,304 @@
+// Load generator for gogame_server : simulates N concurrent games played with random moves over C connections,
+// then reports the accepted moves by second and the latency of the moves.
+// Each connection keeps up to --pipeline commands in flight, at most one by game, and sends the next one as soon as an
+// answer comes back. A move is timed from the write of its command to the read of its answer : with a deeper pipeline,
+// it includes the time spent behind the commands sent before it
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "logic/Random.h"
+
+namespace
+{
+	using Clock = std::chrono::steady_clock;
+
+	struct Options
+	{
+		std::string host = "127.0.0.1";
+		int port = 7777;
+		std::string unixPath;
+		int nbGames = 1000;
+		int nbConnections = 8;
+		int boardSize = 9;
+		double duration = 10.;
+		// Commands in flight by connection
+		int pipeline = 1;
+		// Each connection plays its own stream of moves, derived from it
+		unsigned long long seed = 0;
+	};
+
+	struct SimulatedGame
+	{
+		unsigned long long id = 0;
+		bool isCreated = false;
+		bool isWaiting = false;
+		int nbMoves = 0;
+	};
+
+	struct SentCommand
+	{
+		size_t gameIndex;
+		Clock::time_point sendTime;
+		bool isMove;
+	};
+
+	struct ConnectionResult
+	{
+		unsigned long long nbMoves = 0;
+		unsigned long long nbRefusedMoves = 0;
+		unsigned long long nbGamesPlayed = 0;
+		std::vector<float> latencies;
+	};
+
+	Options parseOptions(int argc, char** argv)
+	{
+		Options options;
+		for (int i = 1; i < argc; ++i)
+		{
+			std::string arg = argv[i];
+			if (arg == "--host" && i + 1 < argc)
+				options.host = argv[++i];
+			else if (arg == "--port" && i + 1 < argc)
+				options.port = std::stoi(argv[++i]);
+			else if (arg == "--unix" && i + 1 < argc)
+				options.unixPath = argv[++i];
+			else if (arg == "--games" && i + 1 < argc)
+				options.nbGames = std::max(1, std::stoi(argv[++i]));
+			else if (arg == "--connections" && i + 1 < argc)
+				options.nbConnections = std::max(1, std::stoi(argv[++i]));
+			else if (arg == "--size" && i + 1 < argc)
+				options.boardSize = std::stoi(argv[++i]);
+			else if (arg == "--duration" && i + 1 < argc)
+				options.duration = std::stod(argv[++i]);
+			else if (arg == "--pipeline" && i + 1 < argc)
+				options.pipeline = std::max(1, std::stoi(argv[++i]));
+			else if (arg == "--seed" && i + 1 < argc)
+				options.seed = std::stoull(argv[++i]);
+			else
+				throw std::runtime_error("Unknown option " + arg);
+		}
+		options.nbConnections = std::min(options.nbConnections, options.nbGames);
+		return options;
+	}
+
+	int connectToServer(const Options& options)
+	{
+		int fd = -1;
+		if (!options.unixPath.empty())
+		{
+			fd = socket(AF_UNIX, SOCK_STREAM, 0);
+			sockaddr_un address{};
+			address.sun_family = AF_UNIX;
+			std::strncpy(address.sun_path, options.unixPath.c_str(), sizeof(address.sun_path) - 1);
+			if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+				throw std::runtime_error(std::string("connect failed : ") + std::strerror(errno));
+		}
+		else
+		{
+			fd = socket(AF_INET, SOCK_STREAM, 0);
+			sockaddr_in address{};
+			address.sin_family = AF_INET;
+			address.sin_port = htons(static_cast<uint16_t>(options.port));
+			inet_pton(AF_INET, options.host.c_str(), &address.sin_addr);
+			if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+				throw std::runtime_error(std::string("connect failed : ") + std::strerror(errno));
+
+			int enable = 1;
+			setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+		}
+		return fd;
+	}
+
+	void sendAll(int fd, const std::string& data)
+	{
+		size_t offset = 0;
+		while (offset < data.size())
+		{
+			ssize_t nbWritten = send(fd, data.data() + offset, data.size() - offset, MSG_NOSIGNAL);
+			if (nbWritten <= 0)
+				throw std::runtime_error("Connection lost");
+			offset += nbWritten;
+		}
+	}
+
+	void runConnection(const Options& options, int connectionIndex, int nbGames, ConnectionResult& result)
+	{
+		const int fd = connectToServer(options);
+		// A game is closed after that many accepted moves, then a new one starts
+		const int maxMovesByGame = options.boardSize * options.boardSize;
+		const auto deadline = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.duration));
+
+		logic::CounterRandom random{ logic::CounterRandom::streamKey(options.seed, static_cast<unsigned long long>(connectionIndex)) };
+		auto coordinate = [&] { return random.nextBelow(static_cast<unsigned long long>(options.boardSize)); };
+		std::vector<SimulatedGame> games(nbGames);
+
+		// Answers come back in the order of the commands, one line each
+		std::deque<SentCommand> sentCommands;
+		size_t nextGame = 0;
+		std::string command;
+		std::string answers;
+		char buffer[65536];
+
+		while (true)
+		{
+			// The games take turns, a game waiting for its answer is skipped
+			const bool isRunning = Clock::now() < deadline;
+			for (size_t nbTried = 0; isRunning && sentCommands.size() < size_t(options.pipeline) && nbTried < games.size(); ++nbTried)
+			{
+				const size_t gameIndex = nextGame;
+				nextGame = (nextGame + 1) % games.size();
+				SimulatedGame& game = games[gameIndex];
+				if (game.isWaiting)
+					continue;
+
+				const bool isMove = game.isCreated && game.nbMoves < maxMovesByGame;
+				if (!game.isCreated)
+					command = "NEW " + std::to_string(options.boardSize) + '\n';
+				else if (!isMove)
+					command = "CLOSE " + std::to_string(game.id) + '\n';
+				else
+					command = "PLAY " + std::to_string(game.id) + ' ' + std::to_string(coordinate()) + ' ' + std::to_string(coordinate()) + '\n';
+
+				sentCommands.push_back({ gameIndex, Clock::now(), isMove });
+				sendAll(fd, command);
+				game.isWaiting = true;
+			}
+			if (sentCommands.empty())
+				break;
+
+			ssize_t nbRead = recv(fd, buffer, sizeof(buffer), 0);
+			if (nbRead <= 0)
+				throw std::runtime_error("Connection lost");
+			const auto receiveTime = Clock::now();
+			answers.append(buffer, nbRead);
+
+			size_t lineStart = 0;
+			size_t lineEnd;
+			while ((lineEnd = answers.find('\n', lineStart)) != std::string::npos)
+			{
+				if (sentCommands.empty())
+					throw std::runtime_error("Unexpected answer : " + answers.substr(lineStart, lineEnd - lineStart));
+				const std::string answer = answers.substr(lineStart, lineEnd - lineStart);
+				lineStart = lineEnd + 1;
+
+				const SentCommand sent = sentCommands.front();
+				sentCommands.pop_front();
+				SimulatedGame& game = games[sent.gameIndex];
+				game.isWaiting = false;
+
+				if (!game.isCreated)
+				{
+					if (answer.compare(0, 3, "OK ") != 0)
+						throw std::runtime_error("Can't create a game : " + answer);
+					game.id = std::stoull(answer.substr(3));
+					game.isCreated = true;
+					game.nbMoves = 0;
+					continue;
+				}
+				if (!sent.isMove)
+				{
+					game.isCreated = false;
+					result.nbGamesPlayed++;
+					continue;
+				}
+
+				// Only the moves are measured, creating and closing the games is the overhead of the simulation
+				result.latencies.push_back(std::chrono::duration<float, std::micro>(receiveTime - sent.sendTime).count());
+				game.nbMoves++;
+				if (answer.compare(0, 2, "OK") == 0)
+					result.nbMoves++;
+				else
+				{
+					// Random moves are often refused (occupied, suicide, superko), we count them as played
+					// so a crowded game still ends
+					result.nbRefusedMoves++;
+				}
+			}
+			answers.erase(0, lineStart);
+		}
+
+		close(fd);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Options options;
+	try
+	{
+		options = parseOptions(argc, argv);
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		std::cerr << "Usage: gogame_loadgen [--host h --port p | --unix path] [--games n] [--connections c] [--size s] [--duration seconds] [--pipeline n] [--seed n]" << std::endl;
+		return 1;
+	}
+
+	std::vector<ConnectionResult> results(options.nbConnections);
+	std::vector<std::thread> threads;
+	std::atomic<bool> hasFailed{ false };
+
+	const auto start = Clock::now();
+	for (int i = 0; i < options.nbConnections; ++i)
+	{
+		// Spread the games as evenly as possible over the connections
+		int nbGames = options.nbGames / options.nbConnections + (i < options.nbGames % options.nbConnections ? 1 : 0);
+		threads.emplace_back([&, i, nbGames] {
+			try
+			{
+				runConnection(options, i, nbGames, results[i]);
+			}
+			catch (const std::exception& e)
+			{
+				std::cerr << "Connection " << i << ": " << e.what() << std::endl;
+				hasFailed = true;
+			}
+		});
+	}
+
+	for (auto& thread : threads)
+		thread.join();
+	const double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+	ConnectionResult total;
+	for (auto& result : results)
+	{
+		total.nbMoves += result.nbMoves;
+		total.nbRefusedMoves += result.nbRefusedMoves;
+		total.nbGamesPlayed += result.nbGamesPlayed;
+		total.latencies.insert(total.latencies.end(), result.latencies.begin(), result.latencies.end());
+	}
+
+	if (total.latencies.empty())
+		return 1;
+
+	std::sort(total.latencies.begin(), total.latencies.end());
+	auto percentile = [&](double p) { return total.latencies[static_cast<size_t>(p * (total.latencies.size() - 1))]; };
+
+	std::cout << options.nbGames << " concurrent games over " << options.nbConnections << " connections, " << elapsed << " s\n"
+		<< "  accepted moves : " << total.nbMoves << " (" << total.nbMoves / elapsed << " moves/s)\n"
+		<< "  refused moves  : " << total.nbRefusedMoves << "\n"
+		<< "  games played   : " << total.nbGamesPlayed << "\n"
+		<< "  in flight      : " << options.pipeline << " commands by connection\n"
+		<< "  latency (us)   : p50 " << percentile(.5) << ", p99 " << percentile(.99) << ", max " << total.latencies.back() << std::endl;
+
+	return hasFailed ? 1 : 0;
+}
@@ -0,0 +1,80 @@
+#include "GameTable.h"
+#include <new>
+
+namespace server
+{
+	GameTable::GameTable(size_t capacity) :
+		_slots(capacity),
+		_nbGames{ 0 }
+	{
+		// Lowest indices first, it keeps the games that are played packed at the beginning of the table
+		_freeSlots.reserve(capacity);
+		for (size_t i = capacity; i > 0; --i)
+			_freeSlots.push_back(static_cast<std::uint32_t>(i - 1));
+	}
+
+	GameTable::~GameTable()
+	{
+		for (auto& slot : _slots)
+		{
+			if (slot.isConstructed)
+				slot.game().~GameState();
+		}
+	}
+
+	bool GameTable::create(int sizeX, int sizeY, GameID& id)
+	{
+		if (_freeSlots.empty())
+			return false;
+
+		std::uint32_t index = _freeSlots.back();
+		_freeSlots.pop_back();
+		Slot& slot = _slots[index];
+
+		if (slot.isConstructed && slot.game().getBoardDimensionX() == sizeX && slot.game().getBoardDimensionY() == sizeY)
+		{
+			slot.game().reset();
+		}
+		else
+		{
+			if (slot.isConstructed)
+				slot.game().~GameState();
+			new (&slot.storage) logic::GameState(sizeX, sizeY);
+			slot.isConstructed = true;
+		}
+
+		slot.isInUse = true;
+		_nbGames++;
+		id = (static_cast<GameID>(slot.generation) << 32) | index;
+		return true;
+	}
+
+	logic::GameState* GameTable::find(GameID id)
+	{
+		std::uint64_t index = id & 0xFFFFFFFFu;
+		std::uint32_t generation = static_cast<std::uint32_t>(id >> 32);
+
+		if (index >= _slots.size())
+			return nullptr;
+
+		Slot& slot = _slots[index];
+		if (!slot.isInUse || slot.generation != generation)
+			return nullptr;
+
+		return &slot.game();
+	}
+
+	bool GameTable::release(GameID id)
+	{
+		if (find(id) == nullptr)
+			return false;
+
+		std::uint32_t index = static_cast<std::uint32_t>(id & 0xFFFFFFFFu);
+		Slot& slot = _slots[index];
+		slot.isInUse = false;
+		slot.generation++;
+		_freeSlots.push_back(index);
+		_nbGames--;
+		return true;
+	}
+}
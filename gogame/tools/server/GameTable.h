@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "logic/GameState.h"
+
+namespace server
+{
+	// Identifies a game : the slot index in the low 32 bits, the generation of the slot in the high ones.
+	// The generation changes each time a slot is released, so a client using the ID of a closed game is refused
+	// instead of silently playing in somebody else's game
+	using GameID = std::uint64_t;
+
+	// Fixed capacity table of games allocated once at startup. Slots are recycled through a free list, and a slot
+	// keeps its GameState constructed once released : if the next game has the same board size, it's only reset
+	class GameTable
+	{
+		struct Slot
+		{
+			std::aligned_storage<sizeof(logic::GameState), alignof(logic::GameState)>::type storage;
+			std::uint32_t generation = 0;
+			bool isConstructed = false;
+			bool isInUse = false;
+
+			logic::GameState& game() { return *reinterpret_cast<logic::GameState*>(&storage); }
+		};
+
+		std::vector<Slot> _slots;
+		std::vector<std::uint32_t> _freeSlots;
+		size_t _nbGames;
+
+	public:
+		explicit GameTable(size_t capacity);
+		~GameTable();
+		GameTable(const GameTable&) = delete;
+		GameTable& operator=(const GameTable&) = delete;
+
+		// Returns false if the table is full
+		bool create(int sizeX, int sizeY, GameID& id);
+		// Returns nullptr if there's no game with that ID
+		logic::GameState* find(GameID id);
+		bool release(GameID id);
+
+		size_t getNbGames() const { return _nbGames; }
+		size_t getCapacity() const { return _slots.size(); }
+	};
+}
@@ -0,0 +1,136 @@
+#include "Protocol.h"
+#include <sstream>
+
+namespace server
+{
+	namespace
+	{
+		constexpr int minBoardSize = 2;
+		constexpr int maxBoardSize = 25;
+
+		const char* playerName(logic::Player player)
+		{
+			return (player == logic::Player::BLACK) ? "B" : "W";
+		}
+
+		void appendError(std::string& output, const std::string& reason)
+		{
+			output += "ERR ";
+			output += reason;
+			output += '\n';
+		}
+
+		logic::GameState* findGame(std::istringstream& arguments, GameTable& games, GameID& id, std::string& output)
+		{
+			if (!(arguments >> id))
+			{
+				appendError(output, "Missing game id");
+				return nullptr;
+			}
+
+			logic::GameState* game = games.find(id);
+			if (game == nullptr)
+				appendError(output, "Unknown game " + std::to_string(id));
+			return game;
+		}
+	}
+
+	bool handleCommand(const std::string& line, GameTable& games, ServerStatistics& stats, std::string& output)
+	{
+		stats.nbCommands++;
+
+		std::istringstream arguments(line);
+		std::string command;
+		arguments >> command;
+
+		GameID id = 0;
+
+		if (command == "NEW")
+		{
+			int sizeX = 0;
+			int sizeY = 0;
+			if (!(arguments >> sizeX))
+				sizeX = 9;
+			if (!(arguments >> sizeY))
+				sizeY = sizeX;
+
+			if (sizeX < minBoardSize || sizeY < minBoardSize || sizeX > maxBoardSize || sizeY > maxBoardSize)
+				appendError(output, "Invalid board size");
+			else if (!games.create(sizeX, sizeY, id))
+				appendError(output, "Server full");
+			else
+				output += "OK " + std::to_string(id) + '\n';
+		}
+		else if (command == "PLAY")
+		{
+			logic::GameState* game = findGame(arguments, games, id, output);
+			int x = 0;
+			int y = 0;
+			if (game == nullptr)
+				return true;
+			if (!(arguments >> x >> y))
+				appendError(output, "Missing coordinates");
+			else if (!game->putStoneAtPosition({ x, y }))
+				appendError(output, game->getMessage());
+			else
+			{
+				stats.nbMoves++;
+				output += "OK ";
+				output += playerName(game->getCurrentPlayer());
+				output += '\n';
+			}
+		}
+		else if (command == "PASS")
+		{
+			logic::GameState* game = findGame(arguments, games, id, output);
+			if (game == nullptr)
+				return true;
+
+			game->pass();
+			if (game->isGameOver())
+				output += "OVER " + std::to_string(game->getScoreBlack()) + ' ' + std::to_string(game->getScoreWhite()) + '\n';
+			else
+			{
+				output += "OK ";
+				output += playerName(game->getCurrentPlayer());
+				output += '\n';
+			}
+		}
+		else if (command == "BOARD")
+		{
+			logic::GameState* game = findGame(arguments, games, id, output);
+			if (game == nullptr)
+				return true;
+
+			output += "OK ";
+			output += playerName(game->getCurrentPlayer());
+			output += ' ';
+			for (auto stone : game->getBoard().getStoneBoard())
+				output += (stone == logic::Stone::BLACK) ? 'X' : (stone == logic::Stone::WHITE) ? 'O' : '.';
+			output += '\n';
+		}
+		else if (command == "CLOSE")
+		{
+			if (!(arguments >> id))
+				appendError(output, "Missing game id");
+			else if (!games.release(id))
+				appendError(output, "Unknown game " + std::to_string(id));
+			else
+				output += "OK\n";
+		}
+		else if (command == "STATS")
+		{
+			output += "OK " + std::to_string(games.getNbGames()) + ' ' + std::to_string(stats.nbMoves) + '\n';
+		}
+		else if (command == "QUIT")
+		{
+			return false;
+		}
+		else
+		{
+			appendError(output, "Unknown command " + command);
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <string>
+#include "GameTable.h"
+
+namespace server
+{
+	// Line protocol, one command by line, one answer line by command, in order:
+	//   NEW <size> | NEW <sizeX> <sizeY>  -> OK <id>
+	//   PLAY <id> <x> <y>                 -> OK <B|W> (player to move next) | ERR <reason>
+	//   PASS <id>                         -> OK <B|W> | OVER <black score> <white score>
+	//   BOARD <id>                        -> OK <B|W> <one char by intersection, row by row : '.', 'X' black, 'O' white>
+	//   CLOSE <id>                        -> OK
+	//   STATS                             -> OK <games in progress> <accepted moves>
+	//   QUIT                              -> closes the connection
+	// A line longer than 1024 characters gets ERR line too long, then the connection is closed.
+	// Games aren't tied to a connection (two players can share a game from two connections), they stay until CLOSE
+	struct ServerStatistics
+	{
+		unsigned long long nbMoves = 0;
+		unsigned long long nbCommands = 0;
+	};
+
+	// Executes one command (without its end of line) and appends the answer to output.
+	// Returns false if the connection must be closed
+	bool handleCommand(const std::string& line, GameTable& games, ServerStatistics& stats, std::string& output);
+}
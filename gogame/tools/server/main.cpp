@@ -0,0 +1,367 @@
+// Hosts many independent games in one process. One thread, one epoll loop : a move only costs a few microseconds
+// of logic, so the loop is never the bottleneck and we don't need any lock around the game table.
+// See Protocol.h for the commands
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "logic/Random.h"
+#include "GameTable.h"
+#include "Protocol.h"
+
+namespace
+{
+	struct Options
+	{
+		std::string host = "127.0.0.1";
+		int port = 7777;
+		std::string unixPath;
+		size_t capacity = 16384;
+		// Seed of the Zobrist keys, so the hashes of two runs are the same
+		unsigned long long seed = 0;
+	};
+
+	// A command is a few words : a longer line is a client error, the connection is closed
+	constexpr size_t maxLineLength = 1024;
+	// Answers the client doesn't read. Past this size, its commands aren't read anymore until it catches up : a
+	// connection never holds more than a read buffer of commands and about this size of answers
+	constexpr size_t maxPendingOutput = 1 << 20;
+
+	struct Connection
+	{
+		int fd;
+		std::string input;
+		std::string output;
+		bool mustClose = false;
+		// epoll events asked for this connection
+		unsigned int watchedEvents = EPOLLIN;
+	};
+
+	volatile std::sig_atomic_t stopRequested = 0;
+
+	void onSignal(int)
+	{
+		stopRequested = 1;
+	}
+
+	void setNonBlocking(int fd)
+	{
+		int flags = fcntl(fd, F_GETFL, 0);
+		if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)
+			throw std::runtime_error(std::string("fcntl failed : ") + std::strerror(errno));
+	}
+
+	int createListeningSocket(const Options& options)
+	{
+		int fd = -1;
+		if (!options.unixPath.empty())
+		{
+			fd = socket(AF_UNIX, SOCK_STREAM, 0);
+			if (fd < 0)
+				throw std::runtime_error(std::string("socket failed : ") + std::strerror(errno));
+
+			sockaddr_un address{};
+			address.sun_family = AF_UNIX;
+			if (options.unixPath.size() >= sizeof(address.sun_path))
+				throw std::runtime_error("Unix socket path too long");
+			std::strcpy(address.sun_path, options.unixPath.c_str());
+			unlink(options.unixPath.c_str());
+
+			if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+				throw std::runtime_error(std::string("bind failed : ") + std::strerror(errno));
+		}
+		else
+		{
+			fd = socket(AF_INET, SOCK_STREAM, 0);
+			if (fd < 0)
+				throw std::runtime_error(std::string("socket failed : ") + std::strerror(errno));
+
+			int enable = 1;
+			setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+			sockaddr_in address{};
+			address.sin_family = AF_INET;
+			address.sin_port = htons(static_cast<uint16_t>(options.port));
+			if (inet_pton(AF_INET, options.host.c_str(), &address.sin_addr) != 1)
+				throw std::runtime_error("Invalid address " + options.host);
+
+			if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0)
+				throw std::runtime_error(std::string("bind failed : ") + std::strerror(errno));
+		}
+
+		if (listen(fd, SOMAXCONN) < 0)
+			throw std::runtime_error(std::string("listen failed : ") + std::strerror(errno));
+
+		setNonBlocking(fd);
+		return fd;
+	}
+
+	Options parseOptions(int argc, char** argv)
+	{
+		Options options;
+		for (int i = 1; i < argc; ++i)
+		{
+			std::string arg = argv[i];
+			if (arg == "--host" && i + 1 < argc)
+				options.host = argv[++i];
+			else if (arg == "--port" && i + 1 < argc)
+				options.port = std::stoi(argv[++i]);
+			else if (arg == "--unix" && i + 1 < argc)
+				options.unixPath = argv[++i];
+			else if (arg == "--capacity" && i + 1 < argc)
+				options.capacity = std::stoul(argv[++i]);
+			else if (arg == "--seed" && i + 1 < argc)
+				options.seed = std::stoull(argv[++i]);
+			else
+				throw std::runtime_error("Unknown option " + arg);
+		}
+		return options;
+	}
+
+	class Server
+	{
+		int _epollFd;
+		int _listenFd;
+		server::GameTable _games;
+		server::ServerStatistics _stats;
+		std::unordered_map<int, std::unique_ptr<Connection>> _connections;
+
+	public:
+		Server(const Options& options) :
+			_epollFd{ epoll_create1(0) },
+			_listenFd{ createListeningSocket(options) },
+			_games{ options.capacity }
+		{
+			if (_epollFd < 0)
+				throw std::runtime_error(std::string("epoll_create1 failed : ") + std::strerror(errno));
+
+			epoll_event event{};
+			event.events = EPOLLIN;
+			event.data.fd = _listenFd;
+			epoll_ctl(_epollFd, EPOLL_CTL_ADD, _listenFd, &event);
+		}
+
+		~Server()
+		{
+			for (auto& connection : _connections)
+				close(connection.first);
+			close(_listenFd);
+			close(_epollFd);
+		}
+
+		void run()
+		{
+			std::vector<epoll_event> events(256);
+			while (!stopRequested)
+			{
+				int nbEvents = epoll_wait(_epollFd, events.data(), static_cast<int>(events.size()), 500);
+				if (nbEvents < 0)
+				{
+					if (errno == EINTR)
+						continue;
+					throw std::runtime_error(std::string("epoll_wait failed : ") + std::strerror(errno));
+				}
+
+				for (int i = 0; i < nbEvents; ++i)
+				{
+					int fd = events[i].data.fd;
+					if (fd == _listenFd)
+					{
+						acceptConnections();
+						continue;
+					}
+
+					auto it = _connections.find(fd);
+					if (it == _connections.end())
+						continue;
+
+					Connection& connection = *it->second;
+					if (events[i].events & (EPOLLHUP | EPOLLERR))
+						connection.mustClose = true;
+					if (events[i].events & EPOLLIN)
+						readConnection(connection);
+					writeConnection(connection);
+
+					if (connection.mustClose && connection.output.empty())
+						closeConnection(fd);
+				}
+			}
+
+			std::cout << _stats.nbCommands << " commands, " << _stats.nbMoves << " moves, "
+				<< _games.getNbGames() << " games in progress" << std::endl;
+		}
+
+	private:
+		void acceptConnections()
+		{
+			while (true)
+			{
+				int fd = accept(_listenFd, nullptr, nullptr);
+				if (fd < 0)
+					return;
+
+				setNonBlocking(fd);
+				int enable = 1;
+				setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+				epoll_event event{};
+				event.events = EPOLLIN;
+				event.data.fd = fd;
+				epoll_ctl(_epollFd, EPOLL_CTL_ADD, fd, &event);
+
+				std::unique_ptr<Connection> connection(new Connection());
+				connection->fd = fd;
+				_connections[fd] = std::move(connection);
+			}
+		}
+
+		void readConnection(Connection& connection)
+		{
+			char buffer[16384];
+			while (!connection.mustClose && connection.output.size() < maxPendingOutput)
+			{
+				ssize_t nbRead = recv(connection.fd, buffer, sizeof(buffer), 0);
+				if (nbRead > 0)
+				{
+					connection.input.append(buffer, nbRead);
+					handleLines(connection);
+					continue;
+				}
+				if (nbRead == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+					connection.mustClose = true;
+				break;
+			}
+		}
+
+		// Every complete line is a command. Clients may pipeline several of them, the answers keep the same order.
+		// The lines left once the output is full are handled when it's sent
+		void handleLines(Connection& connection)
+		{
+			size_t lineStart = 0;
+			size_t lineEnd;
+			while (connection.output.size() < maxPendingOutput && (lineEnd = connection.input.find('\n', lineStart)) != std::string::npos)
+			{
+				size_t length = lineEnd - lineStart;
+				if (length > 0 && connection.input[lineEnd - 1] == '\r')
+					length--;
+
+				std::string line = connection.input.substr(lineStart, length);
+				lineStart = lineEnd + 1;
+				if (length > maxLineLength || !server::handleCommand(line, _games, _stats, connection.output))
+				{
+					if (length > maxLineLength)
+						connection.output += "ERR line too long\n";
+					connection.mustClose = true;
+					lineStart = connection.input.size();
+					break;
+				}
+			}
+			connection.input.erase(0, lineStart);
+
+			// A line without its end can't grow forever either
+			const auto firstLineEnd = connection.input.find('\n');
+			if (!connection.mustClose && connection.input.size() > maxLineLength && (firstLineEnd == std::string::npos || firstLineEnd > maxLineLength))
+			{
+				connection.output += "ERR line too long\n";
+				connection.input.clear();
+				connection.mustClose = true;
+			}
+		}
+
+		void writeConnection(Connection& connection)
+		{
+			sendOutput(connection);
+			// The output has room again, the commands read before it was full come next
+			if (!connection.mustClose && connection.output.size() < maxPendingOutput && !connection.input.empty())
+			{
+				handleLines(connection);
+				sendOutput(connection);
+			}
+
+			// Only ask for EPOLLOUT while something is waiting, otherwise we would be woken up all the time. And not
+			// for EPOLLIN while the answers pile up, the commands stay in the socket
+			unsigned int events = 0;
+			if (!connection.mustClose && connection.output.size() < maxPendingOutput)
+				events |= EPOLLIN;
+			if (!connection.output.empty())
+				events |= EPOLLOUT;
+			if (events != connection.watchedEvents)
+			{
+				epoll_event event{};
+				event.events = events;
+				event.data.fd = connection.fd;
+				epoll_ctl(_epollFd, EPOLL_CTL_MOD, connection.fd, &event);
+				connection.watchedEvents = events;
+			}
+		}
+
+		void sendOutput(Connection& connection)
+		{
+			while (!connection.output.empty())
+			{
+				ssize_t nbWritten = send(connection.fd, connection.output.data(), connection.output.size(), MSG_NOSIGNAL);
+				if (nbWritten > 0)
+				{
+					connection.output.erase(0, nbWritten);
+					continue;
+				}
+				if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+				{
+					connection.output.clear();
+					connection.mustClose = true;
+				}
+				break;
+			}
+		}
+
+		void closeConnection(int fd)
+		{
+			epoll_ctl(_epollFd, EPOLL_CTL_DEL, fd, nullptr);
+			close(fd);
+			_connections.erase(fd);
+		}
+	};
+}
+
+int main(int argc, char** argv)
+{
+	try
+	{
+		Options options = parseOptions(argc, argv);
+		logic::setRandomSeed(options.seed);
+
+		std::signal(SIGINT, onSignal);
+		std::signal(SIGTERM, onSignal);
+
+		Server server(options);
+		if (options.unixPath.empty())
+			std::cout << "Listening on " << options.host << ":" << options.port << std::endl;
+		else
+			std::cout << "Listening on " << options.unixPath << std::endl;
+
+		server.run();
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
@@ -24,6 +24,9 @@
 enum FONSflags {
 	FONS_ZERO_TOPLEFT = 1,
 	FONS_ZERO_BOTTOMLEFT = 2,
+	// Glyphs are baked once at FONS_SDF_SIZE as signed distance fields, and scaled to the requested size.
+	// The atlas then holds distances (128 on the outline) instead of coverage, and blur is ignored.
+	FONS_SDF = 4,
 };
 
 enum FONSalign {
@@ -88,6 +91,9 @@ FONScontext* fonsCreateInternal(FONSparams* params);
 void fonsDeleteInternal(FONScontext* s);
 
 void fonsSetErrorCallback(FONScontext* s, void (*callback)(void* uptr, int error, int val), void* uptr);
+// Called when a code point is found neither in a font nor in its fallbacks, before giving up on it. The callback can
+// add a fallback font, the glyph is searched again in the fallbacks afterwards.
+void fonsSetMissingGlyphCallback(FONScontext* s, void (*callback)(void* uptr, int font, unsigned int codepoint), void* uptr);
 // Returns current atlas size.
 void fonsGetAtlasSize(FONScontext* s, int* width, int* height);
 // Expands the atlas size.
@@ -99,6 +105,10 @@ int fonsResetAtlas(FONScontext* stash, int width, int height);
 int fonsAddFont(FONScontext* s, const char* name, const char* path);
 int fonsAddFontMem(FONScontext* s, const char* name, unsigned char* data, int ndata, int freeData);
 int fonsGetFontByName(FONScontext* s, const char* name);
+// Adds a glyph rasterized ahead of time (same layout as fons__getGlyph, border and padding included) to the atlas.
+// The glyph is then found by the text functions as if it had been rasterized by the stash. Returns 0 on failure.
+int fonsAddBakedGlyph(FONScontext* s, int font, unsigned int codepoint, short isize, short iblur,
+					  int width, int height, short xadv, short xoff, short yoff, const unsigned char* pixels);
 
 // State handling
 void fonsPushState(FONScontext* s);
@@ -326,6 +336,12 @@ int fons__tt_getGlyphKernAdvance(FONSttFontImpl *font, int glyph1, int glyph2)
 #ifndef FONS_MAX_STATES
 #	define FONS_MAX_STATES 20
 #endif
+#ifndef FONS_SDF_SIZE
+#	define FONS_SDF_SIZE 32
+#endif
+#ifndef FONS_SDF_PAD
+#	define FONS_SDF_PAD 6
+#endif
 #ifndef FONS_MAX_FALLBACKS
 #	define FONS_MAX_FALLBACKS 20
 #endif
@@ -426,6 +442,8 @@ struct FONScontext
 	int nstates;
 	void (*handleError)(void* uptr, int error, int val);
 	void* errorUptr;
+	void (*handleMissingGlyph)(void* uptr, int font, unsigned int codepoint);
+	void* missingGlyphUptr;
 };
 
 #ifdef STB_TRUETYPE_IMPLEMENTATION
@@ -1028,6 +1046,43 @@ static void fons__blur(FONScontext* stash, unsigned char* dst, int w, int h, int
 //	fons__blurcols(dst, w, h, dstStride, alpha);
 }
 
+// Replaces the coverage of a glyph by its signed distance to the outline, in pixels, scaled so that 'pad' pixels
+// map to 127. Brute force in a (2*pad+1)^2 window : it only runs once per glyph in SDF mode.
+static void fons__sdf(FONScontext* stash, unsigned char* dst, int w, int h, int dstStride, int pad)
+{
+	int x, y, dx, dy;
+	unsigned char* inside = (unsigned char*)fons__tmpalloc(w*h, stash);
+	if (inside == NULL) return;
+
+	for (y = 0; y < h; y++)
+		for (x = 0; x < w; x++)
+			inside[x + y*w] = dst[x + y*dstStride] >= 128;
+
+	for (y = 0; y < h; y++) {
+		for (x = 0; x < w; x++) {
+			int in = inside[x + y*w];
+			float best = (float)(pad*pad + 1);
+			float dist, value;
+			for (dy = -pad; dy <= pad; dy++) {
+				int sy = y + dy;
+				if (sy < 0 || sy >= h) continue;
+				for (dx = -pad; dx <= pad; dx++) {
+					int sx = x + dx;
+					float d2;
+					if (sx < 0 || sx >= w || inside[sx + sy*w] == in) continue;
+					d2 = (float)(dx*dx + dy*dy);
+					if (d2 < best) best = d2;
+				}
+			}
+			// The outline lies between the two pixel centers
+			dist = sqrtf(best) - 0.5f;
+			if (dist > (float)pad) dist = (float)pad;
+			value = 128.0f + (in ? dist : -dist) * 127.0f / (float)pad;
+			dst[x + y*dstStride] = (unsigned char)(value < 0.0f ? 0.0f : (value > 255.0f ? 255.0f : value));
+		}
+	}
+}
+
 static FONSglyph* fons__getGlyph(FONScontext* stash, FONSfont* font, unsigned int codepoint,
 								 short isize, short iblur)
 {
@@ -1045,6 +1100,14 @@ static FONSglyph* fons__getGlyph(FONScontext* stash, FONSfont* font, unsigned in
 	if (iblur > 20) iblur = 20;
 	pad = iblur+2;
 
+	// In SDF mode, all the sizes share the glyph baked at the reference size
+	if (stash->params.flags & FONS_SDF) {
+		isize = FONS_SDF_SIZE*10;
+		size = isize/10.0f;
+		iblur = 0;
+		pad = FONS_SDF_PAD;
+	}
+
 	// Reset allocator.
 	stash->nscratch = 0;
 
@@ -1070,6 +1133,22 @@ static FONSglyph* fons__getGlyph(FONScontext* stash, FONSfont* font, unsigned in
 				break;
 			}
 		}
+		// Give the user a chance to load a fallback font, then look again.
+		if (g == 0 && stash->handleMissingGlyph != NULL) {
+			int fontId;
+			for (fontId = 0; fontId < stash->nfonts; ++fontId)
+				if (stash->fonts[fontId] == font) break;
+			stash->handleMissingGlyph(stash->missingGlyphUptr, fontId, codepoint);
+			for (i = 0; i < font->nfallbacks; ++i) {
+				FONSfont* fallbackFont = stash->fonts[font->fallbacks[i]];
+				int fallbackIndex = fons__tt_getGlyphIndex(&fallbackFont->font, codepoint);
+				if (fallbackIndex != 0) {
+					g = fallbackIndex;
+					renderFont = fallbackFont;
+					break;
+				}
+			}
+		}
 		// It is possible that we did not find a fallback glyph.
 		// In that case the glyph index 'g' is 0, and we'll proceed below and cache empty glyph.
 	}
@@ -1131,6 +1210,12 @@ static FONSglyph* fons__getGlyph(FONScontext* stash, FONSfont* font, unsigned in
 		}
 	}*/
 
+	if (stash->params.flags & FONS_SDF) {
+		stash->nscratch = 0;
+		bdst = &stash->texData[glyph->x0 + glyph->y0 * stash->params.width];
+		fons__sdf(stash, bdst, gw, gh, stash->params.width, pad);
+	}
+
 	// Blur
 	if (iblur > 0) {
 		stash->nscratch = 0;
@@ -1147,10 +1232,12 @@ static FONSglyph* fons__getGlyph(FONScontext* stash, FONSfont* font, unsigned in
 }
 
 static void fons__getQuad(FONScontext* stash, FONSfont* font,
-						   int prevGlyphIndex, FONSglyph* glyph,
+						   int prevGlyphIndex, FONSglyph* glyph, short isize,
 						   float scale, float spacing, float* x, float* y, FONSquad* q)
 {
 	float rx,ry,xoff,yoff,x0,y0,x1,y1;
+	// Ratio between the requested size and the size the glyph was baked at : 1 unless in SDF mode
+	float gscale = (float)isize / (float)glyph->size;
 
 	if (prevGlyphIndex != -1) {
 		float adv = fons__tt_getGlyphKernAdvance(&font->font, prevGlyphIndex, glyph->index) * scale;
@@ -1160,8 +1247,8 @@ static void fons__getQuad(FONScontext* stash, FONSfont* font,
 	// Each glyph has 2px border to allow good interpolation,
 	// one pixel to prevent leaking, and one to allow good interpolation for rendering.
 	// Inset the texture region by one pixel for correct interpolation.
-	xoff = (short)(glyph->xoff+1);
-	yoff = (short)(glyph->yoff+1);
+	xoff = (short)(glyph->xoff+1) * gscale;
+	yoff = (short)(glyph->yoff+1) * gscale;
 	x0 = (float)(glyph->x0+1);
 	y0 = (float)(glyph->y0+1);
 	x1 = (float)(glyph->x1-1);
@@ -1173,8 +1260,8 @@ static void fons__getQuad(FONScontext* stash, FONSfont* font,
 
 		q->x0 = rx;
 		q->y0 = ry;
-		q->x1 = rx + x1 - x0;
-		q->y1 = ry + y1 - y0;
+		q->x1 = rx + (x1 - x0) * gscale;
+		q->y1 = ry + (y1 - y0) * gscale;
 
 		q->s0 = x0 * stash->itw;
 		q->t0 = y0 * stash->ith;
@@ -1186,8 +1273,8 @@ static void fons__getQuad(FONScontext* stash, FONSfont* font,
 
 		q->x0 = rx;
 		q->y0 = ry;
-		q->x1 = rx + x1 - x0;
-		q->y1 = ry - y1 + y0;
+		q->x1 = rx + (x1 - x0) * gscale;
+		q->y1 = ry - (y1 - y0) * gscale;
 
 		q->s0 = x0 * stash->itw;
 		q->t0 = y0 * stash->ith;
@@ -1195,7 +1282,7 @@ static void fons__getQuad(FONScontext* stash, FONSfont* font,
 		q->t1 = y1 * stash->ith;
 	}
 
-	*x += (int)(glyph->xadv / 10.0f + 0.5f);
+	*x += (int)(glyph->xadv * gscale / 10.0f + 0.5f);
 }
 
 static void fons__flush(FONScontext* stash)
@@ -1299,7 +1386,7 @@ float fonsDrawText(FONScontext* stash,
 			continue;
 		glyph = fons__getGlyph(stash, font, codepoint, isize, iblur);
 		if (glyph != NULL) {
-			fons__getQuad(stash, font, prevGlyphIndex, glyph, scale, state->spacing, &x, &y, &q);
+			fons__getQuad(stash, font, prevGlyphIndex, glyph, isize, scale, state->spacing, &x, &y, &q);
 
 			if (stash->nverts+6 > FONS_VERTEX_COUNT)
 				fons__flush(stash);
@@ -1382,7 +1469,7 @@ int fonsTextIterNext(FONScontext* stash, FONStextIter* iter, FONSquad* quad)
 		iter->y = iter->nexty;
 		glyph = fons__getGlyph(stash, iter->font, iter->codepoint, iter->isize, iter->iblur);
 		if (glyph != NULL)
-			fons__getQuad(stash, iter->font, iter->prevGlyphIndex, glyph, iter->scale, iter->spacing, &iter->nextx, &iter->nexty, quad);
+			fons__getQuad(stash, iter->font, iter->prevGlyphIndex, glyph, iter->isize, iter->scale, iter->spacing, &iter->nextx, &iter->nexty, quad);
 		iter->prevGlyphIndex = glyph != NULL ? glyph->index : -1;
 		break;
 	}
@@ -1479,7 +1566,7 @@ float fonsTextBounds(FONScontext* stash,
 			continue;
 		glyph = fons__getGlyph(stash, font, codepoint, isize, iblur);
 		if (glyph != NULL) {
-			fons__getQuad(stash, font, prevGlyphIndex, glyph, scale, state->spacing, &x, &y, &q);
+			fons__getQuad(stash, font, prevGlyphIndex, glyph, isize, scale, state->spacing, &x, &y, &q);
 			if (q.x0 < minx) minx = q.x0;
 			if (q.x1 > maxx) maxx = q.x1;
 			if (stash->params.flags & FONS_ZERO_TOPLEFT) {
@@ -1611,6 +1698,60 @@ void fonsSetErrorCallback(FONScontext* stash, void (*callback)(void* uptr, int e
 	stash->errorUptr = uptr;
 }
 
+void fonsSetMissingGlyphCallback(FONScontext* stash, void (*callback)(void* uptr, int font, unsigned int codepoint), void* uptr)
+{
+	if (stash == NULL) return;
+	stash->handleMissingGlyph = callback;
+	stash->missingGlyphUptr = uptr;
+}
+
+int fonsAddBakedGlyph(FONScontext* stash, int fontId, unsigned int codepoint, short isize, short iblur,
+					  int width, int height, short xadv, short xoff, short yoff, const unsigned char* pixels)
+{
+	FONSfont* font;
+	FONSglyph* glyph;
+	unsigned int h;
+	int gx, gy, added, y;
+
+	if (stash == NULL || fontId < 0 || fontId >= stash->nfonts) return 0;
+	font = stash->fonts[fontId];
+
+	added = fons__atlasAddRect(stash->atlas, width, height, &gx, &gy);
+	if (added == 0 && stash->handleError != NULL) {
+		stash->handleError(stash->errorUptr, FONS_ATLAS_FULL, 0);
+		added = fons__atlasAddRect(stash->atlas, width, height, &gx, &gy);
+	}
+	if (added == 0) return 0;
+
+	glyph = fons__allocGlyph(font);
+	if (glyph == NULL) return 0;
+	glyph->codepoint = codepoint;
+	glyph->size = isize;
+	glyph->blur = iblur;
+	glyph->index = fons__tt_getGlyphIndex(&font->font, codepoint);
+	glyph->x0 = (short)gx;
+	glyph->y0 = (short)gy;
+	glyph->x1 = (short)(gx+width);
+	glyph->y1 = (short)(gy+height);
+	glyph->xadv = xadv;
+	glyph->xoff = xoff;
+	glyph->yoff = yoff;
+
+	h = fons__hashint(codepoint) & (FONS_HASH_LUT_SIZE-1);
+	glyph->next = font->lut[h];
+	font->lut[h] = font->nglyphs-1;
+
+	for (y = 0; y < height; y++)
+		memcpy(&stash->texData[gx + (gy+y) * stash->params.width], &pixels[y*width], width);
+
+	stash->dirtyRect[0] = fons__mini(stash->dirtyRect[0], glyph->x0);
+	stash->dirtyRect[1] = fons__mini(stash->dirtyRect[1], glyph->y0);
+	stash->dirtyRect[2] = fons__maxi(stash->dirtyRect[2], glyph->x1);
+	stash->dirtyRect[3] = fons__maxi(stash->dirtyRect[3], glyph->y1);
+
+	return 1;
+}
+
 void fonsGetAtlasSize(FONScontext* stash, int* width, int* height)
 {
 	if (stash == NULL) return;
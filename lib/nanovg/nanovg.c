@@ -315,6 +315,8 @@ NVGcontext* nvgCreateInternal(NVGparams* params)
 	fontParams.width = NVG_INIT_FONTIMAGE_SIZE;
 	fontParams.height = NVG_INIT_FONTIMAGE_SIZE;
 	fontParams.flags = FONS_ZERO_TOPLEFT;
+	if (ctx->params.sdfText)
+		fontParams.flags |= FONS_SDF;
 	fontParams.renderCreate = NULL;
 	fontParams.renderUpdate = NULL;
 	fontParams.renderDraw = NULL;
@@ -324,7 +326,7 @@ NVGcontext* nvgCreateInternal(NVGparams* params)
 	if (ctx->fs == NULL) goto error;
 
 	// Create font texture
-	ctx->fontImages[0] = ctx->params.renderCreateTexture(ctx->params.userPtr, NVG_TEXTURE_ALPHA, fontParams.width, fontParams.height, 0, NULL);
+	ctx->fontImages[0] = ctx->params.renderCreateTexture(ctx->params.userPtr, NVG_TEXTURE_ALPHA, fontParams.width, fontParams.height, ctx->params.sdfText ? NVG_IMAGE_SDF : 0, NULL);
 	if (ctx->fontImages[0] == 0) goto error;
 	ctx->fontImageIdx = 0;
 
@@ -2272,6 +2274,166 @@ void nvgStroke(NVGcontext* ctx)
 	}
 }
 
+// Cached paths
+struct NVGcachedPath {
+	NVGpath* paths;
+	int npaths;
+	NVGvertex* verts;
+	int nverts;
+	float bounds[4];
+	// What the vertices depend on, besides the translation
+	float xform[4];
+	float tessTol;
+	float fringe;
+};
+
+static float nvg__cachedPathFringe(NVGcontext* ctx)
+{
+	NVGstate* state = nvg__getState(ctx);
+	return ctx->params.edgeAntiAlias && state->shapeAntiAlias ? ctx->fringeWidth : 0.0f;
+}
+
+NVGcachedPath* nvgCacheFill(NVGcontext* ctx, float ox, float oy)
+{
+	NVGstate* state = nvg__getState(ctx);
+	NVGpathCache* cache = ctx->cache;
+	NVGcachedPath* cached = NULL;
+	float fringe = nvg__cachedPathFringe(ctx);
+	float sx, sy;
+	int i, nverts = 0;
+
+	nvg__flattenPaths(ctx);
+	if (nvg__expandFill(ctx, fringe, NVG_MITER, 2.4f) == 0) return NULL;
+
+	// The fill and the fringe of every path are packed at the start of the vertex cache.
+	for (i = 0; i < cache->npaths; i++) {
+		NVGpath* path = &cache->paths[i];
+		if (path->nfill > 0) nverts = nvg__maxi(nverts, (int)(path->fill - cache->verts) + path->nfill);
+		if (path->nstroke > 0) nverts = nvg__maxi(nverts, (int)(path->stroke - cache->verts) + path->nstroke);
+	}
+
+	cached = (NVGcachedPath*)malloc(sizeof(NVGcachedPath));
+	if (cached == NULL) goto error;
+	memset(cached, 0, sizeof(NVGcachedPath));
+	cached->paths = (NVGpath*)malloc(sizeof(NVGpath) * nvg__maxi(cache->npaths, 1));
+	if (cached->paths == NULL) goto error;
+	cached->verts = (NVGvertex*)malloc(sizeof(NVGvertex) * nvg__maxi(nverts, 1));
+	if (cached->verts == NULL) goto error;
+
+	// Vertices are in screen space, we move the origin to (0,0).
+	nvgTransformPoint(&sx, &sy, state->xform, ox, oy);
+	for (i = 0; i < nverts; i++) {
+		cached->verts[i] = cache->verts[i];
+		cached->verts[i].x -= sx;
+		cached->verts[i].y -= sy;
+	}
+	for (i = 0; i < cache->npaths; i++) {
+		NVGpath* src = &cache->paths[i];
+		NVGpath* dst = &cached->paths[i];
+		*dst = *src;
+		dst->fill = src->nfill > 0 ? cached->verts + (src->fill - cache->verts) : NULL;
+		dst->stroke = src->nstroke > 0 ? cached->verts + (src->stroke - cache->verts) : NULL;
+	}
+	cached->npaths = cache->npaths;
+	cached->nverts = nverts;
+	cached->bounds[0] = cache->bounds[0] - sx;
+	cached->bounds[1] = cache->bounds[1] - sy;
+	cached->bounds[2] = cache->bounds[2] - sx;
+	cached->bounds[3] = cache->bounds[3] - sy;
+	memcpy(cached->xform, state->xform, sizeof(float)*4);
+	cached->tessTol = ctx->tessTol;
+	cached->fringe = fringe;
+
+	return cached;
+
+error:
+	nvgDeleteCachedPath(cached);
+	return NULL;
+}
+
+int nvgCachedPathMatches(NVGcontext* ctx, const NVGcachedPath* path)
+{
+	NVGstate* state = nvg__getState(ctx);
+	if (path == NULL) return 0;
+	return memcmp(path->xform, state->xform, sizeof(float)*4) == 0
+		&& path->tessTol == ctx->tessTol
+		&& path->fringe == nvg__cachedPathFringe(ctx);
+}
+
+void nvgFillCachedPath(NVGcontext* ctx, const NVGcachedPath* path, const float* positions, int npositions)
+{
+	NVGstate* state = nvg__getState(ctx);
+	NVGpathCache* cache = ctx->cache;
+	NVGpaint fillPaint = state->fill;
+	NVGvertex* verts;
+	int i, j, npaths;
+
+	if (path == NULL || path->npaths == 0 || npositions <= 0) return;
+
+	// The copies go in the path cache, as if they had been flattened from the current path.
+	verts = nvg__allocTempVerts(ctx, path->nverts * npositions);
+	if (verts == NULL) return;
+	npaths = path->npaths * npositions;
+	if (npaths > cache->cpaths) {
+		NVGpath* paths = (NVGpath*)realloc(cache->paths, sizeof(NVGpath)*npaths);
+		if (paths == NULL) return;
+		cache->paths = paths;
+		cache->cpaths = npaths;
+	}
+
+	cache->bounds[0] = cache->bounds[1] = 1e6f;
+	cache->bounds[2] = cache->bounds[3] = -1e6f;
+	for (i = 0; i < npositions; i++) {
+		NVGvertex* dst = verts + i * path->nverts;
+		float sx, sy;
+		nvgTransformPoint(&sx, &sy, state->xform, positions[i*2], positions[i*2+1]);
+
+		for (j = 0; j < path->nverts; j++) {
+			dst[j] = path->verts[j];
+			dst[j].x += sx;
+			dst[j].y += sy;
+		}
+		for (j = 0; j < path->npaths; j++) {
+			const NVGpath* src = &path->paths[j];
+			NVGpath* copy = &cache->paths[i * path->npaths + j];
+			*copy = *src;
+			copy->fill = src->fill != NULL ? dst + (src->fill - path->verts) : NULL;
+			copy->stroke = src->stroke != NULL ? dst + (src->stroke - path->verts) : NULL;
+		}
+		cache->bounds[0] = nvg__minf(cache->bounds[0], path->bounds[0] + sx);
+		cache->bounds[1] = nvg__minf(cache->bounds[1], path->bounds[1] + sy);
+		cache->bounds[2] = nvg__maxf(cache->bounds[2], path->bounds[2] + sx);
+		cache->bounds[3] = nvg__maxf(cache->bounds[3], path->bounds[3] + sy);
+	}
+	cache->npaths = npaths;
+
+	// Apply global alpha
+	fillPaint.innerColor.a *= state->alpha;
+	fillPaint.outerColor.a *= state->alpha;
+
+	ctx->params.renderFill(ctx->params.userPtr, &fillPaint, state->compositeOperation, &state->scissor, ctx->fringeWidth,
+						   cache->bounds, cache->paths, cache->npaths);
+
+	// Count triangles
+	for (i = 0; i < cache->npaths; i++) {
+		const NVGpath* copy = &cache->paths[i];
+		ctx->fillTriCount += copy->nfill-2;
+		ctx->fillTriCount += copy->nstroke-2;
+		ctx->drawCallCount += 2;
+	}
+
+	// The copies replaced the flattened current path, it will be flattened again if needed.
+	nvg__clearPathCache(ctx);
+}
+
+void nvgDeleteCachedPath(NVGcachedPath* path)
+{
+	if (path == NULL) return;
+	free(path->paths);
+	free(path->verts);
+	free(path);
+}
+
 // Add fonts
 int nvgCreateFont(NVGcontext* ctx, const char* name, const char* path)
 {
@@ -2301,6 +2463,17 @@ int nvgAddFallbackFont(NVGcontext* ctx, const char* baseFont, const char* fallba
 	return nvgAddFallbackFontId(ctx, nvgFindFont(ctx, baseFont), nvgFindFont(ctx, fallbackFont));
 }
 
+void nvgSetMissingGlyphCallback(NVGcontext* ctx, void (*callback)(void* uptr, int font, unsigned int codepoint), void* uptr)
+{
+	fonsSetMissingGlyphCallback(ctx->fs, callback, uptr);
+}
+
+int nvgAddBakedGlyph(NVGcontext* ctx, int font, unsigned int codepoint, int size10, int width, int height,
+					 int xadv10, int xoff, int yoff, const unsigned char* pixels)
+{
+	return fonsAddBakedGlyph(ctx->fs, font, codepoint, (short)size10, 0, width, height, (short)xadv10, (short)xoff, (short)yoff, pixels);
+}
+
 // State setting
 void nvgFontSize(NVGcontext* ctx, float size)
 {
@@ -2390,7 +2563,7 @@ static int nvg__allocTextAtlas(NVGcontext* ctx)
 			iw *= 2;
 		if (iw > NVG_MAX_FONTIMAGE_SIZE || ih > NVG_MAX_FONTIMAGE_SIZE)
 			iw = ih = NVG_MAX_FONTIMAGE_SIZE;
-		ctx->fontImages[ctx->fontImageIdx+1] = ctx->params.renderCreateTexture(ctx->params.userPtr, NVG_TEXTURE_ALPHA, iw, ih, 0, NULL);
+		ctx->fontImages[ctx->fontImageIdx+1] = ctx->params.renderCreateTexture(ctx->params.userPtr, NVG_TEXTURE_ALPHA, iw, ih, ctx->params.sdfText ? NVG_IMAGE_SDF : 0, NULL);
 	}
 	++ctx->fontImageIdx;
 	fonsResetAtlas(ctx->fs, iw, ih);
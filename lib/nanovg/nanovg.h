@@ -142,6 +142,7 @@ enum NVGimageFlags {
 	NVG_IMAGE_FLIPY				= 1<<3,		// Flips (inverses) image in Y direction when rendered.
 	NVG_IMAGE_PREMULTIPLIED		= 1<<4,		// Image data has premultiplied alpha.
 	NVG_IMAGE_NEAREST			= 1<<5,		// Image interpolation is Nearest instead Linear
+	NVG_IMAGE_SDF				= 1<<6,		// Alpha image holding a signed distance field (edge at 0.5) instead of coverage.
 };
 
 // Begin drawing a new frame
@@ -508,6 +509,31 @@ void nvgFill(NVGcontext* ctx);
 // Fills the current path with current stroke style.
 void nvgStroke(NVGcontext* ctx);
 
+//
+// Cached paths
+//
+// A cached path keeps the vertices generated for the fill of a path, so a shape drawn many times
+// (stones, markers...) is only flattened and expanded once. The vertices are stored relative to an
+// origin, and replaying them only adds a translation. They depend on the scale, rotation and skew of
+// the transform, and on the device pixel ratio : nvgCachedPathMatches() tells if they can be replayed.
+
+typedef struct NVGcachedPath NVGcachedPath;
+
+// Flattens and expands the current path like nvgFill() would, without drawing it.
+// (ox,oy) is the origin of the cached path in the current coordinates. Returns NULL on failure.
+NVGcachedPath* nvgCacheFill(NVGcontext* ctx, float ox, float oy);
+
+// Returns 1 if the cached path was generated with the current transform (translation excepted) and pixel ratio.
+int nvgCachedPathMatches(NVGcontext* ctx, const NVGcachedPath* path);
+
+// Fills copies of the cached path with the current fill style, in a single fill. 'positions' holds
+// 'npositions' (x,y) pairs, the origins of the copies in the current coordinates.
+// The current path is left untouched.
+void nvgFillCachedPath(NVGcontext* ctx, const NVGcachedPath* path, const float* positions, int npositions);
+
+// Deletes a cached path.
+void nvgDeleteCachedPath(NVGcachedPath* path);
+
 
 //
 // Text
@@ -559,6 +585,14 @@ int nvgAddFallbackFontId(NVGcontext* ctx, int baseFont, int fallbackFont);
 // Adds a fallback font by name.
 int nvgAddFallbackFont(NVGcontext* ctx, const char* baseFont, const char* fallbackFont);
 
+// Sets a function called the first time a code point can't be found in a font and its fallbacks.
+// It can create a font and add it as a fallback, the glyph is then searched again.
+void nvgSetMissingGlyphCallback(NVGcontext* ctx, void (*callback)(void* uptr, int font, unsigned int codepoint), void* uptr);
+
+// Adds a glyph rasterized at build time to the font atlas (see fonsAddBakedGlyph). Returns 0 on failure.
+int nvgAddBakedGlyph(NVGcontext* ctx, int font, unsigned int codepoint, int size10, int width, int height,
+					 int xadv10, int xoff, int yoff, const unsigned char* pixels);
+
 // Sets the font size of current text style.
 void nvgFontSize(NVGcontext* ctx, float size);
 
@@ -648,6 +682,7 @@ typedef struct NVGpath NVGpath;
 struct NVGparams {
 	void* userPtr;
 	int edgeAntiAlias;
+	int sdfText;	// Glyphs are baked once as distance fields, and scaled to every font size
 	int (*renderCreate)(void* uptr);
 	int (*renderCreateTexture)(void* uptr, int type, int w, int h, int imageFlags, const unsigned char* data);
 	int (*renderDeleteTexture)(void* uptr, int image);
@@ -32,8 +32,24 @@ enum NVGcreateFlags {
 	NVG_STENCIL_STROKES	= 1<<1,
 	// Flag indicating that additional debug checks are done.
 	NVG_DEBUG 			= 1<<2,
+	// Flag indicating that text is drawn from signed distance fields : each glyph is rasterized once, whatever
+	// the font size. Font blur is ignored.
+	NVG_SDF_TEXT		= 1<<3,
+	// Flag indicating that vertices and uniforms are always uploaded by orphaning the buffers, even when
+	// persistent mapped buffers (GL 4.4 or ARB_buffer_storage) are available.
+	NVG_NO_PERSISTENT_BUFFERS	= 1<<4,
 };
 
+// Counters of the vertex and uniform uploads, summed since the creation of the context.
+struct NVGuploadStatsGL {
+	int persistent;		// 1 if the uploads go through the persistent mapped ring buffer
+	int nflushes;		// Number of flushes which uploaded something
+	int nstalls;		// Number of flushes which had to wait for the GPU before writing in the ring
+	int nreallocs;		// Number of times the buffers grew
+	double bytes;		// Bytes uploaded
+};
+typedef struct NVGuploadStatsGL NVGuploadStatsGL;
+
 #if defined NANOVG_GL2_IMPLEMENTATION
 #  define NANOVG_GL2 1
 #  define NANOVG_GL_IMPLEMENTATION 1
@@ -51,6 +67,10 @@ enum NVGcreateFlags {
 
 #define NANOVG_GL_USE_STATE_FILTER (1)
 
+// Number of segments of the persistent mapped ring buffer : the CPU writes a flush while the GPU may still read
+// the two previous ones
+#define NANOVG_GL_STREAM_SEGMENTS 3
+
 // Creates NanoVG contexts for different OpenGL (ES) versions.
 // Flags should be combination of the create flags above.
 
@@ -61,6 +81,7 @@ void nvgDeleteGL2(NVGcontext* ctx);
 
 int nvglCreateImageFromHandleGL2(NVGcontext* ctx, GLuint textureId, int w, int h, int flags);
 GLuint nvglImageHandleGL2(NVGcontext* ctx, int image);
+void nvglUploadStatsGL2(NVGcontext* ctx, NVGuploadStatsGL* stats);
 
 #endif
 
@@ -71,6 +92,7 @@ void nvgDeleteGL3(NVGcontext* ctx);
 
 int nvglCreateImageFromHandleGL3(NVGcontext* ctx, GLuint textureId, int w, int h, int flags);
 GLuint nvglImageHandleGL3(NVGcontext* ctx, int image);
+void nvglUploadStatsGL3(NVGcontext* ctx, NVGuploadStatsGL* stats);
 
 #endif
 
@@ -81,6 +103,7 @@ void nvgDeleteGLES2(NVGcontext* ctx);
 
 int nvglCreateImageFromHandleGLES2(NVGcontext* ctx, GLuint textureId, int w, int h, int flags);
 GLuint nvglImageHandleGLES2(NVGcontext* ctx, int image);
+void nvglUploadStatsGLES2(NVGcontext* ctx, NVGuploadStatsGL* stats);
 
 #endif
 
@@ -91,6 +114,7 @@ void nvgDeleteGLES3(NVGcontext* ctx);
 
 int nvglCreateImageFromHandleGLES3(NVGcontext* ctx, GLuint textureId, int w, int h, int flags);
 GLuint nvglImageHandleGLES3(NVGcontext* ctx, int image);
+void nvglUploadStatsGLES3(NVGcontext* ctx, NVGuploadStatsGL* stats);
 
 #endif
 
@@ -113,6 +137,12 @@ enum NVGimageFlagsGL {
 #include <math.h>
 #include "nanovg.h"
 
+#if defined NANOVG_GL3 && defined GL_MAP_PERSISTENT_BIT
+#  define NANOVG_GL_USE_BUFFER_STORAGE 1
+#else
+#  define NANOVG_GL_USE_BUFFER_STORAGE 0
+#endif
+
 enum GLNVGuniformLoc {
 	GLNVG_LOC_VIEWSIZE,
 	GLNVG_LOC_TEX,
@@ -243,8 +273,29 @@ struct GLNVGcontext {
 	GLuint fragBuf;
 #endif
 	int fragSize;
+	int fragAlign;
 	int flags;
 
+	// Streaming of the vertices and uniforms. The fallback orphans vertBuf and fragBuf at each flush, the
+	// persistent path writes both in one segment of streamBuf, which stays mapped
+	int vertBufSize;
+	int fragBufSize;
+#if NANOVG_GL_USE_BUFFER_STORAGE
+	int persistent;
+	GLuint streamBuf;
+	unsigned char* streamPtr;
+	int streamSegmentSize;
+	int streamSegment;
+	GLsync streamFences[NANOVG_GL_STREAM_SEGMENTS];
+#endif
+	// Buffers and offsets of the data uploaded for the current flush
+	GLuint uploadVertBuf;
+	GLuint uploadFragBuf;
+	GLintptr vertOffset;
+	GLintptr fragOffset;
+	GLintptr boundFragOffset;
+	NVGuploadStatsGL stats;
+
 	// Per frame buffers
 	GLNVGcall* calls;
 	int ccalls;
@@ -273,6 +324,8 @@ typedef struct GLNVGcontext GLNVGcontext;
 
 static int glnvg__maxi(int a, int b) { return a > b ? a : b; }
 
+static int glnvg__alignUp(int n, int align) { return (n + align - 1) / align * align; }
+
 #ifdef NANOVG_GLES2
 static unsigned int glnvg__nearestPow2(unsigned int num)
 {
@@ -500,6 +553,26 @@ static void glnvg__getUniforms(GLNVGshader* shader)
 #endif
 }
 
+#if NANOVG_GL_USE_BUFFER_STORAGE
+static int glnvg__hasBufferStorage()
+{
+	GLint major = 0, minor = 0, next = 0, i;
+#ifdef __glew_h__
+	if (glBufferStorage == NULL) return 0;
+#endif
+	glGetIntegerv(GL_MAJOR_VERSION, &major);
+	glGetIntegerv(GL_MINOR_VERSION, &minor);
+	if (major > 4 || (major == 4 && minor >= 4)) return 1;
+
+	glGetIntegerv(GL_NUM_EXTENSIONS, &next);
+	for (i = 0; i < next; i++) {
+		const char* ext = (const char*)glGetStringi(GL_EXTENSIONS, i);
+		if (ext != NULL && strcmp(ext, "GL_ARB_buffer_storage") == 0) return 1;
+	}
+	return 0;
+}
+#endif
+
 static int glnvg__renderCreate(void* uptr)
 {
 	GLNVGcontext* gl = (GLNVGcontext*)uptr;
@@ -608,6 +681,16 @@ static int glnvg__renderCreate(void* uptr)
 		"	return min(max(d.x,d.y),0.0) + length(max(d,0.0)) - rad;\n"
 		"}\n"
 		"\n"
+		"// Coverage of a distance field texel : the outline is at 0.5, antialiased over one screen pixel\n"
+		"float sdfAlpha(float d) {\n"
+		"#if defined(GL_ES) && !defined(NANOVG_GL3)\n"
+		"	return smoothstep(0.45, 0.55, d);\n"
+		"#else\n"
+		"	float w = max(fwidth(d), 1.0/255.0);\n"
+		"	return clamp((d - 0.5) / w + 0.5, 0.0, 1.0);\n"
+		"#endif\n"
+		"}\n"
+		"\n"
 		"// Scissoring\n"
 		"float scissorMask(vec2 p) {\n"
 		"	vec2 sc = (abs((scissorMat * vec3(p,1.0)).xy) - scissorExt);\n"
@@ -648,6 +731,7 @@ static int glnvg__renderCreate(void* uptr)
 		"#endif\n"
 		"		if (texType == 1) color = vec4(color.xyz*color.w,color.w);"
 		"		if (texType == 2) color = vec4(color.x);"
+		"		if (texType == 3) color = vec4(sdfAlpha(color.x));"
 		"		// Apply color tint and alpha.\n"
 		"		color *= innerCol;\n"
 		"		// Combine alpha\n"
@@ -663,6 +747,7 @@ static int glnvg__renderCreate(void* uptr)
 		"#endif\n"
 		"		if (texType == 1) color = vec4(color.xyz*color.w,color.w);"
 		"		if (texType == 2) color = vec4(color.x);"
+		"		if (texType == 3) color = vec4(sdfAlpha(color.x));"
 		"		color *= scissor;\n"
 		"		result = color * innerCol;\n"
 		"	}\n"
@@ -699,6 +784,12 @@ static int glnvg__renderCreate(void* uptr)
 	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &align);
 #endif
 	gl->fragSize = sizeof(GLNVGfragUniforms) + align - sizeof(GLNVGfragUniforms) % align;
+	gl->fragAlign = align;
+
+#if NANOVG_GL_USE_BUFFER_STORAGE
+	gl->persistent = (gl->flags & NVG_NO_PERSISTENT_BUFFERS) == 0 && glnvg__hasBufferStorage();
+	gl->stats.persistent = gl->persistent;
+#endif
 
 	glnvg__checkError(gl, "create done");
 
@@ -948,7 +1039,7 @@ static int glnvg__convertPaint(GLNVGcontext* gl, GLNVGfragUniforms* frag, NVGpai
 		if (tex->type == NVG_TEXTURE_RGBA)
 			frag->texType = (tex->flags & NVG_IMAGE_PREMULTIPLIED) ? 0 : 1;
 		else
-			frag->texType = 2;
+			frag->texType = (tex->flags & NVG_IMAGE_SDF) ? 3 : 2;
 //		printf("frag->texType = %d\n", frag->texType);
 	} else {
 		frag->type = NSVG_SHADER_FILLGRAD;
@@ -967,7 +1058,12 @@ static GLNVGfragUniforms* nvg__fragUniformPtr(GLNVGcontext* gl, int i);
 static void glnvg__setUniforms(GLNVGcontext* gl, int uniformOffset, int image)
 {
 #if NANOVG_GL_USE_UNIFORMBUFFER
-	glBindBufferRange(GL_UNIFORM_BUFFER, GLNVG_FRAG_BINDING, gl->fragBuf, uniformOffset, sizeof(GLNVGfragUniforms));
+	// All the uniforms of the flush are in one buffer, consecutive calls often use the same range
+	GLintptr offset = gl->fragOffset + uniformOffset;
+	if (offset != gl->boundFragOffset) {
+		glBindBufferRange(GL_UNIFORM_BUFFER, GLNVG_FRAG_BINDING, gl->uploadFragBuf, offset, sizeof(GLNVGfragUniforms));
+		gl->boundFragOffset = offset;
+	}
 #else
 	GLNVGfragUniforms* frag = nvg__fragUniformPtr(gl, uniformOffset);
 	glUniform4fv(gl->shader.loc[GLNVG_LOC_FRAG], NANOVG_GL_UNIFORMARRAY_SIZE, &(frag->uniformArray[0][0]));
@@ -1157,6 +1253,125 @@ static GLNVGblend glnvg__blendCompositeOperation(NVGcompositeOperationState op)
 	return blend;
 }
 
+#if NANOVG_GL_USE_BUFFER_STORAGE
+static void glnvg__deleteStream(GLNVGcontext* gl)
+{
+	int i;
+	for (i = 0; i < NANOVG_GL_STREAM_SEGMENTS; i++) {
+		if (gl->streamFences[i] != 0)
+			glDeleteSync(gl->streamFences[i]);
+		gl->streamFences[i] = 0;
+	}
+	if (gl->streamBuf != 0) {
+		glBindBuffer(GL_ARRAY_BUFFER, gl->streamBuf);
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glDeleteBuffers(1, &gl->streamBuf);
+	}
+	gl->streamBuf = 0;
+	gl->streamPtr = NULL;
+	gl->streamSegmentSize = 0;
+	gl->streamSegment = 0;
+}
+
+// Makes the segments at least 'size' bytes. The storage of a buffer can't change, a new one replaces it : the
+// GPU keeps the old one alive until the calls which read it are done.
+static int glnvg__allocStream(GLNVGcontext* gl, int size)
+{
+	const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	int segmentSize = glnvg__alignUp(glnvg__maxi(glnvg__maxi(size, 64*1024), gl->streamSegmentSize + gl->streamSegmentSize/2), gl->fragAlign);
+
+	glnvg__deleteStream(gl);
+
+	glGenBuffers(1, &gl->streamBuf);
+	glBindBuffer(GL_ARRAY_BUFFER, gl->streamBuf);
+	glBufferStorage(GL_ARRAY_BUFFER, (GLsizeiptr)segmentSize * NANOVG_GL_STREAM_SEGMENTS, NULL, flags);
+	gl->streamPtr = (unsigned char*)glMapBufferRange(GL_ARRAY_BUFFER, 0, (GLsizeiptr)segmentSize * NANOVG_GL_STREAM_SEGMENTS, flags);
+	if (gl->streamPtr == NULL) {
+		glnvg__deleteStream(gl);
+		return 0;
+	}
+	gl->streamSegmentSize = segmentSize;
+	gl->stats.nreallocs++;
+	return 1;
+}
+
+// Waits until the GPU has read the previous content of the current segment
+static void glnvg__waitStreamSegment(GLNVGcontext* gl)
+{
+	GLsync fence = gl->streamFences[gl->streamSegment];
+	GLenum status;
+	if (fence == 0) return;
+
+	status = glClientWaitSync(fence, 0, 0);
+	if (status == GL_TIMEOUT_EXPIRED) {
+		gl->stats.nstalls++;
+		do {
+			status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+		} while (status == GL_TIMEOUT_EXPIRED);
+	}
+	glDeleteSync(fence);
+	gl->streamFences[gl->streamSegment] = 0;
+}
+#endif
+
+// Copies the vertices and uniforms of the flush to the GPU, and sets the buffers and offsets the calls read from
+static void glnvg__upload(GLNVGcontext* gl)
+{
+	int vertBytes = gl->nverts * sizeof(NVGvertex);
+	int fragBytes = gl->nuniforms * gl->fragSize;
+
+	gl->stats.nflushes++;
+	gl->stats.bytes += vertBytes + fragBytes;
+	gl->boundFragOffset = -1;
+
+#if NANOVG_GL_USE_BUFFER_STORAGE
+	if (gl->persistent) {
+		// One segment holds the vertices, then the uniforms at the next aligned offset
+		int fragStart = glnvg__alignUp(vertBytes, gl->fragAlign);
+		if (fragStart + fragBytes > gl->streamSegmentSize && !glnvg__allocStream(gl, fragStart + fragBytes)) {
+			// Mapping failed, we stay on the fallback from now on
+			gl->persistent = 0;
+			gl->stats.persistent = 0;
+		} else {
+			GLintptr base = (GLintptr)gl->streamSegment * gl->streamSegmentSize;
+			glnvg__waitStreamSegment(gl);
+			memcpy(gl->streamPtr + base, gl->verts, vertBytes);
+			memcpy(gl->streamPtr + base + fragStart, gl->uniforms, fragBytes);
+			gl->uploadVertBuf = gl->streamBuf;
+			gl->uploadFragBuf = gl->streamBuf;
+			gl->vertOffset = base;
+			gl->fragOffset = base + fragStart;
+			return;
+		}
+	}
+#endif
+
+	// Orphaning : the driver gives new storage to the buffer if the GPU still reads the previous one, we never
+	// wait. The capacity only grows, so the driver can recycle the storage of the same size
+#if NANOVG_GL_USE_UNIFORMBUFFER
+	glBindBuffer(GL_UNIFORM_BUFFER, gl->fragBuf);
+	if (fragBytes > gl->fragBufSize) {
+		gl->fragBufSize = glnvg__maxi(fragBytes, gl->fragBufSize + gl->fragBufSize/2);
+		gl->stats.nreallocs++;
+	}
+	glBufferData(GL_UNIFORM_BUFFER, gl->fragBufSize, NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, fragBytes, gl->uniforms);
+	gl->uploadFragBuf = gl->fragBuf;
+#endif
+
+	glBindBuffer(GL_ARRAY_BUFFER, gl->vertBuf);
+	if (vertBytes > gl->vertBufSize) {
+		gl->vertBufSize = glnvg__maxi(vertBytes, gl->vertBufSize + gl->vertBufSize/2);
+		gl->stats.nreallocs++;
+	}
+	glBufferData(GL_ARRAY_BUFFER, gl->vertBufSize, NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, vertBytes, gl->verts);
+	gl->uploadVertBuf = gl->vertBuf;
+	gl->vertOffset = 0;
+	gl->fragOffset = 0;
+}
+
 static void glnvg__renderFlush(void* uptr)
 {
 	GLNVGcontext* gl = (GLNVGcontext*)uptr;
@@ -1191,29 +1406,23 @@ static void glnvg__renderFlush(void* uptr)
 		gl->blendFunc.dstAlpha = GL_INVALID_ENUM;
 		#endif
 
-#if NANOVG_GL_USE_UNIFORMBUFFER
-		// Upload ubo for frag shaders
-		glBindBuffer(GL_UNIFORM_BUFFER, gl->fragBuf);
-		glBufferData(GL_UNIFORM_BUFFER, gl->nuniforms * gl->fragSize, gl->uniforms, GL_STREAM_DRAW);
-#endif
-
-		// Upload vertex data
+		// Upload vertex data and ubo for frag shaders
 #if defined NANOVG_GL3
 		glBindVertexArray(gl->vertArr);
 #endif
-		glBindBuffer(GL_ARRAY_BUFFER, gl->vertBuf);
-		glBufferData(GL_ARRAY_BUFFER, gl->nverts * sizeof(NVGvertex), gl->verts, GL_STREAM_DRAW);
+		glnvg__upload(gl);
+		glBindBuffer(GL_ARRAY_BUFFER, gl->uploadVertBuf);
 		glEnableVertexAttribArray(0);
 		glEnableVertexAttribArray(1);
-		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(NVGvertex), (const GLvoid*)(size_t)0);
-		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(NVGvertex), (const GLvoid*)(0 + 2*sizeof(float)));
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(NVGvertex), (const GLvoid*)(size_t)gl->vertOffset);
+		glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(NVGvertex), (const GLvoid*)(size_t)(gl->vertOffset + 2*sizeof(float)));
 
 		// Set view and texture just once per frame.
 		glUniform1i(gl->shader.loc[GLNVG_LOC_TEX], 0);
 		glUniform2fv(gl->shader.loc[GLNVG_LOC_VIEWSIZE], 1, gl->view);
 
 #if NANOVG_GL_USE_UNIFORMBUFFER
-		glBindBuffer(GL_UNIFORM_BUFFER, gl->fragBuf);
+		glBindBuffer(GL_UNIFORM_BUFFER, gl->uploadFragBuf);
 #endif
 
 		for (i = 0; i < gl->ncalls; i++) {
@@ -1229,6 +1438,14 @@ static void glnvg__renderFlush(void* uptr)
 				glnvg__triangles(gl, call);
 		}
 
+#if NANOVG_GL_USE_BUFFER_STORAGE
+		// The segment can be written again once the GPU is done with these calls
+		if (gl->uploadVertBuf == gl->streamBuf) {
+			gl->streamFences[gl->streamSegment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			gl->streamSegment = (gl->streamSegment + 1) % NANOVG_GL_STREAM_SEGMENTS;
+		}
+#endif
+
 		glDisableVertexAttribArray(0);
 		glDisableVertexAttribArray(1);
 #if defined NANOVG_GL3
@@ -1515,6 +1732,10 @@ static void glnvg__renderDelete(void* uptr)
 
 	glnvg__deleteShader(&gl->shader);
 
+#if NANOVG_GL_USE_BUFFER_STORAGE
+	glnvg__deleteStream(gl);
+#endif
+
 #if NANOVG_GL3
 #if NANOVG_GL_USE_UNIFORMBUFFER
 	if (gl->fragBuf != 0)
@@ -1572,6 +1793,7 @@ NVGcontext* nvgCreateGLES3(int flags)
 	params.renderDelete = glnvg__renderDelete;
 	params.userPtr = gl;
 	params.edgeAntiAlias = flags & NVG_ANTIALIAS ? 1 : 0;
+	params.sdfText = flags & NVG_SDF_TEXT ? 1 : 0;
 
 	gl->flags = flags;
 
@@ -1638,4 +1860,18 @@ GLuint nvglImageHandleGLES3(NVGcontext* ctx, int image)
 	return tex->tex;
 }
 
+#if defined NANOVG_GL2
+void nvglUploadStatsGL2(NVGcontext* ctx, NVGuploadStatsGL* stats)
+#elif defined NANOVG_GL3
+void nvglUploadStatsGL3(NVGcontext* ctx, NVGuploadStatsGL* stats)
+#elif defined NANOVG_GLES2
+void nvglUploadStatsGLES2(NVGcontext* ctx, NVGuploadStatsGL* stats)
+#elif defined NANOVG_GLES3
+void nvglUploadStatsGLES3(NVGcontext* ctx, NVGuploadStatsGL* stats)
+#endif
+{
+	GLNVGcontext* gl = (GLNVGcontext*)nvgInternalParams(ctx)->userPtr;
+	*stats = gl->stats;
+}
+
 #endif /* NANOVG_GL_IMPLEMENTATION */